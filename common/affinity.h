@@ -0,0 +1,398 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+// Posicionamento de threads pela topologia da máquina e alocação local ao nó NUMA.
+//
+// A topologia vem de /sys/devices/system/cpu (núcleo, pacote, irmãs SMT e nó
+// NUMA de cada CPU lógica), restrita às CPUs que o processo pode usar
+// (sched_getaffinity, que já reflete cpusets/cgroups). Sobre ela há três
+// políticas de posicionamento:
+//
+//   compact   preenche um núcleo (todas as irmãs SMT) antes de passar ao
+//             próximo, e um pacote antes do próximo: threads próximas
+//             compartilham cache
+//   scatter   alterna entre pacotes e usa um núcleo diferente por thread antes
+//             de repetir qualquer núcleo: máxima banda de memória e de cache
+//   physical  só a primeira CPU lógica de cada núcleo (sem SMT), em ordem
+//
+// Com mais threads que CPUs na lista, a lista é reaproveitada circularmente.
+// A política "none" não fixa nada e preserva o comportamento antigo.
+//
+// Para a memória, affinity_alloc_local reserva páginas novas com política
+// MPOL_PREFERRED no nó pedido (mbind, sem depender da libnuma); as páginas só
+// são materializadas no primeiro toque, já no nó certo, seja qual for a thread
+// que as toque. Em máquinas de um nó só o mbind é pulado.
+//
+// Requer _GNU_SOURCE definido antes do primeiro include do arquivo que o usa.
+
+#ifndef _GNU_SOURCE
+#error "affinity.h requer _GNU_SOURCE definido antes de qualquer include"
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define AFFINITY_SYSFS_CPU "/sys/devices/system/cpu"
+#define AFFINITY_SYSFS_NODE "/sys/devices/system/node"
+
+// Política de preferência de nó do mbind (linux/mempolicy.h)
+#define AFFINITY_MPOL_PREFERRED 1
+
+typedef enum {
+    AFFINITY_NONE = 0,
+    AFFINITY_COMPACT,
+    AFFINITY_SCATTER,
+    AFFINITY_PHYSICAL
+} AffinityPolicy;
+
+// Uma CPU lógica
+typedef struct {
+    int cpu;
+    int core;               // core_id (único apenas dentro do pacote)
+    int package;            // physical_package_id
+    int node;               // Nó NUMA (0 se o kernel não expõe nós)
+    int smt;                // Posição da CPU entre as irmãs SMT do núcleo (0 = primeira)
+    int core_rank;          // Índice denso do núcleo dentro do pacote
+} AffinityCpu;
+
+typedef struct {
+    int num_cpus;           // CPUs lógicas utilizáveis pelo processo
+    int num_cores;          // Núcleos físicos entre elas
+    int num_packages;
+    int num_nodes;
+    AffinityCpu *cpus;
+} AffinityTopology;
+
+// Posicionamento de num_threads threads segundo uma política
+typedef struct {
+    AffinityPolicy policy;
+    int num_threads;
+    int *cpus;              // CPU da thread i (NULL com AFFINITY_NONE)
+    int *nodes;             // Nó NUMA da thread i (NULL com AFFINITY_NONE)
+} AffinityPlan;
+
+static inline const char *affinity_policy_name(AffinityPolicy policy) {
+    switch (policy) {
+    case AFFINITY_COMPACT:
+        return "compact";
+    case AFFINITY_SCATTER:
+        return "scatter";
+    case AFFINITY_PHYSICAL:
+        return "physical";
+    default:
+        return "none";
+    }
+}
+
+// Converte o nome da política. Retorna 0 ou -1 se o nome for desconhecido.
+static inline int affinity_parse_policy(const char *name, AffinityPolicy *policy) {
+    static const AffinityPolicy all[] = {AFFINITY_NONE, AFFINITY_COMPACT, AFFINITY_SCATTER, AFFINITY_PHYSICAL};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); ++i) {
+        if (strcmp(name, affinity_policy_name(all[i])) == 0) {
+            *policy = all[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Lê um inteiro de /sys/devices/system/cpu/cpu<cpu>/<file>; retorna fallback se não existir
+static inline int affinity_read_int(int cpu, const char *file, int fallback) {
+    char path[256];
+    snprintf(path, sizeof(path), AFFINITY_SYSFS_CPU "/cpu%d/%s", cpu, file);
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return fallback;
+    }
+    int value;
+    if (fscanf(f, "%d", &value) != 1) {
+        value = fallback;
+    }
+    fclose(f);
+    return value;
+}
+
+// Posição de cpu numa lista no formato do kernel ("0,64" ou "0-1"); 0 se ausente
+static inline int affinity_sibling_index(int cpu) {
+    char path[256], list[256];
+    snprintf(path, sizeof(path), AFFINITY_SYSFS_CPU "/cpu%d/topology/thread_siblings_list", cpu);
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    int ok = fgets(list, sizeof(list), f) != NULL;
+    fclose(f);
+    if (!ok) {
+        return 0;
+    }
+
+    int index = 0;
+    char *p = list;
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+        }
+        if (cpu >= lo && cpu <= hi) {
+            return index + (int)(cpu - lo);
+        }
+        index += (int)(hi - lo + 1);
+        p = *end == ',' ? end + 1 : end;
+        if (*p == '\n') {
+            break;
+        }
+    }
+    return 0;
+}
+
+// Nó NUMA da CPU: o diretório cpu<N>/node<M> existe quando o kernel tem NUMA
+static inline int affinity_cpu_node(int cpu) {
+    char path[256];
+    snprintf(path, sizeof(path), AFFINITY_SYSFS_CPU "/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return 0;
+    }
+    int node = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+// Conta valores distintos de um campo (as listas são pequenas; quadrático basta)
+static inline int affinity_count_distinct(const AffinityCpu *cpus, int n, int (*key)(const AffinityCpu *)) {
+    int distinct = 0;
+    for (int i = 0; i < n; ++i) {
+        int seen = 0;
+        for (int j = 0; j < i && !seen; ++j) {
+            seen = key(&cpus[j]) == key(&cpus[i]);
+        }
+        distinct += !seen;
+    }
+    return distinct;
+}
+
+static inline int affinity_key_package(const AffinityCpu *c) { return c->package; }
+static inline int affinity_key_node(const AffinityCpu *c) { return c->node; }
+static inline int affinity_key_core(const AffinityCpu *c) { return c->package * 65536 + c->core; }
+
+// Lê a topologia das CPUs utilizáveis. Sem /sys, cada CPU vira um núcleo do
+// pacote 0 no nó 0. Retorna 0 ou um código de erro (errno).
+static inline int affinity_read_topology(AffinityTopology *topo) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return errno;
+    }
+
+    int n = CPU_COUNT(&allowed);
+    topo->cpus = malloc((size_t)n * sizeof(AffinityCpu));
+    if (!topo->cpus) {
+        return ENOMEM;
+    }
+
+    int k = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && k < n; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        AffinityCpu *c = &topo->cpus[k++];
+        c->cpu = cpu;
+        c->core = affinity_read_int(cpu, "topology/core_id", cpu);
+        c->package = affinity_read_int(cpu, "topology/physical_package_id", 0);
+        c->node = affinity_cpu_node(cpu);
+        c->smt = affinity_sibling_index(cpu);
+    }
+    topo->num_cpus = k;
+
+    // Índice denso de cada núcleo dentro do pacote (core_id pode ter buracos)
+    for (int i = 0; i < k; ++i) {
+        int rank = 0;
+        for (int j = 0; j < k; ++j) {
+            if (topo->cpus[j].package == topo->cpus[i].package && topo->cpus[j].smt == 0
+                && topo->cpus[j].core < topo->cpus[i].core) {
+                rank++;
+            }
+        }
+        topo->cpus[i].core_rank = rank;
+    }
+
+    topo->num_cores = affinity_count_distinct(topo->cpus, k, affinity_key_core);
+    topo->num_packages = affinity_count_distinct(topo->cpus, k, affinity_key_package);
+    topo->num_nodes = affinity_count_distinct(topo->cpus, k, affinity_key_node);
+    return 0;
+}
+
+static inline void affinity_free_topology(AffinityTopology *topo) {
+    free(topo->cpus);
+    topo->cpus = NULL;
+}
+
+// Ordem de preenchimento de cada política
+static inline int affinity_cmp_compact(const void *a, const void *b) {
+    const AffinityCpu *x = a, *y = b;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->core_rank != y->core_rank) return x->core_rank - y->core_rank;
+    return x->smt - y->smt;
+}
+
+static inline int affinity_cmp_scatter(const void *a, const void *b) {
+    const AffinityCpu *x = a, *y = b;
+    if (x->smt != y->smt) return x->smt - y->smt;
+    if (x->core_rank != y->core_rank) return x->core_rank - y->core_rank;
+    return x->package - y->package;
+}
+
+// Monta o posicionamento de num_threads threads. Retorna 0 ou um código de erro (errno).
+static inline int affinity_plan(const AffinityTopology *topo, AffinityPolicy policy,
+                                int num_threads, AffinityPlan *plan) {
+    plan->policy = policy;
+    plan->num_threads = num_threads;
+    plan->cpus = NULL;
+    plan->nodes = NULL;
+    if (policy == AFFINITY_NONE) {
+        return 0;
+    }
+
+    AffinityCpu *order = malloc((size_t)topo->num_cpus * sizeof(AffinityCpu));
+    plan->cpus = malloc((size_t)num_threads * sizeof(int));
+    plan->nodes = malloc((size_t)num_threads * sizeof(int));
+    if (!order || !plan->cpus || !plan->nodes) {
+        free(order);
+        free(plan->cpus);
+        free(plan->nodes);
+        plan->cpus = plan->nodes = NULL;
+        return ENOMEM;
+    }
+
+    int n = 0;
+    for (int i = 0; i < topo->num_cpus; ++i) {
+        if (policy != AFFINITY_PHYSICAL || topo->cpus[i].smt == 0) {
+            order[n++] = topo->cpus[i];
+        }
+    }
+    qsort(order, (size_t)n, sizeof(AffinityCpu),
+          policy == AFFINITY_SCATTER ? affinity_cmp_scatter : affinity_cmp_compact);
+
+    for (int t = 0; t < num_threads; ++t) {
+        plan->cpus[t] = order[t % n].cpu;
+        plan->nodes[t] = order[t % n].node;
+    }
+    free(order);
+    return 0;
+}
+
+static inline void affinity_plan_free(AffinityPlan *plan) {
+    free(plan->cpus);
+    free(plan->nodes);
+    plan->cpus = plan->nodes = NULL;
+}
+
+// Nó NUMA da thread i, ou -1 se o plano não fixa threads
+static inline int affinity_node_of(const AffinityPlan *plan, int i) {
+    return plan && plan->nodes ? plan->nodes[i % plan->num_threads] : -1;
+}
+
+// Cria a thread i já fixada na sua CPU (sem migrar depois de começar).
+// Sem plano (ou com AFFINITY_NONE) equivale a pthread_create.
+static inline int affinity_thread_create(pthread_t *thread, const AffinityPlan *plan, int i,
+                                         void *(*fn)(void *), void *arg) {
+    if (!plan || !plan->cpus) {
+        return pthread_create(thread, NULL, fn, arg);
+    }
+
+    pthread_attr_t attr;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(plan->cpus[i % plan->num_threads], &set);
+
+    int ret = pthread_attr_init(&attr);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    if (ret == 0) {
+        ret = pthread_create(thread, &attr, fn, arg);
+    }
+    pthread_attr_destroy(&attr);
+    return ret;
+}
+
+// Fixa a thread chamadora na CPU da thread i do plano. Retorna 0 ou um código de erro.
+static inline int affinity_pin_self(const AffinityPlan *plan, int i) {
+    if (!plan || !plan->cpus) {
+        return 0;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(plan->cpus[i % plan->num_threads], &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static inline size_t affinity_round_to_pages(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page - 1) / page * page;
+}
+
+// Reserva size bytes zerados em páginas próprias, preferencialmente no nó
+// `node` (-1 = política padrão do kernel, isto é, o nó de quem tocar primeiro).
+// Libere com affinity_free_local(ptr, size). Retorna NULL se faltar memória.
+static inline void *affinity_alloc_local(size_t size, int node) {
+    size_t len = affinity_round_to_pages(size);
+    void *ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+
+    // Só faz sentido com mais de um nó; falha do mbind não impede o uso da memória
+    if (node >= 0 && node < 64 && access(AFFINITY_SYSFS_NODE "/node1", F_OK) == 0) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, ptr, len, AFFINITY_MPOL_PREFERRED, &mask, 64UL, 0U);
+    }
+    return ptr;
+}
+
+static inline void affinity_free_local(void *ptr, size_t size) {
+    if (ptr) {
+        munmap(ptr, affinity_round_to_pages(size));
+    }
+}
+
+// Imprime a política e a topologia usadas, para comparar curvas entre máquinas
+static inline void affinity_print(FILE *out, const AffinityTopology *topo, const AffinityPlan *plan) {
+    fprintf(out, "Afinidade: %s (%d CPUs lógicas, %d núcleos físicos, %d pacote(s), %d nó(s) NUMA)",
+            affinity_policy_name(plan->policy), topo->num_cpus, topo->num_cores,
+            topo->num_packages, topo->num_nodes);
+    if (plan->cpus) {
+        fprintf(out, "; CPUs:");
+        int shown = plan->num_threads < 64 ? plan->num_threads : 64;
+        for (int i = 0; i < shown; ++i) {
+            fprintf(out, "%s%d", i ? "," : " ", plan->cpus[i]);
+        }
+        if (shown < plan->num_threads) {
+            fprintf(out, ",...");
+        }
+    }
+    fprintf(out, "\n");
+}
+
+#endif // AFFINITY_H
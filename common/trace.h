@@ -0,0 +1,455 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Instrumentação de trechos quentes: intervalos com carimbo de tempo e,
+// opcionalmente, contadores de hardware, exportados no formato JSON de trace
+// do Chrome (abra em chrome://tracing ou ui.perfetto.dev).
+//
+// Cada thread grava num anel próprio (um só escritor, sem trava nem atômica
+// no caminho quente); o anel é registrado uma vez numa tabela global com um
+// fetch_add. Com o anel cheio, os eventos mais antigos são sobrescritos.
+// trace_write e trace_print_summary leem os anéis depois que as threads
+// terminaram (ou, no mínimo, pararam de gravar).
+//
+// O relógio é CLOCK_MONOTONIC_RAW (sem ajuste de NTP); com TRACE_USE_TSC, no
+// x86, é o TSC, convertido para ns com uma calibração feita em trace_init.
+//
+// Contadores (trace_init com counters = 1): cada thread abre, com
+// perf_event_open, um grupo só de espaço de usuário com ciclos, instruções,
+// faltas no último nível de cache e erros de previsão de desvio. Cada
+// intervalo guarda a diferença dos contadores entre trace_begin e trace_end.
+// Se o kernel recusar (perf_event_paranoid, contêiner, VM sem PMU), o
+// contador que faltar é só omitido; nada falha por causa disso.
+//
+// Nada é gravado antes de trace_init: o programa compilado com a
+// instrumentação só paga um teste por intervalo quando o trace não foi pedido.
+//
+// Sem TRACE_ENABLED definido na compilação, todas as funções são vazias e
+// somem do código gerado: os programas chamam a mesma API nos dois casos.
+//
+// Requer _GNU_SOURCE definido antes do primeiro include do arquivo que o usa.
+
+#ifndef _GNU_SOURCE
+#error "trace.h requer _GNU_SOURCE definido antes de qualquer include"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Contadores de hardware por intervalo
+#define TRACE_NUM_COUNTERS 4
+
+// Eventos por thread (potência de 2) e threads registradas
+#define TRACE_DEFAULT_EVENTS (1u << 16)
+#define TRACE_MAX_THREADS 1024
+
+static const char *const trace_counter_names[TRACE_NUM_COUNTERS] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"
+};
+
+#ifdef TRACE_ENABLED
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#if defined(TRACE_USE_TSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define TRACE_TSC 1
+#endif
+
+// Um intervalo terminado. name precisa viver até trace_write (um literal, em geral).
+typedef struct {
+    const char *name;
+    uint64_t start;                 // Em unidades do relógio (ns ou ciclos do TSC)
+    uint64_t duration;
+    uint64_t counters[TRACE_NUM_COUNTERS];
+} TraceEvent;
+
+// Anel de uma thread, com os descritores do grupo de contadores dela
+typedef struct {
+    TraceEvent *events;
+    uint32_t mask;
+    _Atomic uint64_t head;          // Eventos já gravados (o próximo vai em head & mask)
+    int tid;                        // Ordem de registro, usada como tid no trace
+    char name[32];
+    int fds[TRACE_NUM_COUNTERS];    // -1 = contador indisponível
+    int leader;                     // Primeiro descritor aberto (-1 = nenhum)
+} TraceRing;
+
+// Intervalo em andamento, na pilha de quem mede
+typedef struct {
+    uint64_t start;
+    uint64_t counters[TRACE_NUM_COUNTERS];
+} TraceSpan;
+
+static struct {
+    TraceRing *rings[TRACE_MAX_THREADS];
+    atomic_int num_rings;
+    uint32_t events_per_thread;
+    int counters;
+    atomic_int counters_opened;     // Threads que conseguiram abrir algum contador
+    double ns_per_tick;
+    struct timespec calib_ts;
+    uint64_t calib_ticks;
+} trace_state;
+
+static _Thread_local TraceRing *trace_ring;
+
+static inline bool trace_enabled(void) {
+    return true;
+}
+
+static inline uint64_t trace_now(void) {
+#ifdef TRACE_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Prepara o módulo. events_per_thread = 0 usa TRACE_DEFAULT_EVENTS (é
+// arredondado para potência de 2); counters = 1 liga os contadores de hardware.
+// Deve ser chamada antes de qualquer thread gravar. Retorna 0.
+static inline int trace_init(uint32_t events_per_thread, int counters) {
+    uint32_t n = 1;
+    while (n < (events_per_thread ? events_per_thread : TRACE_DEFAULT_EVENTS)) {
+        n <<= 1;
+    }
+    trace_state.events_per_thread = n;
+    trace_state.counters = counters;
+    trace_state.ns_per_tick = 1.0;
+#ifdef TRACE_TSC
+    clock_gettime(CLOCK_MONOTONIC_RAW, &trace_state.calib_ts);
+    trace_state.calib_ticks = __rdtsc();
+#endif
+    return 0;
+}
+
+// Abre o grupo de contadores da thread chamadora; o que falhar fica em -1
+static inline void trace_open_counters(TraceRing *ring) {
+    static const uint64_t configs[TRACE_NUM_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    ring->leader = -1;
+    for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+        ring->fds[c] = -1;
+        if (!trace_state.counters) {
+            continue;
+        }
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[c];
+        attr.disabled = ring->leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, ring->leader, 0);
+        if (fd >= 0) {
+            ring->fds[c] = (int)fd;
+            if (ring->leader < 0) {
+                ring->leader = (int)fd;
+            }
+        }
+    }
+    if (ring->leader >= 0) {
+        ioctl(ring->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        atomic_fetch_add(&trace_state.counters_opened, 1);
+    }
+}
+
+// Registra a thread chamadora com um nome para o trace (NULL = "thread N").
+// Chamadas repetidas na mesma thread, ou antes de trace_init, não fazem nada.
+// Retorna 0 ou -1 (errno definido).
+static inline int trace_thread_begin(const char *name) {
+    if (trace_ring || !trace_state.events_per_thread) {
+        return 0;
+    }
+    TraceRing *ring = calloc(1, sizeof(TraceRing));
+    if (!ring) {
+        return -1;
+    }
+    ring->events = malloc((size_t)trace_state.events_per_thread * sizeof(TraceEvent));
+    if (!ring->events) {
+        free(ring);
+        return -1;
+    }
+    ring->mask = trace_state.events_per_thread - 1;
+    ring->tid = atomic_fetch_add(&trace_state.num_rings, 1);
+    if (ring->tid >= TRACE_MAX_THREADS) {
+        atomic_fetch_sub(&trace_state.num_rings, 1);
+        free(ring->events);
+        free(ring);
+        errno = ENOSPC;
+        return -1;
+    }
+    snprintf(ring->name, sizeof(ring->name), "%s %d", name ? name : "thread", ring->tid);
+    trace_open_counters(ring);
+    trace_ring = ring;
+    trace_state.rings[ring->tid] = ring;
+    return 0;
+}
+
+// Fecha os contadores da thread. O anel continua registrado até trace_shutdown.
+static inline void trace_thread_end(void) {
+    TraceRing *ring = trace_ring;
+    if (!ring) {
+        return;
+    }
+    for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+        if (ring->fds[c] >= 0) {
+            close(ring->fds[c]);
+            ring->fds[c] = -1;
+        }
+    }
+    ring->leader = -1;
+    trace_ring = NULL;
+}
+
+// Lê os contadores do grupo da thread (0 nos que não abriram)
+static inline void trace_read_counters(const TraceRing *ring, uint64_t *out) {
+    memset(out, 0, TRACE_NUM_COUNTERS * sizeof(uint64_t));
+    if (ring->leader < 0) {
+        return;
+    }
+    // nr, depois (valor, id) de cada membro, na ordem de abertura
+    uint64_t buf[1 + 2 * TRACE_NUM_COUNTERS];
+    if (read(ring->leader, buf, sizeof(buf)) < (ssize_t)sizeof(uint64_t)) {
+        return;
+    }
+    uint64_t nr = buf[0];
+    for (int c = 0, member = 0; c < TRACE_NUM_COUNTERS && (uint64_t)member < nr; c++) {
+        if (ring->fds[c] >= 0) {
+            out[c] = buf[1 + 2 * member];
+            member++;
+        }
+    }
+}
+
+// Início de um intervalo. Registra a thread sem nome, se preciso.
+static inline void trace_begin(TraceSpan *span) {
+    if (!trace_ring && (trace_thread_begin(NULL) != 0 || !trace_ring)) {
+        span->start = 0;
+        return;
+    }
+    if (trace_ring->leader >= 0) {
+        trace_read_counters(trace_ring, span->counters);
+    }
+    span->start = trace_now();
+}
+
+// Fim de um intervalo: grava o evento no anel da thread
+static inline void trace_end(TraceSpan *span, const char *name) {
+    uint64_t end = trace_now();
+    TraceRing *ring = trace_ring;
+    if (!ring || !span->start) {
+        return;
+    }
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    TraceEvent *event = &ring->events[head & ring->mask];
+    event->name = name;
+    event->start = span->start;
+    event->duration = end - span->start;
+    if (ring->leader >= 0) {
+        trace_read_counters(ring, event->counters);
+        for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+            event->counters[c] -= span->counters[c];
+        }
+    } else {
+        memset(event->counters, 0, sizeof(event->counters));
+    }
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// Converte unidades do relógio para ns (com o TSC, calibra contra CLOCK_MONOTONIC_RAW)
+static inline void trace_calibrate(void) {
+#ifdef TRACE_TSC
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    uint64_t ticks = __rdtsc();
+    double ns = (now.tv_sec - trace_state.calib_ts.tv_sec) * 1e9 + (now.tv_nsec - trace_state.calib_ts.tv_nsec);
+    if (ticks > trace_state.calib_ticks) {
+        trace_state.ns_per_tick = ns / (double)(ticks - trace_state.calib_ticks);
+    }
+#endif
+}
+
+// Primeiro evento ainda no anel e quantos há
+static inline uint64_t trace_ring_range(const TraceRing *ring, uint64_t *first) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t count = head < (uint64_t)ring->mask + 1 ? head : (uint64_t)ring->mask + 1;
+    *first = head - count;
+    return count;
+}
+
+// Grava todos os anéis em path no formato de trace do Chrome (tempos em µs,
+// contadores em "args"). Retorna 0 ou -1 (errno definido).
+static inline int trace_write(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        return -1;
+    }
+    trace_calibrate();
+    int num_rings = atomic_load(&trace_state.num_rings);
+
+    // Origem dos tempos: o evento mais antigo
+    uint64_t origin = UINT64_MAX;
+    for (int r = 0; r < num_rings; r++) {
+        uint64_t first;
+        if (trace_ring_range(trace_state.rings[r], &first) > 0) {
+            uint64_t start = trace_state.rings[r]->events[first & trace_state.rings[r]->mask].start;
+            origin = start < origin ? start : origin;
+        }
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    const char *sep = "";
+    for (int r = 0; r < num_rings; r++) {
+        const TraceRing *ring = trace_state.rings[r];
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                sep, ring->tid, ring->name);
+        sep = ",\n";
+        uint64_t first;
+        uint64_t count = trace_ring_range(ring, &first);
+        for (uint64_t i = first; i < first + count; i++) {
+            const TraceEvent *e = &ring->events[i & ring->mask];
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+                    sep, e->name, ring->tid, (double)(e->start - origin) * trace_state.ns_per_tick / 1e3,
+                    (double)e->duration * trace_state.ns_per_tick / 1e3);
+            const char *arg_sep = "";
+            for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+                if (e->counters[c]) {
+                    fprintf(out, "%s\"%s\":%llu", arg_sep, trace_counter_names[c],
+                            (unsigned long long)e->counters[c]);
+                    arg_sep = ",";
+                }
+            }
+            fprintf(out, "}}");
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (fclose(out) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Resumo por nome de intervalo: quantidade, tempo total e contadores somados
+static inline void trace_print_summary(FILE *out) {
+    trace_calibrate();
+    int num_rings = atomic_load(&trace_state.num_rings);
+    const char *names[64];
+    uint64_t count[64], duration[64], counters[64][TRACE_NUM_COUNTERS];
+    int num_names = 0;
+    for (int r = 0; r < num_rings; r++) {
+        const TraceRing *ring = trace_state.rings[r];
+        uint64_t first;
+        uint64_t n = trace_ring_range(ring, &first);
+        for (uint64_t i = first; i < first + n; i++) {
+            const TraceEvent *e = &ring->events[i & ring->mask];
+            int k = 0;
+            while (k < num_names && strcmp(names[k], e->name) != 0) {
+                k++;
+            }
+            if (k == num_names) {
+                if (num_names == 64) {
+                    continue;
+                }
+                names[num_names] = e->name;
+                count[num_names] = duration[num_names] = 0;
+                memset(counters[num_names], 0, sizeof(counters[num_names]));
+                num_names++;
+            }
+            count[k]++;
+            duration[k] += e->duration;
+            for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+                counters[k][c] += e->counters[c];
+            }
+        }
+    }
+
+    if (trace_state.counters && !atomic_load(&trace_state.counters_opened)) {
+        fprintf(out, "Contadores de hardware indisponíveis (perf_event_open recusado ou sem PMU)\n");
+    }
+    fprintf(out, "%-24s %10s %14s %16s %16s %8s %14s %14s\n", "intervalo", "eventos", "tempo_s",
+            trace_counter_names[0], trace_counter_names[1], "IPC", trace_counter_names[2], trace_counter_names[3]);
+    for (int k = 0; k < num_names; k++) {
+        fprintf(out, "%-24s %10llu %14.6f %16llu %16llu %8.2f %14llu %14llu\n", names[k],
+                (unsigned long long)count[k], (double)duration[k] * trace_state.ns_per_tick / 1e9,
+                (unsigned long long)counters[k][0], (unsigned long long)counters[k][1],
+                counters[k][0] ? (double)counters[k][1] / (double)counters[k][0] : 0.0,
+                (unsigned long long)counters[k][2], (unsigned long long)counters[k][3]);
+    }
+}
+
+// Libera os anéis. Nenhuma thread pode estar gravando.
+static inline void trace_shutdown(void) {
+    trace_thread_end();
+    int num_rings = atomic_load(&trace_state.num_rings);
+    for (int r = 0; r < num_rings; r++) {
+        free(trace_state.rings[r]->events);
+        free(trace_state.rings[r]);
+        trace_state.rings[r] = NULL;
+    }
+    atomic_store(&trace_state.num_rings, 0);
+}
+
+#else // !TRACE_ENABLED: tudo vira nada
+
+typedef struct {
+    char unused;
+} TraceSpan;
+
+static inline bool trace_enabled(void) {
+    return false;
+}
+
+static inline int trace_init(uint32_t events_per_thread, int counters) {
+    (void)events_per_thread;
+    (void)counters;
+    return 0;
+}
+
+static inline int trace_thread_begin(const char *name) {
+    (void)name;
+    return 0;
+}
+
+static inline void trace_thread_end(void) {
+}
+
+static inline void trace_begin(TraceSpan *span) {
+    (void)span;
+}
+
+static inline void trace_end(TraceSpan *span, const char *name) {
+    (void)span;
+    (void)name;
+}
+
+static inline int trace_write(const char *path) {
+    (void)path;
+    return 0;
+}
+
+static inline void trace_print_summary(FILE *out) {
+    (void)out;
+}
+
+static inline void trace_shutdown(void) {
+}
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
@@ -0,0 +1,433 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+// Driver de benchmark de escalabilidade para sequencial_pi e parallel_pi.
+//
+// Executa os binários com popen e lê os tempos que eles já imprimem
+// ("Tempo de CPU usado" no sequencial, "Tempo parcial decorrido" no paralelo),
+// repetindo cada ponto várias vezes. O speedup compara o paralelo com ele
+// mesmo em 1 thread, com o mesmo kernel de amostragem, para medir só o ganho
+// das threads:
+//
+//   forte   N fixo, threads 1..T: speedup = t_par(1, N) / t_par(T, N)
+//   fraca   N por thread fixo:    speedup = T * t_par(1, N) / t_par(T, T * N)
+//
+// Em ambos a eficiência é speedup / T. O ganho do kernel (SIMD) fica numa
+// coluna à parte: kernel = t_seq(N) / t_par(1, N), em que o sequencial usa o
+// mesmo gerador (Philox) no kernel escalar. Os resultados saem numa tabela, em CSV
+// (-o) e em JSON (-j). Com -B <arquivo> o CSV de uma execução anterior vira a
+// referência: os pontos são casados por modo, threads, lançamentos, política e
+// kernel; se a vazão de algum cair mais que a tolerância, o driver termina com
+// código 2, e se nenhum casar, com código 1.
+
+// Limites da varredura
+#define MAX_POINTS 64
+#define MAX_TRIALS 100
+
+// Tolerância padrão de queda de vazão na checagem de regressão (fração)
+#define DEFAULT_TOLERANCE 0.10
+
+typedef enum { MODE_STRONG, MODE_WEAK } ScalingMode;
+
+// Um ponto medido da varredura
+typedef struct {
+    ScalingMode mode;
+    int threads;
+    long long tosses;           // Total de lançamentos do ponto
+    int trials;
+    double median;
+    double min;
+    double stddev;
+    double throughput;          // Lançamentos por segundo (pela mediana)
+    double speedup;
+    double efficiency;
+    double kernel_speedup;      // Sequencial escalar / paralelo em 1 thread
+} BenchPoint;
+
+typedef struct {
+    const char *seq_path;
+    const char *par_path;
+    const char *policy;         // Repassada ao parallel_pi com -a (NULL = não passar)
+    const char *kernel;         // Repassado ao parallel_pi com -k (NULL = o melhor da CPU)
+    int trials;
+} BenchConfig;
+
+static const char *mode_name(ScalingMode mode) {
+    return mode == MODE_STRONG ? "forte" : "fraca";
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Mediana, mínimo e desvio padrão amostral de n tempos (ordena o vetor)
+static void summarize(double *times, int n, double *median, double *min, double *stddev) {
+    qsort(times, (size_t)n, sizeof(double), cmp_double);
+    *min = times[0];
+    *median = n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+
+    double mean = 0.0;
+    for (int i = 0; i < n; ++i) {
+        mean += times[i];
+    }
+    mean /= n;
+    double ss = 0.0;
+    for (int i = 0; i < n; ++i) {
+        ss += (times[i] - mean) * (times[i] - mean);
+    }
+    *stddev = n > 1 ? sqrt(ss / (n - 1)) : 0.0;
+}
+
+// Linha da saída a ser copiada por run_and_parse
+typedef struct {
+    const char *prefix;
+    char *buf;
+    size_t len;
+} EchoLine;
+
+// Executa o comando e devolve o valor numérico da primeira linha que começa
+// com `prefix`. Para cada um dos `num_echo` pedidos, copia a primeira linha com
+// o prefixo dele para o buffer (sem a quebra de linha) se o buffer ainda estiver
+// vazio. Retorna 0, ou -1 se o comando falhar ou não imprimir a linha.
+static int run_and_parse(const char *cmd, const char *prefix, double *value,
+                         const EchoLine *echo, int num_echo) {
+    FILE *p = popen(cmd, "r");
+    if (!p) {
+        return -1;
+    }
+
+    char line[1024];
+    int found = 0;
+    size_t plen = strlen(prefix);
+    while (fgets(line, sizeof(line), p)) {
+        if (!found && strncmp(line, prefix, plen) == 0) {
+            found = sscanf(line + plen, "%lf", value) == 1;
+        }
+        for (int e = 0; e < num_echo; ++e) {
+            if (echo[e].buf[0] != '\0' || strncmp(line, echo[e].prefix, strlen(echo[e].prefix)) != 0) {
+                continue;
+            }
+            size_t len = strcspn(line, "\n");
+            if (len >= echo[e].len) {
+                len = echo[e].len - 1;
+            }
+            memcpy(echo[e].buf, line, len);
+            echo[e].buf[len] = '\0';
+        }
+    }
+
+    int status = pclose(p);
+    return found && status == 0 ? 0 : -1;
+}
+
+// Mede `trials` execuções do sequencial com N lançamentos
+static int time_sequential(const BenchConfig *cfg, long long tosses, double *times) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "%s -s 42 %lld", cfg->seq_path, tosses);
+    for (int t = 0; t < cfg->trials; ++t) {
+        if (run_and_parse(cmd, "Tempo de CPU usado:", &times[t], NULL, 0) != 0) {
+            fprintf(stderr, "Falha ao executar: %s\n", cmd);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Mede `trials` execuções do paralelo; guarda a linha de afinidade em affinity
+// e a linha inicial, que traz o kernel usado, em banner
+static int time_parallel(const BenchConfig *cfg, int threads, long long tosses, double *times,
+                         char *affinity, size_t affinity_len, char *banner, size_t banner_len) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "%s -s 42 %s%s %s%s %d %lld", cfg->par_path,
+             cfg->policy ? "-a " : "", cfg->policy ? cfg->policy : "",
+             cfg->kernel ? "-k " : "", cfg->kernel ? cfg->kernel : "", threads, tosses);
+    for (int t = 0; t < cfg->trials; ++t) {
+        EchoLine echo[] = {{"Afinidade:", affinity, affinity_len}, {"Calculando com", banner, banner_len}};
+        if (run_and_parse(cmd, "Tempo parcial decorrido:", &times[t], echo, 2) != 0) {
+            fprintf(stderr, "Falha ao executar: %s\n", cmd);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Contagens de threads da varredura: potências de dois até max_threads, mais o próprio máximo
+static int thread_counts(int max_threads, int *counts) {
+    int n = 0;
+    for (int t = 1; t < max_threads && n < MAX_POINTS - 1; t *= 2) {
+        counts[n++] = t;
+    }
+    counts[n++] = max_threads;
+    return n;
+}
+
+// O kernel usado vai na última coluna (amostragem), depois do ganho do kernel
+static void write_csv(FILE *f, const BenchPoint *points, int n, const char *policy, const char *kernel) {
+    fprintf(f, "modo,threads,lancamentos,politica,tentativas,mediana_s,min_s,desvio_s,vazao,speedup,eficiencia,"
+               "kernel,amostragem\n");
+    for (int i = 0; i < n; ++i) {
+        const BenchPoint *p = &points[i];
+        fprintf(f, "%s,%d,%lld,%s,%d,%.9f,%.9f,%.9f,%.6e,%.4f,%.4f,%.4f,%s\n",
+                mode_name(p->mode), p->threads, p->tosses, policy, p->trials, p->median, p->min,
+                p->stddev, p->throughput, p->speedup, p->efficiency, p->kernel_speedup, kernel);
+    }
+}
+
+static void write_json(FILE *f, const BenchPoint *points, int n, const char *policy, const char *kernel,
+                       const char *affinity, long long seq_tosses, double seq_median,
+                       double seq_min, double seq_stddev, double ref_median, int trials) {
+    fprintf(f, "{\n");
+    fprintf(f, "  \"politica\": \"%s\",\n", policy);
+    fprintf(f, "  \"amostragem\": \"%s\",\n", kernel);
+    fprintf(f, "  \"afinidade\": \"%s\",\n", affinity);
+    fprintf(f, "  \"cpus_online\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(f, "  \"tentativas\": %d,\n", trials);
+    fprintf(f, "  \"sequencial\": {\"lancamentos\": %lld, \"mediana_s\": %.9f, \"min_s\": %.9f, \"desvio_s\": %.9f},\n",
+            seq_tosses, seq_median, seq_min, seq_stddev);
+    fprintf(f, "  \"paralelo_1_thread\": {\"lancamentos\": %lld, \"mediana_s\": %.9f},\n", seq_tosses, ref_median);
+    fprintf(f, "  \"pontos\": [\n");
+    for (int i = 0; i < n; ++i) {
+        const BenchPoint *p = &points[i];
+        fprintf(f, "    {\"modo\": \"%s\", \"threads\": %d, \"lancamentos\": %lld, \"mediana_s\": %.9f, "
+                   "\"min_s\": %.9f, \"desvio_s\": %.9f, \"vazao\": %.6e, \"speedup\": %.4f, \"eficiencia\": %.4f, \"kernel\": %.4f}%s\n",
+                mode_name(p->mode), p->threads, p->tosses, p->median, p->min, p->stddev,
+                p->throughput, p->speedup, p->efficiency, p->kernel_speedup, i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// Compara com o CSV de referência: pontos de mesmo (modo, threads, lançamentos,
+// política, kernel) cuja vazão caiu mais que `tolerance`. Linhas sem o kernel
+// (CSVs antigos) não casam com nada. Retorna o número de regressões, ou -1 se
+// o arquivo não puder ser lido ou nenhum ponto casar.
+static int check_regression(const char *path, const BenchPoint *points, int n, const char *cur_policy,
+                            const char *cur_kernel, double tolerance) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    char line[1024];
+    int regressions = 0, matched = 0;
+    if (!fgets(line, sizeof(line), f)) {      // Cabeçalho
+        fprintf(stderr, "Referência vazia: %s\n", path);
+        fclose(f);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char mode[16], policy[32], kernel[32];
+        int threads, trials;
+        long long tosses;
+        double median, min, stddev, throughput, speedup, efficiency, kernel_speedup;
+        if (sscanf(line, "%15[^,],%d,%lld,%31[^,],%d,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%31[^,\n]",
+                   mode, &threads, &tosses, policy, &trials, &median, &min, &stddev, &throughput,
+                   &speedup, &efficiency, &kernel_speedup, kernel) != 13) {
+            continue;
+        }
+        if (strcmp(policy, cur_policy) != 0 || strcmp(kernel, cur_kernel) != 0) {
+            continue;
+        }
+        for (int i = 0; i < n; ++i) {
+            const BenchPoint *p = &points[i];
+            if (strcmp(mode, mode_name(p->mode)) != 0 || p->threads != threads || p->tosses != tosses) {
+                continue;
+            }
+            matched++;
+            double change = p->throughput / throughput - 1.0;
+            if (change < -tolerance) {
+                printf("REGRESSÃO: escala %s, %d threads, %lld lançamentos: %.3e -> %.3e lançamentos/s (%+.1f%%)\n",
+                       mode, threads, tosses, throughput, p->throughput, 100.0 * change);
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+
+    if (matched == 0) {
+        fprintf(stderr, "Nenhum ponto de %s casa com esta execução (política %s, kernel %s): "
+                        "a referência é de outra máquina, configuração ou versão do CSV?\n",
+                path, cur_policy, cur_kernel);
+        return -1;
+    }
+    printf("Checagem de regressão contra %s: %d pontos comparados, %d regressões (tolerância %.1f%%)\n",
+           path, matched, regressions, 100.0 * tolerance);
+    return regressions;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Uso: %s [opções] <lançamentos>\n", prog);
+    fprintf(stderr, "  <lançamentos>  N da escala forte e N por thread da escala fraca\n");
+    fprintf(stderr, "  -m modo        forte, fraca ou ambos (padrão: ambos)\n");
+    fprintf(stderr, "  -t threads     máximo de threads da varredura (padrão: CPUs online)\n");
+    fprintf(stderr, "  -r tentativas  execuções por ponto (padrão: 5)\n");
+    fprintf(stderr, "  -a política    afinidade repassada ao parallel_pi (none compact scatter physical)\n");
+    fprintf(stderr, "  -k kernel      kernel repassado ao parallel_pi (padrão: o melhor da CPU)\n");
+    fprintf(stderr, "  -S caminho     binário sequencial (padrão: ./sequencial_pi)\n");
+    fprintf(stderr, "  -P caminho     binário paralelo (padrão: ./parallel_pi)\n");
+    fprintf(stderr, "  -o arquivo     grava os resultados em CSV (serve de referência para -B)\n");
+    fprintf(stderr, "  -j arquivo     grava os resultados em JSON\n");
+    fprintf(stderr, "  -B arquivo     CSV de referência: falha (código 2) se a vazão cair mais que a tolerância\n");
+    fprintf(stderr, "  -x fração      tolerância da checagem de regressão (padrão: %.2f)\n", DEFAULT_TOLERANCE);
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig cfg = {"./sequencial_pi", "./parallel_pi", NULL, NULL, 5};
+    const char *mode_arg = "ambos";
+    const char *csv_path = NULL, *json_path = NULL, *baseline_path = NULL;
+    double tolerance = DEFAULT_TOLERANCE;
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:t:r:a:k:S:P:o:j:B:x:")) != -1) {
+        switch (opt) {
+        case 'm': mode_arg = optarg; break;
+        case 't': max_threads = atoi(optarg); break;
+        case 'r': cfg.trials = atoi(optarg); break;
+        case 'a': cfg.policy = optarg; break;
+        case 'k': cfg.kernel = optarg; break;
+        case 'S': cfg.seq_path = optarg; break;
+        case 'P': cfg.par_path = optarg; break;
+        case 'o': csv_path = optarg; break;
+        case 'j': json_path = optarg; break;
+        case 'B': baseline_path = optarg; break;
+        case 'x': tolerance = strtod(optarg, NULL); break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    int do_strong = strcmp(mode_arg, "forte") == 0 || strcmp(mode_arg, "ambos") == 0;
+    int do_weak = strcmp(mode_arg, "fraca") == 0 || strcmp(mode_arg, "ambos") == 0;
+    if (argc - optind != 1 || (!do_strong && !do_weak) || max_threads <= 0
+        || cfg.trials <= 0 || cfg.trials > MAX_TRIALS || tolerance < 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    char *endptr;
+    long long tosses = strtoll(argv[optind], &endptr, 10);
+    if (*endptr != '\0' || tosses <= 0) {
+        fprintf(stderr, "Erro: forneça um número inteiro positivo de lançamentos.\n");
+        return 1;
+    }
+
+    int counts[MAX_POINTS];
+    int num_counts = thread_counts(max_threads, counts);
+    double times[MAX_TRIALS];
+    BenchPoint points[2 * MAX_POINTS];
+    int num_points = 0;
+    char affinity[256] = "";
+    char banner[256] = "";
+    char kernel[32] = "";
+    const char *policy = cfg.policy ? cfg.policy : "none";
+
+    // Referência sequencial: N lançamentos (o mesmo N serve às duas escalas)
+    double seq_median, seq_min, seq_stddev;
+    printf("Referência sequencial: %s %lld (%d tentativas)...\n", cfg.seq_path, tosses, cfg.trials);
+    if (time_sequential(&cfg, tosses, times) != 0) {
+        return 1;
+    }
+    summarize(times, cfg.trials, &seq_median, &seq_min, &seq_stddev);
+
+    // Base do speedup: o paralelo em 1 thread com N lançamentos, no mesmo kernel dos pontos
+    double ref_median, ref_min, ref_stddev;
+    printf("Referência paralela: 1 thread, %lld lançamentos...\n", tosses);
+    if (time_parallel(&cfg, 1, tosses, times, affinity, sizeof(affinity), banner, sizeof(banner)) != 0) {
+        return 1;
+    }
+    summarize(times, cfg.trials, &ref_median, &ref_min, &ref_stddev);
+
+    // Kernel de fato usado pelo parallel_pi ("... (kernel avx2, semente ...")
+    const char *kernel_at = strstr(banner, "(kernel ");
+    if (!kernel_at || sscanf(kernel_at, "(kernel %31[^,)]", kernel) != 1) {
+        fprintf(stderr, "O parallel_pi não informou o kernel usado.\n");
+        return 1;
+    }
+
+    for (int m = 0; m < 2; ++m) {
+        ScalingMode mode = m == 0 ? MODE_STRONG : MODE_WEAK;
+        if ((mode == MODE_STRONG && !do_strong) || (mode == MODE_WEAK && !do_weak)) {
+            continue;
+        }
+        for (int c = 0; c < num_counts; ++c) {
+            BenchPoint *p = &points[num_points++];
+            p->mode = mode;
+            p->threads = counts[c];
+            p->tosses = mode == MODE_STRONG ? tosses : tosses * counts[c];
+            p->trials = cfg.trials;
+
+            if (p->threads == 1) {
+                // Mesmo comando da referência paralela: reaproveita a medição (speedup 1)
+                p->median = ref_median;
+                p->min = ref_min;
+                p->stddev = ref_stddev;
+            } else {
+                printf("Escala %s: %d threads, %lld lançamentos...\n", mode_name(mode), p->threads, p->tosses);
+                fflush(stdout);
+                if (time_parallel(&cfg, p->threads, p->tosses, times, affinity, sizeof(affinity),
+                                  banner, sizeof(banner)) != 0) {
+                    return 1;
+                }
+                summarize(times, cfg.trials, &p->median, &p->min, &p->stddev);
+            }
+
+            p->throughput = (double)p->tosses / p->median;
+            p->speedup = mode == MODE_STRONG ? ref_median / p->median
+                                             : p->threads * ref_median / p->median;
+            p->efficiency = p->speedup / p->threads;
+            p->kernel_speedup = seq_median / ref_median;
+        }
+    }
+
+    // Tabela
+    printf("\n%s\n", affinity[0] ? affinity : "Afinidade: (não informada pelo parallel_pi)");
+    printf("Sequencial (Philox escalar): %lld lançamentos, mediana %.6f s, mínimo %.6f s, desvio %.6f s\n",
+           tosses, seq_median, seq_min, seq_stddev);
+    printf("Paralelo em 1 thread (kernel %s): mediana %.6f s (base do speedup)\n\n", kernel, ref_median);
+    printf("%-6s %8s %14s %12s %12s %12s %14s %9s %10s %8s\n", "escala", "threads", "lançamentos",
+           "mediana (s)", "mínimo (s)", "desvio (s)", "vazão (/s)", "speedup", "eficiência", "kernel");
+    for (int i = 0; i < num_points; ++i) {
+        const BenchPoint *p = &points[i];
+        printf("%-6s %8d %14lld %12.6f %12.6f %12.6f %14.4e %9.2f %9.1f%% %7.2fx\n", mode_name(p->mode),
+               p->threads, p->tosses, p->median, p->min, p->stddev, p->throughput,
+               p->speedup, 100.0 * p->efficiency, p->kernel_speedup);
+    }
+
+    // A referência é lida antes de gravar, para que -o e -B possam apontar para o mesmo arquivo
+    int regressions = 0;
+    if (baseline_path) {
+        printf("\n");
+        regressions = check_regression(baseline_path, points, num_points, policy, kernel, tolerance);
+        if (regressions < 0) {
+            return 1;
+        }
+    }
+
+    if (csv_path) {
+        FILE *f = fopen(csv_path, "w");
+        if (!f) {
+            perror(csv_path);
+            return 1;
+        }
+        write_csv(f, points, num_points, policy, kernel);
+        fclose(f);
+    }
+    if (json_path) {
+        FILE *f = fopen(json_path, "w");
+        if (!f) {
+            perror(json_path);
+            return 1;
+        }
+        write_json(f, points, num_points, policy, kernel, affinity, tosses, seq_median, seq_min, seq_stddev, ref_median,
+                   cfg.trials);
+        fclose(f);
+    }
+
+    return regressions > 0 ? 2 : 0;
+}
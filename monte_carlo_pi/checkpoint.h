@@ -0,0 +1,162 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+// Progresso por fluxo e checkpoints do modo contínuo do parallel_pi.
+//
+// Cada thread percorre um fluxo [first, end) de índices de lançamento e publica
+// a posição atual e os acertos acumulados no seu StreamSlot por meio de um
+// seqlock: o escritor nunca espera, e o leitor (a thread de relatório) só
+// repete a leitura se pegou uma publicação no meio.
+//
+// Como o lançamento i depende só de (semente, i), o estado
+// (semente, total, {first, pos, end, hits} por fluxo) basta para retomar a
+// execução e chegar exatamente ao mesmo resultado final.
+//
+// O arquivo é texto:
+//   parallel_pi-checkpoint 1
+//   semente <s>
+//   total <n>
+//   fluxos <k>
+//   <first> <pos> <end> <hits>     (uma linha por fluxo)
+// e é gravado de forma atômica (arquivo temporário + fsync + rename).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CHECKPOINT_MAGIC "parallel_pi-checkpoint"
+#define CHECKPOINT_VERSION 1
+
+// Progresso publicado por um fluxo, em sua própria linha de cache
+typedef struct {
+    _Alignas(64) atomic_uint seq;   // Ímpar enquanto uma publicação está em andamento
+    atomic_llong pos;               // Próximo índice a sortear
+    atomic_llong hits;              // Acertos em [first, pos)
+    long long first;
+    long long end;
+} StreamSlot;
+
+static inline void stream_init(StreamSlot *slot, long long first, long long pos, long long end, long long hits) {
+    atomic_init(&slot->seq, 0);
+    atomic_init(&slot->pos, pos);
+    atomic_init(&slot->hits, hits);
+    slot->first = first;
+    slot->end = end;
+}
+
+// Publica (pos, hits); apenas a thread dona do fluxo escreve
+static inline void stream_publish(StreamSlot *slot, long long pos, long long hits) {
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->pos, pos, memory_order_relaxed);
+    atomic_store_explicit(&slot->hits, hits, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+// Lê um par (pos, hits) consistente
+static inline void stream_snapshot(StreamSlot *slot, long long *pos, long long *hits) {
+    for (;;) {
+        unsigned s1 = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        *pos = atomic_load_explicit(&slot->pos, memory_order_relaxed);
+        *hits = atomic_load_explicit(&slot->hits, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        unsigned s2 = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if (s1 == s2 && !(s1 & 1)) {
+            return;
+        }
+    }
+}
+
+// Grava o checkpoint de forma atômica. slots[i] é o fluxo i (cada um pode estar
+// numa página própria). Retorna 0 ou -1 (errno definido).
+static inline int checkpoint_write(const char *path, uint64_t seed, long long total_tosses,
+                                   StreamSlot *const *slots, int num_streams) {
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        return -1;
+    }
+
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) {
+        return -1;
+    }
+
+    fprintf(f, "%s %d\n", CHECKPOINT_MAGIC, CHECKPOINT_VERSION);
+    fprintf(f, "semente %llu\n", (unsigned long long)seed);
+    fprintf(f, "total %lld\n", total_tosses);
+    fprintf(f, "fluxos %d\n", num_streams);
+    for (int i = 0; i < num_streams; ++i) {
+        long long pos, hits;
+        stream_snapshot(slots[i], &pos, &hits);
+        fprintf(f, "%lld %lld %lld %lld\n", slots[i]->first, pos, slots[i]->end, hits);
+    }
+
+    if (fflush(f) != 0 || fsync(fileno(f)) != 0) {
+        fclose(f);
+        unlink(tmp_path);
+        return -1;
+    }
+    if (fclose(f) != 0 || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Lê um checkpoint; *slots é alocado com aligned_alloc e deve ser liberado
+// com free. Retorna 0, ou -1 se o arquivo não existir ou for inválido.
+static inline int checkpoint_read(const char *path, uint64_t *seed, long long *total_tosses,
+                                  StreamSlot **slots, int *num_streams) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+
+    char magic[64];
+    int version, n;
+    unsigned long long s;
+    long long total;
+    if (fscanf(f, "%63s %d semente %llu total %lld fluxos %d", magic, &version, &s, &total, &n) != 5
+        || strcmp(magic, CHECKPOINT_MAGIC) != 0 || version != CHECKPOINT_VERSION || n <= 0 || total <= 0) {
+        fclose(f);
+        return -1;
+    }
+
+    StreamSlot *arr = aligned_alloc(64, (size_t)n * sizeof(StreamSlot));
+    if (!arr) {
+        fclose(f);
+        return -1;
+    }
+
+    long long expected_first = 0;
+    for (int i = 0; i < n; ++i) {
+        long long first, pos, end, hits;
+        // Os fluxos precisam cobrir [0, total) em ordem e com posições coerentes
+        if (fscanf(f, "%lld %lld %lld %lld", &first, &pos, &end, &hits) != 4
+            || first != expected_first || pos < first || pos > end || hits < 0 || hits > pos - first) {
+            free(arr);
+            fclose(f);
+            return -1;
+        }
+        stream_init(&arr[i], first, pos, end, hits);
+        expected_first = end;
+    }
+    fclose(f);
+
+    if (expected_first != total) {
+        free(arr);
+        return -1;
+    }
+
+    *seed = s;
+    *total_tosses = total;
+    *slots = arr;
+    *num_streams = n;
+    return 0;
+}
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,739 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <endian.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "philox.h"
+
+// Modo coordenador/worker do Monte Carlo de Pi em vários processos (ou máquinas).
+//
+// O coordenador escuta em um socket TCP ou Unix, entrega lotes de lançamentos
+// (semente + intervalo de índices Philox) aos workers conectados e soma os
+// acertos conforme os resultados chegam. Como cada lançamento depende só de
+// (semente, índice), o resultado é idêntico ao do parallel_pi com a mesma
+// semente, qualquer que seja a quantidade de workers ou a ordem dos lotes.
+//
+// Se um worker cai (conexão fechada ou erro), os lotes que estavam com ele
+// voltam para a fila e são entregues a outro worker. Uma máquina que some sem
+// fechar a conexão (queda de energia, rede partida) é detectada de dois jeitos:
+// pelo prazo por lote (-t), que desliga o worker que passou esse tempo com
+// lotes pendentes sem entregar nenhum resultado, e pelo keepalive do TCP, que
+// derruba a conexão ociosa cujo outro lado não responde. A vaga de um worker
+// que caiu é reaproveitada pela próxima conexão.
+//
+// Exemplos:
+//   ./distributed_pi coordenador -l 4 -s 42 1000000000
+//   ./distributed_pi coordenador -a tcp:0.0.0.0:5555 -s 42 1000000000   (workers remotos)
+//   ./distributed_pi worker tcp:coordenador.exemplo:5555
+
+// Tipos de mensagem
+enum {
+    PI_MSG_HELLO = 1,      // worker -> coordenador: a = pid
+    PI_MSG_BATCH = 2,      // coordenador -> worker: a = lote, b = semente, c = primeiro, d = quantidade
+    PI_MSG_STOP = 3,       // coordenador -> worker
+    PI_MSG_RESULT = 4,     // worker -> coordenador: a = lote, b = acertos, c = nanossegundos de cálculo
+};
+
+// Mensagem de tamanho fixo; os campos trafegam em big-endian
+typedef struct {
+    uint64_t type;
+    uint64_t a, b, c, d;
+} Message;
+
+#define PI_MSG_SIZE sizeof(Message)
+
+// Tamanho padrão do lote e lotes simultâneos por worker (o segundo esconde a latência da rede)
+#define DEFAULT_BATCH_SIZE (1LL << 24)
+#define MAX_INFLIGHT 2
+#define MAX_WORKERS 256
+
+// Sem nenhum worker conectado por este tempo, o coordenador desiste
+#define NO_WORKER_TIMEOUT_S 10
+
+// Prazo padrão para um worker com lotes pendentes entregar o próximo resultado
+#define DEFAULT_BATCH_TIMEOUT_S 60
+
+// Keepalive do TCP: sondas após 10 s ociosos, a cada 5 s, 3 sem resposta derrubam a conexão
+#define KEEPALIVE_IDLE_S 10
+#define KEEPALIVE_INTERVAL_S 5
+#define KEEPALIVE_PROBES 3
+
+// Função para calcular tempo decorrido em segundos
+double get_elapsed_time(struct timespec *start, struct timespec *end) {
+    double start_sec = start->tv_sec + (start->tv_nsec / 1e9);
+    double end_sec = end->tv_sec + (end->tv_nsec / 1e9);
+    return end_sec - start_sec;
+}
+
+// --- Endereços e mensagens ---
+
+// Endereço no formato "unix:/caminho" ou "tcp:host:porta"
+typedef struct {
+    int family;
+    struct sockaddr_storage addr;
+    socklen_t len;
+} Endpoint;
+
+int parse_endpoint(const char *spec, int passive, Endpoint *ep) {
+    memset(ep, 0, sizeof(*ep));
+
+    if (strncmp(spec, "unix:", 5) == 0) {
+        struct sockaddr_un *un = (struct sockaddr_un *)&ep->addr;
+        if (strlen(spec + 5) >= sizeof(un->sun_path)) {
+            return -1;
+        }
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, spec + 5);
+        ep->family = AF_UNIX;
+        ep->len = sizeof(*un);
+        return 0;
+    }
+
+    if (strncmp(spec, "tcp:", 4) == 0) {
+        char host[256];
+        const char *colon = strrchr(spec + 4, ':');
+        if (!colon || (size_t)(colon - (spec + 4)) >= sizeof(host)) {
+            return -1;
+        }
+        memcpy(host, spec + 4, colon - (spec + 4));
+        host[colon - (spec + 4)] = '\0';
+
+        struct addrinfo hints = {0}, *res;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = passive ? AI_PASSIVE : 0;
+        if (getaddrinfo(host[0] ? host : NULL, colon + 1, &hints, &res) != 0) {
+            return -1;
+        }
+        memcpy(&ep->addr, res->ai_addr, res->ai_addrlen);
+        ep->len = res->ai_addrlen;
+        ep->family = res->ai_family;
+        freeaddrinfo(res);
+        return 0;
+    }
+
+    return -1;
+}
+
+int send_message(int fd, uint64_t type, uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
+    Message m = {htobe64(type), htobe64(a), htobe64(b), htobe64(c), htobe64(d)};
+    const char *p = (const char *)&m;
+    size_t left = PI_MSG_SIZE;
+
+    while (left > 0) {
+        ssize_t n = send(fd, p, left, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        left -= (size_t)n;
+    }
+    return 0;
+}
+
+void decode_message(const unsigned char *buf, Message *m) {
+    memcpy(m, buf, PI_MSG_SIZE);
+    m->type = be64toh(m->type);
+    m->a = be64toh(m->a);
+    m->b = be64toh(m->b);
+    m->c = be64toh(m->c);
+    m->d = be64toh(m->d);
+}
+
+// --- Worker ---
+
+// Lê uma mensagem completa (bloqueante); retorna -1 em erro ou conexão fechada
+int recv_message(int fd, Message *m) {
+    unsigned char buf[PI_MSG_SIZE];
+    size_t got = 0;
+
+    while (got < PI_MSG_SIZE) {
+        ssize_t n = recv(fd, buf + got, PI_MSG_SIZE - got, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        got += (size_t)n;
+    }
+    decode_message(buf, m);
+    return 0;
+}
+
+int run_worker(const char *address, const char *kernel_name, int fail_after) {
+    const PhiloxKernel *kernel = philox_select_kernel(kernel_name);
+    if (!kernel) {
+        fprintf(stderr, "Kernel \"%s\" desconhecido ou não suportado por esta CPU.\n", kernel_name);
+        return 1;
+    }
+
+    Endpoint ep;
+    if (parse_endpoint(address, 0, &ep) != 0) {
+        fprintf(stderr, "Endereço inválido: %s\n", address);
+        return 1;
+    }
+
+    int fd = socket(ep.family, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&ep.addr, ep.len) != 0) {
+        perror("Falha ao conectar ao coordenador");
+        return 1;
+    }
+    if (ep.family != AF_UNIX) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    if (send_message(fd, PI_MSG_HELLO, (uint64_t)getpid(), 0, 0, 0) != 0) {
+        perror("Falha ao enviar HELLO");
+        return 1;
+    }
+
+    Message m;
+    int done_batches = 0;
+    while (recv_message(fd, &m) == 0) {
+        if (m.type == PI_MSG_STOP) {
+            break;
+        }
+        if (m.type != PI_MSG_BATCH) {
+            continue;
+        }
+
+        // Simulação de falha para testar a redistribuição de lotes
+        if (fail_after > 0 && done_batches == fail_after) {
+            fprintf(stderr, "Worker %d: simulando falha após %d lotes.\n", (int)getpid(), done_batches);
+            _exit(2);
+        }
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        long long hits = philox_count_hits(kernel, m.b, m.c, m.d);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        uint64_t ns = (uint64_t)((t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec));
+        if (send_message(fd, PI_MSG_RESULT, m.a, (uint64_t)hits, ns, 0) != 0) {
+            break;
+        }
+        done_batches++;
+    }
+
+    close(fd);
+    return 0;
+}
+
+// --- Coordenador ---
+
+enum { BATCH_PENDING, BATCH_ASSIGNED, BATCH_DONE };
+
+typedef struct {
+    int fd;                     // -1 = slot livre
+    char name[96];
+    int hello;                  // Já se identificou
+    long long inflight[MAX_INFLIGHT];
+    int num_inflight;
+    unsigned char buf[PI_MSG_SIZE];
+    size_t buf_len;
+    struct timespec progress;   // Último resultado, ou quando recebeu lotes estando ocioso
+
+    // Contribuição
+    long long batches;
+    long long tosses;
+    long long hits;
+    double compute;             // Segundos de cálculo informados pelo worker
+    int lost;                   // Caiu antes do fim
+} WorkerConn;
+
+typedef struct {
+    uint64_t seed;
+    long long total_tosses;
+    long long batch_size;
+    long long num_batches;
+    unsigned char *state;       // BATCH_*
+    long long *requeue;         // Pilha de lotes devolvidos por workers que caíram
+    long long num_requeue;
+    long long next_batch;       // Próximo lote ainda não entregue a ninguém
+    long long done;
+    long long reassigned;
+    long long total_hits;
+    double batch_timeout;       // Segundos sem resultado até o worker ser dado como perdido
+    WorkerConn workers[MAX_WORKERS];
+    int num_workers;            // Slots já usados alguma vez (a vaga de quem caiu é reaproveitada)
+    int accepted;               // Conexões aceitas, para numerar os workers
+
+    // Contribuição somada dos workers que caíram e tiveram a vaga reaproveitada
+    int gone_workers;
+    long long gone_batches;
+    long long gone_tosses;
+} Coordinator;
+
+// Próximo lote a entregar, ou -1 se não houver
+long long take_batch(Coordinator *co) {
+    while (co->num_requeue > 0) {
+        long long b = co->requeue[--co->num_requeue];
+        if (co->state[b] == BATCH_PENDING) {
+            return b;
+        }
+    }
+    if (co->next_batch < co->num_batches) {
+        return co->next_batch++;
+    }
+    return -1;
+}
+
+// Mantém o worker com até MAX_INFLIGHT lotes
+void feed_worker(Coordinator *co, WorkerConn *w) {
+    while (w->fd >= 0 && w->hello && w->num_inflight < MAX_INFLIGHT) {
+        long long b = take_batch(co);
+        if (b < 0) {
+            return;
+        }
+        // O prazo corre a partir do primeiro lote pendente
+        if (w->num_inflight == 0) {
+            clock_gettime(CLOCK_MONOTONIC, &w->progress);
+        }
+
+        long long first = b * co->batch_size;
+        long long count = co->total_tosses - first;
+        if (count > co->batch_size) {
+            count = co->batch_size;
+        }
+
+        co->state[b] = BATCH_ASSIGNED;
+        w->inflight[w->num_inflight++] = b;
+        if (send_message(w->fd, PI_MSG_BATCH, (uint64_t)b, co->seed, (uint64_t)first, (uint64_t)count) != 0) {
+            return;     // A falha aparece no poll como erro/EOF e o lote é devolvido lá
+        }
+    }
+}
+
+// Worker caiu: fecha a conexão e devolve os lotes pendentes dele à fila
+void drop_worker(Coordinator *co, WorkerConn *w) {
+    for (int i = 0; i < w->num_inflight; ++i) {
+        long long b = w->inflight[i];
+        if (co->state[b] == BATCH_ASSIGNED) {
+            co->state[b] = BATCH_PENDING;
+            co->requeue[co->num_requeue++] = b;
+            co->reassigned++;
+        }
+    }
+    if (w->num_inflight > 0 || co->done < co->num_batches) {
+        fprintf(stderr, "Worker %s caiu; %d lote(s) devolvido(s) à fila.\n", w->name, w->num_inflight);
+        w->lost = 1;
+    }
+    w->num_inflight = 0;
+    close(w->fd);
+    w->fd = -1;
+}
+
+void handle_message(Coordinator *co, WorkerConn *w, const Message *m) {
+    if (m->type == PI_MSG_HELLO) {
+        size_t len = strlen(w->name);
+        snprintf(w->name + len, sizeof(w->name) - len, " pid %llu", (unsigned long long)m->a);
+        w->hello = 1;
+        return;
+    }
+    if (m->type != PI_MSG_RESULT) {
+        return;
+    }
+
+    long long b = (long long)m->a;
+    int found = -1;
+    for (int i = 0; i < w->num_inflight; ++i) {
+        if (w->inflight[i] == b) {
+            found = i;
+        }
+    }
+    if (found < 0 || b >= co->num_batches || co->state[b] != BATCH_ASSIGNED) {
+        return;     // Resultado inesperado ou duplicado
+    }
+
+    w->inflight[found] = w->inflight[--w->num_inflight];
+    clock_gettime(CLOCK_MONOTONIC, &w->progress);
+    co->state[b] = BATCH_DONE;
+    co->done++;
+    co->total_hits += (long long)m->b;
+
+    long long count = co->total_tosses - b * co->batch_size;
+    if (count > co->batch_size) {
+        count = co->batch_size;
+    }
+    w->batches++;
+    w->tosses += count;
+    w->hits += (long long)m->b;
+    w->compute += (double)m->c / 1e9;
+}
+
+// Lê o que houver no socket e processa as mensagens completas; -1 se a conexão caiu
+int read_worker(Coordinator *co, WorkerConn *w) {
+    ssize_t n = recv(w->fd, w->buf + w->buf_len, PI_MSG_SIZE - w->buf_len, 0);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+        return 0;
+    }
+    if (n <= 0) {
+        return -1;
+    }
+
+    w->buf_len += (size_t)n;
+    if (w->buf_len == PI_MSG_SIZE) {
+        Message m;
+        decode_message(w->buf, &m);
+        w->buf_len = 0;
+        handle_message(co, w, &m);
+    }
+    return 0;
+}
+
+int open_listener(const Endpoint *ep) {
+    int fd = socket(ep->family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (ep->family == AF_UNIX) {
+        unlink(((const struct sockaddr_un *)&ep->addr)->sun_path);
+    }
+
+    if (bind(fd, (const struct sockaddr *)&ep->addr, ep->len) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Ativa o keepalive do TCP com intervalos curtos (o padrão do Linux leva horas)
+void enable_keepalive(int fd) {
+    int one = 1, idle = KEEPALIVE_IDLE_S, interval = KEEPALIVE_INTERVAL_S, probes = KEEPALIVE_PROBES;
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes));
+}
+
+void accept_worker(Coordinator *co, int listen_fd, int is_tcp) {
+    struct sockaddr_storage peer;
+    socklen_t peer_len = sizeof(peer);
+    int fd = accept(listen_fd, (struct sockaddr *)&peer, &peer_len);
+    if (fd < 0) {
+        return;
+    }
+
+    // Vaga de um worker que caiu, ou uma nunca usada
+    int slot = -1;
+    for (int i = 0; i < co->num_workers && slot < 0; ++i) {
+        if (co->workers[i].fd < 0) {
+            slot = i;
+        }
+    }
+    if (slot < 0 && co->num_workers < MAX_WORKERS) {
+        slot = co->num_workers++;
+    }
+    if (slot < 0) {
+        fprintf(stderr, "Limite de %d workers conectados atingido; conexão recusada.\n", MAX_WORKERS);
+        close(fd);
+        return;
+    }
+
+    WorkerConn *w = &co->workers[slot];
+    if (w->batches > 0 || w->lost) {
+        co->gone_workers++;
+        co->gone_batches += w->batches;
+        co->gone_tosses += w->tosses;
+    }
+    memset(w, 0, sizeof(*w));
+    w->fd = fd;
+
+    int id = co->accepted++;
+    if (is_tcp) {
+        int one = 1;
+        char host[64] = "?";
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        enable_keepalive(fd);
+        getnameinfo((struct sockaddr *)&peer, peer_len, host, sizeof(host), NULL, 0, NI_NUMERICHOST);
+        snprintf(w->name, sizeof(w->name), "#%d %s", id, host);
+    } else {
+        snprintf(w->name, sizeof(w->name), "#%d local", id);
+    }
+}
+
+// Inicia um worker local como processo filho (mesmo executável)
+pid_t spawn_local_worker(const char *address, const char *kernel_name, int fail_after) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    char fail_arg[32];
+    snprintf(fail_arg, sizeof(fail_arg), "%d", fail_after);
+    if (kernel_name) {
+        execl("/proc/self/exe", "distributed_pi", "worker", "-k", kernel_name, "-f", fail_arg, address, (char *)NULL);
+    } else {
+        execl("/proc/self/exe", "distributed_pi", "worker", "-f", fail_arg, address, (char *)NULL);
+    }
+    perror("execl falhou");
+    _exit(127);
+}
+
+int run_coordinator(const char *address, int local_workers, long long total_tosses, long long batch_size,
+                    uint64_t seed, const char *kernel_name, int fail_after, double batch_timeout) {
+    Endpoint ep;
+    if (parse_endpoint(address, 1, &ep) != 0) {
+        fprintf(stderr, "Endereço inválido: %s\n", address);
+        return 1;
+    }
+
+    int listen_fd = open_listener(&ep);
+    if (listen_fd < 0) {
+        perror("Falha ao abrir o socket do coordenador");
+        return 1;
+    }
+
+    Coordinator *co = calloc(1, sizeof(Coordinator));
+    if (!co) {
+        perror("Erro de alocação");
+        close(listen_fd);
+        return 1;
+    }
+    co->seed = seed;
+    co->total_tosses = total_tosses;
+    co->batch_size = batch_size;
+    co->batch_timeout = batch_timeout;
+    co->num_batches = (total_tosses + batch_size - 1) / batch_size;
+    co->state = calloc((size_t)co->num_batches, 1);
+    co->requeue = malloc((size_t)co->num_batches * sizeof(long long));
+    if (!co->state || !co->requeue) {
+        perror("Erro de alocação");
+        free(co->state);
+        free(co->requeue);
+        free(co);
+        close(listen_fd);
+        return 1;
+    }
+
+    printf("Coordenador em %s: %lld lançamentos em %lld lotes de até %lld (semente %llu)\n",
+           address, total_tosses, co->num_batches, batch_size, (unsigned long long)seed);
+
+    pid_t children[MAX_WORKERS];
+    int num_children = 0;
+    for (int i = 0; i < local_workers && i < MAX_WORKERS; ++i) {
+        // Só o primeiro worker local recebe a falha simulada
+        pid_t pid = spawn_local_worker(address, kernel_name, i == 0 ? fail_after : 0);
+        if (pid > 0) {
+            children[num_children++] = pid;
+        }
+    }
+
+    struct timespec start_time, end_time, last_worker_seen;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    last_worker_seen = start_time;
+    int is_tcp = ep.family != AF_UNIX;
+    int status = 0;
+
+    struct pollfd fds[MAX_WORKERS + 1];
+    int owner[MAX_WORKERS + 1];
+
+    while (co->done < co->num_batches) {
+        int nfds = 0;
+        fds[nfds].fd = listen_fd;
+        fds[nfds].events = POLLIN;
+        owner[nfds++] = -1;
+
+        // Quem estourou o prazo com lotes pendentes é dado como perdido antes de redistribuir
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        for (int i = 0; i < co->num_workers; ++i) {
+            WorkerConn *w = &co->workers[i];
+            if (w->fd >= 0 && w->num_inflight > 0 && get_elapsed_time(&w->progress, &now) > co->batch_timeout) {
+                fprintf(stderr, "Worker %s sem resultado há %.0f segundos.\n", w->name, co->batch_timeout);
+                drop_worker(co, w);
+            }
+        }
+
+        int connected = 0;
+        for (int i = 0; i < co->num_workers; ++i) {
+            if (co->workers[i].fd >= 0) {
+                feed_worker(co, &co->workers[i]);
+                fds[nfds].fd = co->workers[i].fd;
+                fds[nfds].events = POLLIN;
+                owner[nfds++] = i;
+                connected++;
+            }
+        }
+
+        if (connected > 0) {
+            last_worker_seen = now;
+        } else if (get_elapsed_time(&last_worker_seen, &now) > NO_WORKER_TIMEOUT_S) {
+            fprintf(stderr, "Nenhum worker conectado há %d segundos; abortando.\n", NO_WORKER_TIMEOUT_S);
+            status = 1;
+            break;
+        }
+
+        int timeout_ms = co->batch_timeout < 1.0 ? (int)(co->batch_timeout * 1000.0) + 1 : 1000;
+        if (poll(fds, nfds, timeout_ms) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll falhou");
+            status = 1;
+            break;
+        }
+
+        for (int i = 0; i < nfds; ++i) {
+            if (!fds[i].revents) {
+                continue;
+            }
+            if (owner[i] < 0) {
+                accept_worker(co, listen_fd, is_tcp);
+                continue;
+            }
+            WorkerConn *w = &co->workers[owner[i]];
+            if (read_worker(co, w) != 0) {
+                drop_worker(co, w);
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    // Encerra os workers e recolhe os processos locais
+    for (int i = 0; i < co->num_workers; ++i) {
+        if (co->workers[i].fd >= 0) {
+            send_message(co->workers[i].fd, PI_MSG_STOP, 0, 0, 0, 0);
+            close(co->workers[i].fd);
+        }
+    }
+    for (int i = 0; i < num_children; ++i) {
+        waitpid(children[i], NULL, 0);
+    }
+    close(listen_fd);
+    if (ep.family == AF_UNIX) {
+        unlink(((struct sockaddr_un *)&ep.addr)->sun_path);
+    }
+
+    if (status == 0) {
+        double elapsed = get_elapsed_time(&start_time, &end_time);
+        double pi_estimate = 4.0 * (double)co->total_hits / (double)total_tosses;
+
+        printf("\nResultados Finais:\n");
+        printf("Total de pontos gerados (N_total): %lld\n", total_tosses);
+        printf("Pontos dentro do quarto de círculo (N_inside): %lld\n", co->total_hits);
+        printf("Estimativa de Pi ≈ 4 * (N_inside / N_total): %f\n", pi_estimate);
+        printf("Tempo decorrido: %f segundos\n", elapsed);
+        printf("Vazão agregada: %.0f lançamentos/s\n", (double)total_tosses / elapsed);
+        printf("Lotes redistribuídos após falhas: %lld\n", co->reassigned);
+
+        printf("\nContribuição por worker:\n");
+        for (int i = 0; i < co->num_workers; ++i) {
+            WorkerConn *w = &co->workers[i];
+            printf("Worker %s: %lld lotes, %lld lançamentos (%.1f%%), %.0f lançamentos/s de cálculo%s\n",
+                   w->name, w->batches, w->tosses, 100.0 * (double)w->tosses / (double)total_tosses,
+                   w->compute > 0.0 ? (double)w->tosses / w->compute : 0.0,
+                   w->lost ? " [caiu]" : "");
+        }
+        if (co->gone_workers > 0) {
+            printf("%d worker(s) que caíram e cederam a vaga: %lld lotes, %lld lançamentos (%.1f%%)\n",
+                   co->gone_workers, co->gone_batches, co->gone_tosses,
+                   100.0 * (double)co->gone_tosses / (double)total_tosses);
+        }
+    }
+
+    free(co->state);
+    free(co->requeue);
+    free(co);
+    return status;
+}
+
+// --- Linha de comando ---
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Uso:\n");
+    fprintf(stderr, "  %s coordenador [-a endereço] [-l workers locais] [-b lote] [-s semente] [-k kernel] [-f lotes]"
+                    " [-t segundos] <numero total de lançamentos>\n", prog);
+    fprintf(stderr, "  %s worker [-k kernel] [-f lotes] <endereço>\n", prog);
+    fprintf(stderr, "  endereço    unix:/caminho ou tcp:host:porta (padrão: unix:/tmp/distributed_pi.<pid>.sock)\n");
+    fprintf(stderr, "  -l n        inicia n workers locais como processos filhos\n");
+    fprintf(stderr, "  -b lote     lançamentos por lote (padrão: %lld)\n", DEFAULT_BATCH_SIZE);
+    fprintf(stderr, "  -f lotes    simula a queda do worker após esse número de lotes\n"
+                    "              (no coordenador, aplica-se ao primeiro worker local)\n");
+    fprintf(stderr, "  -t seg      prazo para um worker com lotes pendentes entregar o próximo resultado;\n"
+                    "              depois dele o worker é desligado e os lotes voltam à fila (padrão: %d)\n",
+            DEFAULT_BATCH_TIMEOUT_S);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const char *mode = argv[1];
+    char default_address[108];
+    const char *address = NULL;
+    const char *kernel_name = NULL;
+    int local_workers = 0;
+    int fail_after = 0;
+    long long batch_size = DEFAULT_BATCH_SIZE;
+    double batch_timeout = DEFAULT_BATCH_TIMEOUT_S;
+    uint64_t seed = (uint64_t)time(NULL);
+    int opt;
+
+    // getopt a partir do subcomando
+    optind = 2;
+    while ((opt = getopt(argc, argv, "a:l:b:s:k:f:t:")) != -1) {
+        switch (opt) {
+        case 'a': address = optarg; break;
+        case 'l': local_workers = atoi(optarg); break;
+        case 'b': batch_size = strtoll(optarg, NULL, 10); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'k': kernel_name = optarg; break;
+        case 'f': fail_after = atoi(optarg); break;
+        case 't': batch_timeout = strtod(optarg, NULL); break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (strcmp(mode, "worker") == 0) {
+        if (argc - optind != 1) {
+            usage(argv[0]);
+            return 1;
+        }
+        return run_worker(argv[optind], kernel_name, fail_after);
+    }
+
+    if (strcmp(mode, "coordenador") != 0 || argc - optind != 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    long long total_tosses = strtoll(argv[optind], NULL, 10);
+    if (total_tosses <= 0 || batch_size <= 0 || local_workers < 0 || batch_timeout <= 0.0) {
+        fprintf(stderr, "Lançamentos, lote, workers locais e prazo devem ser positivos.\n");
+        return 1;
+    }
+
+    if (!address) {
+        snprintf(default_address, sizeof(default_address), "unix:/tmp/distributed_pi.%d.sock", (int)getpid());
+        address = default_address;
+    }
+
+    return run_coordinator(address, local_workers, total_tosses, batch_size, seed, kernel_name, fail_after,
+                           batch_timeout);
+}
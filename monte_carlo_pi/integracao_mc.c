@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "mc_engine.h"
+
+// Integrandos de exemplo, especializados em tempo de compilação pelo motor
+
+// Pi: quatro vezes a área do quarto de círculo em [0, 1]^2 (o exemplo original)
+MC_DEFINE_INTEGRAND(pi, 2, (x[0] * x[0] + x[1] * x[1] <= 1.0) ? 4.0 : 0.0);
+
+// Gaussiana em [0, 1]^5: (sqrt(pi) / 2 * erf(1))^5
+MC_DEFINE_INTEGRAND(gauss5, 5,
+    exp(-(x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3] + x[4] * x[4])));
+
+// Volume da bola unitária em [-1, 1]^3: 4 * pi / 3
+MC_DEFINE_INTEGRAND(esfera3, 3, (x[0] * x[0] + x[1] * x[1] + x[2] * x[2] <= 1.0) ? 1.0 : 0.0);
+
+// Produto de senos em [0, pi]^4: 2^4
+MC_DEFINE_INTEGRAND(senos4, 4, sin(x[0]) * sin(x[1]) * sin(x[2]) * sin(x[3]));
+
+typedef struct {
+    const McIntegrand *integrand;
+    double lo, hi;              // Mesmo intervalo em todas as dimensões
+    double exact;
+} Example;
+
+static void usage(const char *prog, const Example *examples, int num_examples) {
+    fprintf(stderr, "Uso: %s [-s semente] [-e estratos] <exemplo> <numero de threads> <numero de amostras>\n", prog);
+    fprintf(stderr, "  -e estratos  amostragem estratificada ao longo da dimensão 0 (padrão: sem estratos)\n");
+    fprintf(stderr, "Exemplos:");
+    for (int i = 0; i < num_examples; ++i) {
+        fprintf(stderr, " %s", examples[i].integrand->name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[]) {
+    const Example examples[] = {
+        {&pi, 0.0, 1.0, M_PI},
+        {&gauss5, 0.0, 1.0, pow(sqrt(M_PI) / 2.0 * erf(1.0), 5)},
+        {&esfera3, -1.0, 1.0, 4.0 * M_PI / 3.0},
+        {&senos4, 0.0, M_PI, 16.0},
+    };
+    int num_examples = sizeof(examples) / sizeof(examples[0]);
+
+    McOptions opts = {.seed = (uint64_t)time(NULL), .strata = 1};
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:e:")) != -1) {
+        switch (opt) {
+        case 's':
+            opts.seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'e':
+            opts.strata = atoi(optarg);
+            if (opts.strata <= 0) {
+                fprintf(stderr, "O número de estratos deve ser positivo.\n");
+                return 1;
+            }
+            break;
+        default:
+            usage(argv[0], examples, num_examples);
+            return 1;
+        }
+    }
+
+    if (argc - optind != 3) {
+        usage(argv[0], examples, num_examples);
+        return 1;
+    }
+
+    const Example *example = NULL;
+    for (int i = 0; i < num_examples; ++i) {
+        if (strcmp(argv[optind], examples[i].integrand->name) == 0) {
+            example = &examples[i];
+        }
+    }
+    if (!example) {
+        usage(argv[0], examples, num_examples);
+        return 1;
+    }
+
+    opts.num_threads = atoi(argv[optind + 1]);
+    opts.samples = strtoll(argv[optind + 2], NULL, 10);
+    if (opts.num_threads <= 0 || opts.samples <= 0) {
+        fprintf(stderr, "Número de threads e amostras devem ser positivos.\n");
+        return 1;
+    }
+
+    McBox box = {.dim = example->integrand->dim};
+    for (int d = 0; d < box.dim; ++d) {
+        box.lo[d] = example->lo;
+        box.hi[d] = example->hi;
+    }
+
+    printf("Integrando \"%s\" (%d dimensões) com %d threads, %lld amostras, %d estrato(s), semente %llu...\n",
+           example->integrand->name, box.dim, opts.num_threads, opts.samples, opts.strata,
+           (unsigned long long)opts.seed);
+
+    McResult res;
+    int ret = mc_integrate(example->integrand, &box, &opts, &res);
+    if (ret != 0) {
+        errno = ret;
+        perror("mc_integrate falhou");
+        return 1;
+    }
+
+    printf("\nResultados:\n");
+    printf("Estimativa: %.10f\n", res.estimate);
+    printf("Valor exato: %.10f\n", example->exact);
+    printf("Erro empírico: %g\n", fabs(res.estimate - example->exact));
+    printf("Variância do estimador: %g\n", res.variance);
+    printf("Erro padrão: %g\n", res.std_error);
+    printf("Tempo de amostragem: %f segundos\n", res.elapsed);
+    printf("Amostras por segundo: %.0f\n", res.samples / res.elapsed);
+    // Figura de mérito: quanto menor variância * núcleo-segundos, melhor
+    printf("Eficiência 1 / (variância * núcleo-segundos): %g\n",
+           1.0 / (res.variance * res.elapsed * opts.num_threads));
+
+    return 0;
+}
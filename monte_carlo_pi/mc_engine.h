@@ -0,0 +1,288 @@
+#ifndef MC_ENGINE_H
+#define MC_ENGINE_H
+
+// Motor paralelo de integração Monte Carlo sobre caixas N-dimensionais.
+//
+// Reaproveita a estrutura do parallel_pi (divisão justa das amostras entre
+// threads, gerador Philox baseado em contador e medição com CLOCK_MONOTONIC),
+// mas o teste do quarto de círculo vira um integrando qualquer.
+//
+// O integrando é especializado em tempo de compilação: MC_DEFINE_INTEGRAND gera
+// um kernel com a expressão expandida dentro do laço de amostragem, e o motor
+// só chama esse kernel uma vez por fatia de amostras (nunca por amostra).
+//
+//     MC_DEFINE_INTEGRAND(gauss2, 2, exp(-(x[0] * x[0] + x[1] * x[1])))
+//     ...
+//     mc_integrate(&gauss2, &box, &opts, &res);
+//
+// Com opts.strata > 1 a caixa é dividida em estratos iguais ao longo da
+// dimensão 0, cada um com a sua cota de amostras (amostragem estratificada).
+// As threads recebem intervalos contíguos de amostras que podem atravessar
+// estratos, então qualquer número de estratos funciona com qualquer número de
+// threads. Como no parallel_pi, a amostra i depende só de (semente, i): o
+// conjunto de amostras é o mesmo para qualquer número de threads, e a
+// estimativa só muda pelo arredondamento da ordem das somas.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+
+#include "philox.h"
+
+// Maior dimensão suportada
+#define MC_MAX_DIM 32
+
+// Fluxo Philox (palavra 3 do contador) reservado às coordenadas do motor
+#define MC_ENGINE_STREAM 0x4D43u
+
+// Caixa de integração [lo[d], hi[d]) em cada dimensão
+typedef struct {
+    int dim;
+    double lo[MC_MAX_DIM];
+    double hi[MC_MAX_DIM];
+} McBox;
+
+// Fatia de amostras entregue a um kernel: amostras globais [first, first + count)
+// dentro da sub-caixa de origem lo e largura width (um estrato ou a caixa toda)
+typedef struct {
+    uint64_t seed;
+    uint64_t first;
+    uint64_t count;
+    const double *lo;
+    const double *width;
+} McSlice;
+
+// Somas acumuladas de f e f^2
+typedef struct {
+    double sum;
+    double sum_sq;
+} McAccum;
+
+typedef void (*mc_kernel_fn)(const McSlice *slice, McAccum *acc);
+
+typedef struct {
+    const char *name;
+    int dim;
+    mc_kernel_fn kernel;
+} McIntegrand;
+
+typedef struct {
+    int num_threads;
+    long long samples;
+    uint64_t seed;
+    int strata;             // <= 1 = sem estratificação
+} McOptions;
+
+typedef struct {
+    double estimate;
+    double variance;        // Variância estimada do estimador
+    double std_error;
+    long long samples;
+    double elapsed;         // Segundos de amostragem (criação das threads até o último join)
+} McResult;
+
+// Converte duas palavras de 32 bits em um double uniforme em [0, 1) com 53 bits
+static inline double mc_uniform53(uint32_t hi, uint32_t lo) {
+    uint64_t bits = ((uint64_t)hi << 21) ^ (lo >> 11);
+    return (double)bits * 0x1.0p-53;
+}
+
+// Coordenadas da amostra global `index`: cada bloco Philox rende 2 coordenadas
+static inline void mc_sample_point(uint64_t seed, uint64_t index, int dim,
+                                   const double *lo, const double *width, double *x) {
+    uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    uint32_t w[4];
+
+    for (int d = 0; d < dim; d += 2) {
+        uint32_t ctr[4] = {(uint32_t)index, (uint32_t)(index >> 32), (uint32_t)(d / 2), MC_ENGINE_STREAM};
+        philox4x32_10(ctr, key, w);
+        x[d] = lo[d] + width[d] * mc_uniform53(w[0], w[1]);
+        if (d + 1 < dim) {
+            x[d + 1] = lo[d + 1] + width[d + 1] * mc_uniform53(w[2], w[3]);
+        }
+    }
+}
+
+// Define `name` (um McIntegrand) cujo kernel avalia `expr` em cada ponto x[0..DIM-1]
+#define MC_DEFINE_INTEGRAND(name, DIM, expr)                                        \
+    static void name##_kernel(const McSlice *slice, McAccum *acc) {                 \
+        double x[DIM];                                                              \
+        double sum = 0.0, sum_sq = 0.0;                                             \
+        for (uint64_t i = slice->first; i < slice->first + slice->count; ++i) {     \
+            mc_sample_point(slice->seed, i, DIM, slice->lo, slice->width, x);       \
+            double fx = (expr);                                                     \
+            sum += fx;                                                              \
+            sum_sq += fx * fx;                                                      \
+        }                                                                           \
+        acc->sum += sum;                                                            \
+        acc->sum_sq += sum_sq;                                                      \
+    }                                                                               \
+    static const McIntegrand name = {#name, DIM, name##_kernel}
+
+// Argumentos de cada thread do motor
+typedef struct {
+    const McIntegrand *integrand;
+    const McBox *box;
+    uint64_t seed;
+    int strata;
+    long long samples;          // Total de amostras (para localizar os estratos)
+    long long first;            // Primeira amostra global da thread
+    long long count;
+    McAccum *acc;               // Um acumulador por estrato
+} McThreadArgs;
+
+// Primeira amostra global do estrato k (as amostras são divididas de forma justa)
+static inline long long mc_stratum_start(long long samples, int strata, int k) {
+    long long base = samples / strata;
+    long long remainder = samples % strata;
+    return (long long)k * base + (k < remainder ? k : remainder);
+}
+
+// Estrato que contém a amostra global i (inversa de mc_stratum_start)
+static inline int mc_stratum_of(long long samples, int strata, long long i) {
+    long long base = samples / strata;
+    long long remainder = samples % strata;
+    if (i < remainder * (base + 1)) {
+        return (int)(i / (base + 1));
+    }
+    return (int)(remainder + (i - remainder * (base + 1)) / base);
+}
+
+static void *mc_engine_thread(void *arg) {
+    McThreadArgs *a = (McThreadArgs *)arg;
+    const McBox *box = a->box;
+    double lo[MC_MAX_DIM], width[MC_MAX_DIM];
+
+    for (int d = 0; d < box->dim; ++d) {
+        lo[d] = box->lo[d];
+        width[d] = box->hi[d] - box->lo[d];
+    }
+
+    double stratum_width = width[0] / a->strata;
+    long long i = a->first;
+    long long end = a->first + a->count;
+
+    // Percorre os estratos que intersectam [first, first + count)
+    while (i < end) {
+        int k = mc_stratum_of(a->samples, a->strata, i);
+        long long stratum_end = k + 1 < a->strata ? mc_stratum_start(a->samples, a->strata, k + 1)
+                                                  : a->samples;
+        if (stratum_end > end) {
+            stratum_end = end;
+        }
+
+        lo[0] = box->lo[0] + k * stratum_width;
+        width[0] = stratum_width;
+
+        McSlice slice = {a->seed, (uint64_t)i, (uint64_t)(stratum_end - i), lo, width};
+        a->integrand->kernel(&slice, &a->acc[k]);
+        i = stratum_end;
+    }
+    return NULL;
+}
+
+static inline double mc_elapsed(const struct timespec *start, const struct timespec *end) {
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Integra o integrando sobre a caixa. Retorna 0 ou um código de erro (errno).
+static inline int mc_integrate(const McIntegrand *integrand, const McBox *box,
+                               const McOptions *opts, McResult *res) {
+    int num_threads = opts->num_threads;
+    int strata = opts->strata > 1 ? opts->strata : 1;
+    long long samples = opts->samples;
+
+    if (box->dim != integrand->dim || box->dim > MC_MAX_DIM || num_threads <= 0 || samples < 2 * (long long)strata) {
+        return EINVAL;
+    }
+
+    pthread_t *handles = malloc(num_threads * sizeof(pthread_t));
+    McThreadArgs *args = malloc(num_threads * sizeof(McThreadArgs));
+    McAccum *acc = calloc((size_t)num_threads * strata, sizeof(McAccum));
+
+    if (!handles || !args || !acc) {
+        free(handles);
+        free(args);
+        free(acc);
+        return ENOMEM;
+    }
+
+    // Distribuição justa das amostras entre threads
+    long long base = samples / num_threads;
+    long long remainder = samples % num_threads;
+    long long next = 0;
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int t = 0; t < num_threads; ++t) {
+        args[t].integrand = integrand;
+        args[t].box = box;
+        args[t].seed = opts->seed;
+        args[t].strata = strata;
+        args[t].samples = samples;
+        args[t].first = next;
+        args[t].count = base + (t < remainder ? 1 : 0);
+        args[t].acc = &acc[(size_t)t * strata];
+        next += args[t].count;
+
+        int ret = pthread_create(&handles[t], NULL, mc_engine_thread, &args[t]);
+        if (ret != 0) {
+            for (int j = 0; j < t; ++j) {
+                pthread_join(handles[j], NULL);
+            }
+            free(handles);
+            free(args);
+            free(acc);
+            return ret;
+        }
+    }
+
+    for (int t = 0; t < num_threads; ++t) {
+        pthread_join(handles[t], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    // Combina os estratos: I = soma vol_k * média_k, Var = soma vol_k^2 * var_k / n_k
+    double volume = 1.0;
+    for (int d = 0; d < box->dim; ++d) {
+        volume *= box->hi[d] - box->lo[d];
+    }
+    double stratum_volume = volume / strata;
+
+    res->estimate = 0.0;
+    res->variance = 0.0;
+    for (int k = 0; k < strata; ++k) {
+        McAccum total = {0.0, 0.0};
+        for (int t = 0; t < num_threads; ++t) {
+            total.sum += acc[(size_t)t * strata + k].sum;
+            total.sum_sq += acc[(size_t)t * strata + k].sum_sq;
+        }
+
+        long long n = (k + 1 < strata ? mc_stratum_start(samples, strata, k + 1) : samples)
+                      - mc_stratum_start(samples, strata, k);
+        double mean = total.sum / n;
+        double var_f = (total.sum_sq - total.sum * mean) / (n - 1);
+        if (var_f < 0.0) {
+            var_f = 0.0;
+        }
+
+        res->estimate += stratum_volume * mean;
+        res->variance += stratum_volume * stratum_volume * var_f / n;
+    }
+
+    res->std_error = sqrt(res->variance);
+    res->samples = samples;
+    res->elapsed = mc_elapsed(&start_time, &end_time);
+
+    free(handles);
+    free(args);
+    free(acc);
+    return 0;
+}
+
+#endif // MC_ENGINE_H
@@ -1,15 +1,168 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <time.h>
 #include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <math.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "philox.h"
+#include "thread_pool.h"
+#include "sobol.h"
+#include "checkpoint.h"
+#include "../common/affinity.h"
+#include "../common/trace.h"
+
+// Tamanho padrão do lote retirado por cada thread no modo adaptativo
+#define DEFAULT_BATCH_SIZE (1LL << 18)
+
+// Intervalo entre verificações do coordenador no modo adaptativo
+#define POLL_INTERVAL_NS 1000000L
+
+// Intervalo padrão entre relatórios no modo contínuo (segundos) e fatia de espera do relator
+#define DEFAULT_REPORT_INTERVAL 10.0
+#define REPORTER_SLICE_NS 50000000L
+
+// Sinalizado por SIGINT/SIGTERM; no modo contínuo vira um checkpoint e uma parada limpa
+static volatile sig_atomic_t interrupted = 0;
+
+// Contadores publicados por cada thread no modo adaptativo.
+// Cada um ocupa sua própria linha de cache para evitar falso compartilhamento.
+typedef struct {
+    _Alignas(64) atomic_llong hits;
+    atomic_llong tosses;
+} PaddedCounter;
+
+// Estado compartilhado entre o coordenador e as threads no modo adaptativo
+typedef struct {
+    atomic_llong next_batch;        // Próximo lote a ser retirado
+    atomic_int stop;                // Sinalizado pelo coordenador quando a precisão é atingida
+    atomic_int active_threads;      // Threads que ainda não terminaram
+    long long batch_size;
+    long long max_tosses;           // Orçamento máximo de lançamentos
+} AdaptiveShared;
+
+// Opções e estado do modo contínuo
+typedef struct {
+    double interval;                // Segundos entre relatórios de progresso
+    const char *checkpoint_path;    // NULL = sem checkpoint
+    StreamSlot **slots;             // Um fluxo por thread, em página própria no nó da thread
+    int num_streams;
+    atomic_int stop;                // Parada pedida por sinal
+    atomic_int active_threads;
+    uint64_t seed;
+    long long total_tosses;
+    long long resumed_tosses;       // Já sorteados antes desta sessão
+    int checkpoint_saved;           // O checkpoint final foi gravado
+} StreamShared;
 
 // Estrutura usada para passar argumentos à thread
 typedef struct {
+    long long first_toss;           // Índice global do primeiro lançamento da thread
     long long tosses;
+    uint64_t seed;
+    const PhiloxKernel *kernel;
     long long *result;
+    AdaptiveShared *shared;         // Apenas no modo adaptativo
+    PaddedCounter *counter;         // Apenas no modo adaptativo
+    double busy;                    // Segundos gastos amostrando
+    int replicas;                   // Apenas no modo quase-Monte Carlo
+    long long *replica_hits;        // Acertos por réplica (apenas no modo quase-Monte Carlo)
+    StreamShared *stream;           // Apenas no modo contínuo
+    StreamSlot *slot;               // Apenas no modo contínuo
+    long long batch_size;           // Apenas no modo contínuo
 } ThreadArgs;
 
+// Configuração de uma execução
+typedef struct {
+    int num_threads;
+    long long total_tosses;
+    uint64_t seed;
+    const PhiloxKernel *kernel;
+    long long batch_size;           // Lote do modo adaptativo / bloco do pool
+    double target_error;            // 0 = orçamento fixo
+    double z;
+    int qmc_replicas;               // 0 = pseudoaleatório; > 0 = Sobol com essa quantidade de réplicas
+    const AffinityPlan *plan;       // CPU e nó NUMA de cada thread
+} RunConfig;
+
+// Resultado de uma execução
+typedef struct {
+    long long hits;
+    long long tosses;
+    double elapsed;
+    double pi_estimate;
+    double std_error;               // Erro padrão estimado de pi_estimate
+} RunResult;
+
+// Trabalho entregue ao pool: cada bloco é um intervalo de lançamentos
+typedef struct {
+    const RunConfig *cfg;
+    PaddedCounter **counters;       // Acertos por worker
+} PoolJob;
+
+// Aloca um contador por thread, cada um em página própria no nó NUMA da CPU da
+// sua thread (a thread é a única escritora; o coordenador só lê)
+PaddedCounter **alloc_counters(int num_threads, const AffinityPlan *plan) {
+    PaddedCounter **counters = calloc(num_threads, sizeof(PaddedCounter *));
+    for (int i = 0; counters && i < num_threads; ++i) {
+        counters[i] = affinity_alloc_local(sizeof(PaddedCounter), affinity_node_of(plan, i));
+        if (!counters[i]) {
+            for (int j = 0; j < i; ++j) {
+                affinity_free_local(counters[j], sizeof(PaddedCounter));
+            }
+            free(counters);
+            return NULL;
+        }
+    }
+    return counters;
+}
+
+void free_counters(PaddedCounter **counters, int num_threads) {
+    if (!counters) {
+        return;
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        affinity_free_local(counters[i], sizeof(PaddedCounter));
+    }
+    free(counters);
+}
+
+// Copia os fluxos iniciais (novos ou lidos do checkpoint) para páginas próprias,
+// cada uma no nó NUMA da thread que vai publicar nela
+StreamSlot **alloc_stream_slots(StreamSlot *initial, int num_streams, const AffinityPlan *plan) {
+    StreamSlot **slots = calloc(num_streams, sizeof(StreamSlot *));
+    for (int i = 0; slots && i < num_streams; ++i) {
+        slots[i] = affinity_alloc_local(sizeof(StreamSlot), affinity_node_of(plan, i));
+        if (!slots[i]) {
+            for (int j = 0; j < i; ++j) {
+                affinity_free_local(slots[j], sizeof(StreamSlot));
+            }
+            free(slots);
+            return NULL;
+        }
+        long long pos, hits;
+        stream_snapshot(&initial[i], &pos, &hits);
+        stream_init(slots[i], initial[i].first, pos, initial[i].end, hits);
+    }
+    return slots;
+}
+
+void free_stream_slots(StreamSlot **slots, int num_streams) {
+    if (!slots) {
+        return;
+    }
+    for (int i = 0; i < num_streams; ++i) {
+        affinity_free_local(slots[i], sizeof(StreamSlot));
+    }
+    free(slots);
+}
+
 // Função para calcular tempo decorrido em segundos
 double get_elapsed_time(struct timespec *start, struct timespec *end) {
     double start_sec = start->tv_sec + (start->tv_nsec / 1e9);
@@ -20,109 +173,1020 @@ double get_elapsed_time(struct timespec *start, struct timespec *end) {
 // Função executada por cada thread
 void* monte_carlo_thread(void* arg) {
     ThreadArgs *args = (ThreadArgs *)arg;
-    long long tosses = args->tosses;
+    struct timespec t0, t1;
+    TraceSpan span;
+    trace_thread_begin("amostragem");
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    trace_begin(&span);
+
+    // Cada lançamento depende só de (semente, índice global), então a soma
+    // é a mesma para qualquer número de threads
+    long long local_in_circle = philox_count_hits(args->kernel, args->seed,
+                                                  (uint64_t)args->first_toss,
+                                                  (uint64_t)args->tosses);
+
+    trace_end(&span, "philox_count_hits");
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    trace_thread_end();
+    args->busy = get_elapsed_time(&t0, &t1);
+    *(args->result) = local_in_circle;
+    return NULL;
+}
+
+// Função executada por cada thread no modo adaptativo: retira lotes de tamanho
+// fixo até o coordenador sinalizar parada ou o orçamento acabar
+void* monte_carlo_adaptive_thread(void* arg) {
+    ThreadArgs *args = (ThreadArgs *)arg;
+    AdaptiveShared *shared = args->shared;
     long long local_in_circle = 0;
-    double x, y;
+    long long local_tosses = 0;
+    struct timespec t0, t1;
+    TraceSpan span;
+    trace_thread_begin("adaptativo");
+    clock_gettime(CLOCK_MONOTONIC, &t0);
 
-    // Inicializar gerador aleatório local
-    struct drand48_data rand_buffer;
-    long seed = time(NULL) ^ (long)pthread_self();
-    srand48_r(seed, &rand_buffer);
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        long long batch = atomic_fetch_add_explicit(&shared->next_batch, 1, memory_order_relaxed);
+        long long first = batch * shared->batch_size;
+        if (first >= shared->max_tosses) {
+            break;
+        }
 
-    for (long long i = 0; i < tosses; ++i) {
-        drand48_r(&rand_buffer, &x);
-        drand48_r(&rand_buffer, &y);
-        if ((x * x + y * y) <= 1.0) {
-            local_in_circle++;
+        long long n = shared->max_tosses - first;
+        if (n > shared->batch_size) {
+            n = shared->batch_size;
         }
+
+        trace_begin(&span);
+        local_in_circle += philox_count_hits(args->kernel, args->seed, (uint64_t)first, (uint64_t)n);
+        trace_end(&span, "lote");
+        local_tosses += n;
+
+        // Publica os totais parciais; o coordenador lê tosses antes de hits,
+        // então no pior caso enxerga hits de um lote a mais (irrelevante para o critério)
+        atomic_store_explicit(&args->counter->hits, local_in_circle, memory_order_relaxed);
+        atomic_store_explicit(&args->counter->tosses, local_tosses, memory_order_release);
     }
 
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    trace_thread_end();
+    args->busy = get_elapsed_time(&t0, &t1);
     *(args->result) = local_in_circle;
+    args->tosses = local_tosses;
+    atomic_fetch_sub_explicit(&shared->active_threads, 1, memory_order_release);
     return NULL;
 }
 
-int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Uso: %s <numero de threads> <numero total de lançamentos>\n", argv[0]);
-        return 1;
+// Função executada por cada thread no modo quase-Monte Carlo: percorre a mesma
+// fatia de índices da sequência de Sobol em cada réplica embaralhada
+void* qmc_thread(void* arg) {
+    ThreadArgs *args = (ThreadArgs *)arg;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    TraceSpan span;
+    trace_thread_begin("sobol");
+    for (int r = 0; r < args->replicas; ++r) {
+        SobolScramble scramble;
+        trace_begin(&span);
+        sobol_init_scramble(&scramble, args->seed, (uint64_t)r);
+        args->replica_hits[r] = sobol_count_hits(&scramble, (uint32_t)args->first_toss,
+                                                 (uint64_t)args->tosses);
+        trace_end(&span, "sobol_count_hits");
     }
 
-    int num_threads = atoi(argv[1]);
-    long long total_tosses = strtoll(argv[2], NULL, 10);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    trace_thread_end();
+    args->busy = get_elapsed_time(&t0, &t1);
+    return NULL;
+}
 
-    if (num_threads <= 0 || total_tosses <= 0) {
-        fprintf(stderr, "Número de threads e lançamentos devem ser positivos.\n");
-        return 1;
+// Função executada por cada thread no modo contínuo: avança o próprio fluxo em
+// lotes e publica posição e acertos após cada um
+void* monte_carlo_stream_thread(void* arg) {
+    ThreadArgs *args = (ThreadArgs *)arg;
+    StreamShared *stream = args->stream;
+    StreamSlot *slot = args->slot;
+    long long pos, hits;
+    struct timespec t0, t1;
+    TraceSpan span;
+    trace_thread_begin("contínuo");
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    // Retoma de onde o fluxo parou (início do fluxo numa execução nova)
+    stream_snapshot(slot, &pos, &hits);
+
+    while (pos < slot->end && !atomic_load_explicit(&stream->stop, memory_order_relaxed)) {
+        long long n = slot->end - pos;
+        if (n > args->batch_size) {
+            n = args->batch_size;
+        }
+        trace_begin(&span);
+        hits += philox_count_hits(args->kernel, args->seed, (uint64_t)pos, (uint64_t)n);
+        trace_end(&span, "lote");
+        pos += n;
+        stream_publish(slot, pos, hits);
     }
 
-    // Medição de tempo total e parcial
-    struct timespec start_total_time, end_total_time;
-    struct timespec start_partial_time, end_partial_time;
-    clock_gettime(CLOCK_MONOTONIC, &start_total_time);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    trace_thread_end();
+    args->busy = get_elapsed_time(&t0, &t1);
+    *(args->result) = hits;
+    args->tosses = pos - slot->first;
+    atomic_fetch_sub_explicit(&stream->active_threads, 1, memory_order_release);
+    return NULL;
+}
 
-    // Alocação de recursos
+// Soma o progresso publicado por todos os fluxos
+void stream_totals(StreamShared *stream, long long *done, long long *hits) {
+    *done = 0;
+    *hits = 0;
+    for (int i = 0; i < stream->num_streams; ++i) {
+        long long pos, h;
+        stream_snapshot(stream->slots[i], &pos, &h);
+        *done += pos - stream->slots[i]->first;
+        *hits += h;
+    }
+}
+
+// Thread de relatório do modo contínuo: a cada intervalo imprime vazão e estimativa
+// corrente e grava o checkpoint; também converte o sinal de interrupção em parada
+void* stream_reporter_thread(void* arg) {
+    StreamShared *stream = (StreamShared *)arg;
+    struct timespec start, last, now;
+    struct timespec slice = {0, REPORTER_SLICE_NS};
+    long long last_done = stream->resumed_tosses;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    last = start;
+
+    while (atomic_load_explicit(&stream->active_threads, memory_order_acquire) > 0) {
+        nanosleep(&slice, NULL);
+        if (interrupted) {
+            atomic_store_explicit(&stream->stop, 1, memory_order_relaxed);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (get_elapsed_time(&last, &now) < stream->interval) {
+            continue;
+        }
+
+        long long done, hits;
+        stream_totals(stream, &done, &hits);
+        double rate = (double)(done - last_done) / get_elapsed_time(&last, &now);
+        printf("[%10.1f s] %6.2f%% | %.3e lançamentos/s | Pi ≈ %.9f\n",
+               get_elapsed_time(&start, &now), 100.0 * (double)done / (double)stream->total_tosses,
+               rate, done > 0 ? 4.0 * (double)hits / (double)done : 0.0);
+        fflush(stdout);
+
+        if (stream->checkpoint_path
+            && checkpoint_write(stream->checkpoint_path, stream->seed, stream->total_tosses,
+                                stream->slots, stream->num_streams) != 0) {
+            perror("Falha ao gravar o checkpoint");
+        }
+
+        last = now;
+        last_done = done;
+    }
+    return NULL;
+}
+
+void on_interrupt(int sig) {
+    (void)sig;
+    interrupted = 1;
+}
+
+// Quantil z da normal padrão tal que P(|Z| <= z) = confidence (bisseção sobre erf)
+double normal_quantile(double confidence) {
+    double lo = 0.0, hi = 10.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (erf(mid / M_SQRT2) < confidence) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+// Meia largura do intervalo de confiança de 4 * p, com p binomial estimado em n lançamentos
+double pi_half_width(long long hits, long long tosses, double z) {
+    double p = (double)hits / (double)tosses;
+    return z * 4.0 * sqrt(p * (1.0 - p) / (double)tosses);
+}
+
+// Coordenador do modo adaptativo: soma os contadores publicados e sinaliza parada
+// assim que o erro padrão binomial atinge o alvo
+void coordinate_adaptive(AdaptiveShared *shared, PaddedCounter **counters, int num_threads,
+                         double target_error, double z) {
+    struct timespec interval = {0, POLL_INTERVAL_NS};
+
+    while (atomic_load_explicit(&shared->active_threads, memory_order_acquire) > 0) {
+        nanosleep(&interval, NULL);
+
+        long long hits = 0, tosses = 0;
+        for (int i = 0; i < num_threads; ++i) {
+            tosses += atomic_load_explicit(&counters[i]->tosses, memory_order_acquire);
+            hits += atomic_load_explicit(&counters[i]->hits, memory_order_relaxed);
+        }
+
+        // Exige ao menos um lote por thread antes de confiar na aproximação normal
+        if (tosses < shared->batch_size * num_threads || hits >= tosses) {
+            continue;
+        }
+
+        if (pi_half_width(hits, tosses, z) <= target_error) {
+            atomic_store_explicit(&shared->stop, 1, memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+// Tarefa do pool: amostra o bloco `chunk` de lançamentos
+void monte_carlo_chunk(void *ctx, int worker, long long chunk) {
+    PoolJob *job = (PoolJob *)ctx;
+    const RunConfig *cfg = job->cfg;
+    long long first = chunk * cfg->batch_size;
+    long long n = cfg->total_tosses - first;
+    if (n > cfg->batch_size) {
+        n = cfg->batch_size;
+    }
+
+    TraceSpan span;
+    trace_begin(&span);
+    long long hits = philox_count_hits(cfg->kernel, cfg->seed, (uint64_t)first, (uint64_t)n);
+    trace_end(&span, "bloco");
+    atomic_fetch_add_explicit(&job->counters[worker]->hits, hits, memory_order_relaxed);
+}
+
+// Executa uma repetição criando uma thread por worker (divisão estática ou modo adaptativo).
+// Retorna 0 ou o código de erro de pthread_create.
+int run_spawned(const RunConfig *cfg, RunResult *res, PoolWorkerStats *stats) {
+    int num_threads = cfg->num_threads;
     pthread_t *thread_handles = malloc(num_threads * sizeof(pthread_t));
     ThreadArgs *args_array = malloc(num_threads * sizeof(ThreadArgs));
     long long *results = malloc(num_threads * sizeof(long long));
+    PaddedCounter **counters = alloc_counters(num_threads, cfg->plan);
 
-    if (!thread_handles || !args_array || !results) {
-        perror("Erro de alocação");
+    if (!thread_handles || !args_array || !results || !counters) {
         free(thread_handles);
         free(args_array);
         free(results);
-        return 1;
+        free_counters(counters, num_threads);
+        return ENOMEM;
     }
 
+    int adaptive = cfg->target_error > 0.0;
+    AdaptiveShared shared;
+    atomic_init(&shared.next_batch, 0);
+    atomic_init(&shared.stop, 0);
+    atomic_init(&shared.active_threads, num_threads);
+    shared.batch_size = cfg->batch_size;
+    shared.max_tosses = cfg->total_tosses;
+
     // Distribuição justa dos lançamentos entre threads
-    long long base_tosses = total_tosses / num_threads;
-    long long remainder = total_tosses % num_threads;
+    long long base_tosses = cfg->total_tosses / num_threads;
+    long long remainder = cfg->total_tosses % num_threads;
 
-    printf("Calculando com %d threads...\n", num_threads);
-    clock_gettime(CLOCK_MONOTONIC, &start_partial_time);
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
 
+    long long next_toss = 0;
     for (int i = 0; i < num_threads; ++i) {
+        args_array[i].first_toss = next_toss;
         args_array[i].tosses = base_tosses + (i < remainder ? 1 : 0);
+        args_array[i].seed = cfg->seed;
+        args_array[i].kernel = cfg->kernel;
         args_array[i].result = &results[i];
-        int ret = pthread_create(&thread_handles[i], NULL, monte_carlo_thread, &args_array[i]);
+        args_array[i].shared = &shared;
+        args_array[i].counter = counters[i];
+        args_array[i].busy = 0.0;
+        next_toss += args_array[i].tosses;
+        int ret = affinity_thread_create(&thread_handles[i], cfg->plan, i,
+                                         adaptive ? monte_carlo_adaptive_thread : monte_carlo_thread,
+                                         &args_array[i]);
         if (ret != 0) {
-            errno = ret;
-            perror("pthread_create falhou");
+            // Threads já criadas no modo adaptativo param no próximo lote
+            atomic_store(&shared.stop, 1);
+            for (int j = 0; j < i; ++j) {
+                pthread_join(thread_handles[j], NULL);
+            }
             free(thread_handles);
             free(args_array);
             free(results);
-            return 1;
+            free_counters(counters, num_threads);
+            return ret;
+        }
+    }
+
+    if (adaptive) {
+        coordinate_adaptive(&shared, counters, num_threads, cfg->target_error, cfg->z);
+    }
+
+    res->hits = 0;
+    res->tosses = 0;
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(thread_handles[i], NULL);
+        res->hits += results[i];
+        res->tosses += args_array[i].tosses;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    res->elapsed = get_elapsed_time(&start_time, &end_time);
+    res->pi_estimate = 4.0 * (double)res->hits / (double)res->tosses;
+    res->std_error = pi_half_width(res->hits, res->tosses, 1.0);
+
+    // A thread fica ociosa do fim do seu trabalho até o join da última
+    for (int i = 0; i < num_threads; ++i) {
+        stats[i].busy = args_array[i].busy;
+        stats[i].idle = res->elapsed - args_array[i].busy;
+        stats[i].chunks = adaptive ? (args_array[i].tosses + cfg->batch_size - 1) / cfg->batch_size : 1;
+        stats[i].steals = 0;
+    }
+
+    free(thread_handles);
+    free(args_array);
+    free(results);
+    free_counters(counters, num_threads);
+    return 0;
+}
+
+void free_replica_hits(long long **replica_hits, int num_threads, size_t bytes) {
+    if (!replica_hits) {
+        return;
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        affinity_free_local(replica_hits[i], bytes);
+    }
+    free(replica_hits);
+}
+
+// Executa uma repetição no modo quase-Monte Carlo. Cada réplica usa
+// total_tosses / qmc_replicas pontos; as threads dividem o intervalo de índices
+// estaticamente, sem coordenação. Retorna 0 ou o código de erro de pthread_create.
+int run_qmc(const RunConfig *cfg, RunResult *res, PoolWorkerStats *stats) {
+    int num_threads = cfg->num_threads;
+    int replicas = cfg->qmc_replicas;
+    long long per_replica = cfg->total_tosses / replicas;
+    pthread_t *thread_handles = malloc(num_threads * sizeof(pthread_t));
+    ThreadArgs *args_array = malloc(num_threads * sizeof(ThreadArgs));
+    // Acertos por réplica de cada thread, em página própria no nó da thread
+    size_t hits_bytes = (size_t)replicas * sizeof(long long);
+    long long **replica_hits = calloc(num_threads, sizeof(long long *));
+    for (int i = 0; replica_hits && i < num_threads; ++i) {
+        replica_hits[i] = affinity_alloc_local(hits_bytes, affinity_node_of(cfg->plan, i));
+        if (!replica_hits[i]) {
+            free_replica_hits(replica_hits, num_threads, hits_bytes);
+            replica_hits = NULL;
+        }
+    }
+
+    if (!thread_handles || !args_array || !replica_hits) {
+        free(thread_handles);
+        free(args_array);
+        free_replica_hits(replica_hits, num_threads, hits_bytes);
+        return ENOMEM;
+    }
+
+    long long base_points = per_replica / num_threads;
+    long long remainder = per_replica % num_threads;
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    long long next_point = 0;
+    for (int i = 0; i < num_threads; ++i) {
+        args_array[i].first_toss = next_point;
+        args_array[i].tosses = base_points + (i < remainder ? 1 : 0);
+        args_array[i].seed = cfg->seed;
+        args_array[i].replicas = replicas;
+        args_array[i].replica_hits = replica_hits[i];
+        args_array[i].busy = 0.0;
+        next_point += args_array[i].tosses;
+        int ret = affinity_thread_create(&thread_handles[i], cfg->plan, i, qmc_thread, &args_array[i]);
+        if (ret != 0) {
+            for (int j = 0; j < i; ++j) {
+                pthread_join(thread_handles[j], NULL);
+            }
+            free(thread_handles);
+            free(args_array);
+            free_replica_hits(replica_hits, num_threads, hits_bytes);
+            return ret;
         }
     }
 
-    long long total_in_circle = 0;
     for (int i = 0; i < num_threads; ++i) {
         pthread_join(thread_handles[i], NULL);
-        total_in_circle += results[i];
     }
 
-    clock_gettime(CLOCK_MONOTONIC, &end_partial_time);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    res->elapsed = get_elapsed_time(&start_time, &end_time);
+
+    // Estimativa = média das réplicas; erro padrão = desvio entre réplicas / sqrt(R)
+    double sum = 0.0, sum_sq = 0.0;
+    res->hits = 0;
+    for (int r = 0; r < replicas; ++r) {
+        long long hits = 0;
+        for (int i = 0; i < num_threads; ++i) {
+            hits += replica_hits[i][r];
+        }
+        double estimate = 4.0 * (double)hits / (double)per_replica;
+        sum += estimate;
+        sum_sq += estimate * estimate;
+        res->hits += hits;
+    }
+
+    res->tosses = per_replica * replicas;
+    res->pi_estimate = sum / replicas;
+    res->std_error = 0.0;
+    if (replicas > 1) {
+        double variance = (sum_sq - sum * sum / replicas) / (replicas - 1);
+        res->std_error = sqrt(variance > 0.0 ? variance / replicas : 0.0);
+    }
+
+    for (int i = 0; i < num_threads; ++i) {
+        stats[i].busy = args_array[i].busy;
+        stats[i].idle = res->elapsed - args_array[i].busy;
+        stats[i].chunks = replicas;
+        stats[i].steals = 0;
+    }
+
+    free(thread_handles);
+    free(args_array);
+    free_replica_hits(replica_hits, num_threads, hits_bytes);
+    return 0;
+}
+
+// Executa o modo contínuo: uma thread por fluxo, mais a thread de relatório.
+// Ao final (ou na interrupção) grava o checkpoint e marca stream->checkpoint_saved
+// se conseguiu. Retorna 0 ou o código de erro de pthread_create; *was_interrupted
+// indica parada por sinal.
+int run_streaming(const RunConfig *cfg, StreamShared *stream, RunResult *res,
+                  PoolWorkerStats *stats, int *was_interrupted) {
+    int num_threads = stream->num_streams;
+    pthread_t *thread_handles = malloc(num_threads * sizeof(pthread_t));
+    ThreadArgs *args_array = malloc(num_threads * sizeof(ThreadArgs));
+    long long *results = malloc(num_threads * sizeof(long long));
+    pthread_t reporter;
+
+    if (!thread_handles || !args_array || !results) {
+        free(thread_handles);
+        free(args_array);
+        free(results);
+        return ENOMEM;
+    }
+
+    atomic_init(&stream->stop, 0);
+    atomic_init(&stream->active_threads, num_threads);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_interrupt;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    int created = 0;
+    int ret = 0;
+    for (int i = 0; i < num_threads && ret == 0; ++i) {
+        args_array[i].seed = cfg->seed;
+        args_array[i].kernel = cfg->kernel;
+        args_array[i].result = &results[i];
+        args_array[i].stream = stream;
+        args_array[i].slot = stream->slots[i];
+        args_array[i].batch_size = cfg->batch_size;
+        args_array[i].busy = 0.0;
+        ret = affinity_thread_create(&thread_handles[i], cfg->plan, i, monte_carlo_stream_thread, &args_array[i]);
+        if (ret == 0) {
+            created++;
+        }
+    }
+    if (ret == 0) {
+        ret = pthread_create(&reporter, NULL, stream_reporter_thread, stream);
+    }
+
+    if (ret != 0) {
+        // Para as threads já criadas no próximo lote
+        atomic_store(&stream->stop, 1);
+        atomic_fetch_sub(&stream->active_threads, num_threads - created);
+    }
+
+    res->hits = 0;
+    res->tosses = 0;
+    for (int i = 0; i < created; ++i) {
+        pthread_join(thread_handles[i], NULL);
+        res->hits += results[i];
+        res->tosses += args_array[i].tosses;
+    }
+    if (ret == 0) {
+        pthread_join(reporter, NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    res->elapsed = get_elapsed_time(&start_time, &end_time);
+    res->pi_estimate = 4.0 * (double)res->hits / (double)res->tosses;
+    res->std_error = pi_half_width(res->hits, res->tosses, 1.0);
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+
+    // Checkpoint final: ponto de retomada se interrompido, registro do fim caso contrário
+    stream->checkpoint_saved = 0;
+    if (stream->checkpoint_path) {
+        if (checkpoint_write(stream->checkpoint_path, stream->seed, stream->total_tosses,
+                             stream->slots, num_threads) != 0) {
+            perror("Falha ao gravar o checkpoint");
+        } else {
+            stream->checkpoint_saved = 1;
+        }
+    }
+
+    *was_interrupted = atomic_load(&stream->stop);
+    for (int i = 0; i < created; ++i) {
+        stats[i].busy = args_array[i].busy;
+        stats[i].idle = res->elapsed - args_array[i].busy;
+        stats[i].chunks = (args_array[i].tosses + cfg->batch_size - 1) / cfg->batch_size;
+        stats[i].steals = 0;
+    }
+
+    free(thread_handles);
+    free(args_array);
+    free(results);
+    return ret;
+}
+
+// Executa uma repetição no pool persistente, com blocos de cfg->batch_size lançamentos
+void run_pool(ThreadPool *pool, const RunConfig *cfg, PaddedCounter **counters,
+              RunResult *res, PoolWorkerStats *stats) {
+    PoolJob job = {cfg, counters};
+    long long num_chunks = (cfg->total_tosses + cfg->batch_size - 1) / cfg->batch_size;
+
+    for (int i = 0; i < cfg->num_threads; ++i) {
+        atomic_store_explicit(&counters[i]->hits, 0, memory_order_relaxed);
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    pool_run(pool, num_chunks, monte_carlo_chunk, &job);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    res->hits = 0;
+    res->tosses = cfg->total_tosses;
+    res->elapsed = get_elapsed_time(&start_time, &end_time);
+    for (int i = 0; i < cfg->num_threads; ++i) {
+        res->hits += atomic_load_explicit(&counters[i]->hits, memory_order_relaxed);
+        stats[i] = pool->deques[i]->stats;
+    }
+    res->pi_estimate = 4.0 * (double)res->hits / (double)res->tosses;
+    res->std_error = pi_half_width(res->hits, res->tosses, 1.0);
+}
+
+// Imprime o tempo ocupado/ocioso de cada thread e o desequilíbrio de carga
+void print_thread_stats(const PoolWorkerStats *stats, int num_threads) {
+    double max_busy = 0.0, sum_busy = 0.0;
+
+    printf("\nCarga por thread (última repetição):\n");
+    for (int i = 0; i < num_threads; ++i) {
+        printf("Thread %d: ocupada %f s, ociosa %f s, blocos %lld, roubos %lld\n",
+               i, stats[i].busy, stats[i].idle, stats[i].chunks, stats[i].steals);
+        sum_busy += stats[i].busy;
+        if (stats[i].busy > max_busy) {
+            max_busy = stats[i].busy;
+        }
+    }
+
+    double mean_busy = sum_busy / num_threads;
+    if (mean_busy > 0.0) {
+        printf("Desequilíbrio (máximo / média do tempo ocupado): %f\n", max_busy / mean_busy);
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Uso: %s [-s semente] [-k kernel] [-e erro [-c confiança] | -w | -q réplicas | -p seg | -K arquivo [-R]] [-b lote] [-r repetições] [-a política] [-T arquivo] "
+                    "<numero de threads> <numero total de lançamentos>\n", prog);
+    fprintf(stderr, "  -s semente  semente única de onde derivam todos os fluxos (padrão: relógio)\n");
+    fprintf(stderr, "  -e erro     modo adaptativo: para quando a meia largura do intervalo de confiança\n"
+                    "              de Pi for <= erro; o número de lançamentos vira o orçamento máximo\n");
+    fprintf(stderr, "  -c conf     nível de confiança do modo adaptativo (padrão: 0.95)\n");
+    fprintf(stderr, "  -w          usa o pool persistente com roubo de trabalho em vez da divisão estática\n");
+    fprintf(stderr, "  -q rep      quase-Monte Carlo: Sobol com embaralhamento de Owen em <rep> réplicas\n"
+                    "              independentes (o orçamento é dividido entre elas) e comparação com o\n"
+                    "              modo pseudoaleatório de mesmo orçamento\n");
+    fprintf(stderr, "  -b lote     lançamentos por lote/bloco no modo adaptativo e no pool (padrão: %lld)\n",
+            DEFAULT_BATCH_SIZE);
+    fprintf(stderr, "  -r rep      número de repetições (o pool é reaproveitado entre elas; padrão: 1)\n");
+    fprintf(stderr, "  -p seg      modo contínuo: imprime vazão e estimativa a cada <seg> segundos\n"
+                    "              (padrão %.0f s quando só -K é dado)\n", DEFAULT_REPORT_INTERVAL);
+    fprintf(stderr, "  -K arquivo  modo contínuo com checkpoint atômico no arquivo a cada relatório,\n"
+                    "              na interrupção (SIGINT/SIGTERM) e no fim\n");
+    fprintf(stderr, "  -R          retoma do checkpoint de -K (semente e fluxos vêm do arquivo)\n");
+    fprintf(stderr, "  -T arquivo  grava o trace das threads (formato do Chrome) no arquivo e imprime\n"
+                    "              um resumo com os contadores de hardware (requer -DTRACE_ENABLED)\n");
+    fprintf(stderr, "  -a pol      fixa as threads em CPUs: none compact scatter physical (padrão: none)\n");
+    fprintf(stderr, "  -k kernel   força o kernel de amostragem:");
+    for (int i = 0; i < PHILOX_NUM_KERNELS; ++i) {
+        fprintf(stderr, " %s", philox_kernels[i].name);
+    }
+    fprintf(stderr, " (padrão: o melhor suportado pela CPU)\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t seed = (uint64_t)time(NULL);
+    const char *kernel_name = NULL;
+    double target_error = 0.0;      // 0 = modo fixo
+    double confidence = 0.95;
+    long long batch_size = DEFAULT_BATCH_SIZE;
+    int use_pool = 0;
+    int repetitions = 1;
+    int qmc_replicas = 0;
+    double report_interval = 0.0;   // 0 = sem modo contínuo
+    const char *checkpoint_path = NULL;
+    int resume = 0;
+    AffinityPolicy policy = AFFINITY_NONE;
+    const char *trace_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:k:e:c:b:wr:q:p:K:Ra:T:")) != -1) {
+        switch (opt) {
+        case 's': {
+            char *endptr;
+            seed = strtoull(optarg, &endptr, 10);
+            if (*endptr != '\0') {
+                fprintf(stderr, "Semente inválida: %s\n", optarg);
+                return 1;
+            }
+            break;
+        }
+        case 'k':
+            kernel_name = optarg;
+            break;
+        case 'e':
+            target_error = strtod(optarg, NULL);
+            if (target_error <= 0.0) {
+                fprintf(stderr, "O erro alvo deve ser positivo.\n");
+                return 1;
+            }
+            break;
+        case 'c':
+            confidence = strtod(optarg, NULL);
+            if (confidence <= 0.0 || confidence >= 1.0) {
+                fprintf(stderr, "A confiança deve estar entre 0 e 1.\n");
+                return 1;
+            }
+            break;
+        case 'b':
+            batch_size = strtoll(optarg, NULL, 10);
+            if (batch_size <= 0) {
+                fprintf(stderr, "O tamanho do lote deve ser positivo.\n");
+                return 1;
+            }
+            break;
+        case 'w':
+            use_pool = 1;
+            break;
+        case 'r':
+            repetitions = atoi(optarg);
+            if (repetitions <= 0) {
+                fprintf(stderr, "O número de repetições deve ser positivo.\n");
+                return 1;
+            }
+            break;
+        case 'q':
+            qmc_replicas = atoi(optarg);
+            if (qmc_replicas <= 0) {
+                fprintf(stderr, "O número de réplicas deve ser positivo.\n");
+                return 1;
+            }
+            break;
+        case 'p':
+            report_interval = strtod(optarg, NULL);
+            if (report_interval <= 0.0) {
+                fprintf(stderr, "O intervalo de relatório deve ser positivo.\n");
+                return 1;
+            }
+            break;
+        case 'K':
+            checkpoint_path = optarg;
+            break;
+        case 'R':
+            resume = 1;
+            break;
+        case 'a':
+            if (affinity_parse_policy(optarg, &policy) != 0) {
+                fprintf(stderr, "Política de afinidade desconhecida: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'T':
+            trace_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (argc - optind != 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int num_threads = atoi(argv[optind]);
+    long long total_tosses = strtoll(argv[optind + 1], NULL, 10);
+
+    if (num_threads <= 0 || total_tosses <= 0) {
+        fprintf(stderr, "Número de threads e lançamentos devem ser positivos.\n");
+        return 1;
+    }
+
+    if (use_pool && target_error > 0.0) {
+        fprintf(stderr, "O modo adaptativo (-e) já distribui lotes dinamicamente e não usa o pool (-w).\n");
+        return 1;
+    }
+
+    if (qmc_replicas > 0) {
+        if (use_pool || target_error > 0.0) {
+            fprintf(stderr, "O modo quase-Monte Carlo (-q) não se combina com -e nem com -w.\n");
+            return 1;
+        }
+        long long per_replica = total_tosses / qmc_replicas;
+        if (per_replica <= 0 || per_replica > (1LL << SOBOL_BITS)) {
+            fprintf(stderr, "Cada réplica precisa de 1 a 2^%d pontos (lançamentos / réplicas).\n", SOBOL_BITS);
+            return 1;
+        }
+    }
+
+    int streaming = report_interval > 0.0 || checkpoint_path != NULL;
+    if (streaming) {
+        if (use_pool || target_error > 0.0 || qmc_replicas > 0 || repetitions > 1) {
+            fprintf(stderr, "O modo contínuo (-p/-K) não se combina com -e, -w, -q nem -r.\n");
+            return 1;
+        }
+        if (report_interval <= 0.0) {
+            report_interval = DEFAULT_REPORT_INTERVAL;
+        }
+    }
+    if (resume && !checkpoint_path) {
+        fprintf(stderr, "-R precisa do arquivo de checkpoint (-K).\n");
+        return 1;
+    }
+
+    // Daqui em diante todo erro sai por `out`, que libera o que já foi alocado
+    int status = 1;
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    PoolWorkerStats *stats = NULL;
+    PaddedCounter **counters = NULL;
+    StreamSlot *initial_slots = NULL;
+
+    // Fluxos do modo contínuo: lidos do checkpoint ou divididos como na divisão estática
+    StreamShared stream = {.interval = report_interval, .checkpoint_path = checkpoint_path};
+    if (resume) {
+        long long ckpt_total;
+        if (checkpoint_read(checkpoint_path, &seed, &ckpt_total, &initial_slots, &stream.num_streams) != 0) {
+            fprintf(stderr, "Checkpoint inválido ou inexistente: %s\n", checkpoint_path);
+            goto out;
+        }
+        if (ckpt_total != total_tosses) {
+            fprintf(stderr, "O checkpoint é de uma execução com %lld lançamentos, não %lld.\n",
+                    ckpt_total, total_tosses);
+            goto out;
+        }
+        if (stream.num_streams != num_threads) {
+            printf("Retomando com os %d fluxos do checkpoint (uma thread por fluxo).\n", stream.num_streams);
+            num_threads = stream.num_streams;
+        }
+    } else if (streaming) {
+        stream.num_streams = num_threads;
+        initial_slots = aligned_alloc(64, num_threads * sizeof(StreamSlot));
+        if (!initial_slots) {
+            perror("Erro de alocação");
+            goto out;
+        }
+        long long base_tosses = total_tosses / num_threads;
+        long long remainder = total_tosses % num_threads;
+        long long next_toss = 0;
+        for (int i = 0; i < num_threads; ++i) {
+            long long n = base_tosses + (i < remainder ? 1 : 0);
+            stream_init(&initial_slots[i], next_toss, next_toss, next_toss + n, 0);
+            next_toss += n;
+        }
+    }
+    stream.seed = seed;
+    stream.total_tosses = total_tosses;
+
+    const PhiloxKernel *kernel = philox_select_kernel(kernel_name);
+    if (!kernel) {
+        fprintf(stderr, "Kernel \"%s\" desconhecido ou não suportado por esta CPU.\n", kernel_name);
+        goto out;
+    }
+
+    // Posicionamento das threads (depois de -R, que pode mudar o número de threads)
+    int ret = affinity_read_topology(&topo);
+    if (ret == 0) {
+        ret = affinity_plan(&topo, policy, num_threads, &plan);
+    }
+    if (ret != 0) {
+        errno = ret;
+        perror("Falha ao ler a topologia das CPUs");
+        goto out;
+    }
+
+    // Só agora, com o plano, os fluxos vão para o nó de cada thread
+    if (streaming) {
+        stream.slots = alloc_stream_slots(initial_slots, stream.num_streams, &plan);
+        if (!stream.slots) {
+            perror("Erro de alocação");
+            goto out;
+        }
+        if (resume) {
+            long long hits;
+            stream_totals(&stream, &stream.resumed_tosses, &hits);
+            printf("Retomando de %s: %lld de %lld lançamentos já sorteados.\n",
+                   checkpoint_path, stream.resumed_tosses, total_tosses);
+        }
+    }
+
+    RunConfig cfg = {
+        .num_threads = num_threads,
+        .total_tosses = total_tosses,
+        .seed = seed,
+        .kernel = kernel,
+        .batch_size = batch_size,
+        .target_error = target_error,
+        .z = normal_quantile(confidence),
+        .qmc_replicas = qmc_replicas,
+        .plan = &plan,
+    };
+    int adaptive = target_error > 0.0;
+
+    if (trace_path) {
+        if (!trace_enabled()) {
+            fprintf(stderr, "Aviso: compilado sem -DTRACE_ENABLED; -T não grava nada.\n");
+        }
+        trace_init(0, 1);
+    }
+
+    // Medição de tempo total
+    struct timespec start_total_time, end_total_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_total_time);
+
+    // Alocação de recursos
+    stats = malloc(num_threads * sizeof(PoolWorkerStats));
+    counters = alloc_counters(num_threads, &plan);
+    if (!stats || !counters) {
+        perror("Erro de alocação");
+        goto out;
+    }
+
+    ThreadPool pool;
+    if (use_pool) {
+        ret = pool_init(&pool, num_threads, &plan);
+        if (ret != 0) {
+            errno = ret;
+            perror("Falha ao criar o pool de threads");
+            goto out;
+        }
+    }
+
+    printf("Calculando com %d threads (kernel %s, semente %llu, %s)...\n",
+           num_threads, kernel->name, (unsigned long long)seed,
+           streaming ? "modo contínuo" : qmc_replicas > 0 ? "quase-Monte Carlo (Sobol)"
+           : use_pool ? "pool com roubo de trabalho"
+           : adaptive ? "lotes dinâmicos" : "divisão estática");
+    affinity_print(stdout, &topo, &plan);
+    if (adaptive) {
+        printf("Modo adaptativo: erro alvo %g com confiança %g (z = %f), lotes de %lld, orçamento de %lld\n",
+               target_error, confidence, cfg.z, batch_size, total_tosses);
+    }
+
+    RunResult res = {0};
+    double best_elapsed = 0.0;
+    int was_interrupted = 0;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        if (use_pool) {
+            run_pool(&pool, &cfg, counters, &res, stats);
+        } else {
+            ret = streaming ? run_streaming(&cfg, &stream, &res, stats, &was_interrupted)
+                    : qmc_replicas > 0 ? run_qmc(&cfg, &res, stats) : run_spawned(&cfg, &res, stats);
+            if (ret != 0) {
+                errno = ret;
+                perror("pthread_create falhou");
+                goto out;
+            }
+        }
+
+        if (rep == 0 || res.elapsed < best_elapsed) {
+            best_elapsed = res.elapsed;
+        }
+        if (repetitions > 1) {
+            printf("Repetição %d: %f segundos\n", rep + 1, res.elapsed);
+        }
+    }
+
+    if (use_pool) {
+        pool_destroy(&pool);
+    }
+
     clock_gettime(CLOCK_MONOTONIC, &end_total_time);
 
+    // Referência pseudoaleatória com o mesmo orçamento efetivo
+    RunResult prng_res = {0};
+    if (qmc_replicas > 0) {
+        RunConfig prng_cfg = cfg;
+        PoolWorkerStats *prng_stats = malloc(num_threads * sizeof(PoolWorkerStats));
+        prng_cfg.qmc_replicas = 0;
+        prng_cfg.total_tosses = res.tosses;
+        ret = prng_stats ? run_spawned(&prng_cfg, &prng_res, prng_stats) : ENOMEM;
+        free(prng_stats);
+        if (ret != 0) {
+            errno = ret;
+            perror("Falha na execução pseudoaleatória de referência");
+            goto out;
+        }
+    }
+
+    if (was_interrupted) {
+        printf("\nExecução interrompida com %lld de %lld lançamentos sorteados.\n", res.tosses, total_tosses);
+        if (checkpoint_path && stream.checkpoint_saved) {
+            printf("Checkpoint salvo em %s; retome com -R -K %s.\n", checkpoint_path, checkpoint_path);
+        } else if (checkpoint_path) {
+            printf("O checkpoint final não foi gravado; %s, se existir, é de um relatório anterior.\n",
+                   checkpoint_path);
+        }
+        status = 130;
+        goto out;
+    }
+
     // Estimativa final de Pi
-    double pi_estimate = 4.0 * (double)total_in_circle / (double)total_tosses;
+    double pi_estimate = res.pi_estimate;
 
     // Tempo decorrido
     double total_elapsed = get_elapsed_time(&start_total_time, &end_total_time);
-    double partial_elapsed = get_elapsed_time(&start_partial_time, &end_partial_time);
 
     // Resultados
     printf("\nResultados Finais:\n");
-    printf("Total de pontos gerados (N_total): %lld\n", total_tosses);
-    printf("Pontos dentro do quarto de círculo (N_inside): %lld\n", total_in_circle);
-    printf("Estimativa de Pi ≈ 4 * (N_inside / N_total): %f\n", pi_estimate);
+    printf("Total de pontos gerados (N_total): %lld\n", res.tosses);
+    printf("Pontos dentro do quarto de círculo (N_inside): %lld\n", res.hits);
+    if (qmc_replicas > 0) {
+        printf("Estimativa de Pi (média de %d réplicas de %lld pontos): %.12f\n",
+               qmc_replicas, res.tosses / qmc_replicas, pi_estimate);
+        printf("Erro padrão entre réplicas: %g\n", res.std_error);
+        printf("Erro empírico |estimativa - pi|: %g\n", fabs(pi_estimate - M_PI));
+        printf("\nModo pseudoaleatório com o mesmo orçamento (%lld lançamentos):\n", prng_res.tosses);
+        printf("Estimativa de Pi: %.12f\n", prng_res.pi_estimate);
+        printf("Erro padrão binomial: %g\n", prng_res.std_error);
+        printf("Erro empírico |estimativa - pi|: %g\n", fabs(prng_res.pi_estimate - M_PI));
+        printf("Tempo: %f segundos\n", prng_res.elapsed);
+        if (res.std_error > 0.0) {
+            printf("Redução do erro padrão (pseudoaleatório / Sobol): %.1fx\n",
+                   prng_res.std_error / res.std_error);
+        }
+        printf("\n");
+    } else {
+        printf("Estimativa de Pi ≈ 4 * (N_inside / N_total): %f\n", pi_estimate);
+    }
+    if (adaptive) {
+        printf("Meia largura do intervalo de confiança (%g): %g (alvo %g)\n",
+               confidence, pi_half_width(res.hits, res.tosses, cfg.z), target_error);
+        printf("Lançamentos usados: %lld de %lld (%.2f%% do orçamento)\n",
+               res.tosses, total_tosses, 100.0 * (double)res.tosses / (double)total_tosses);
+    }
     printf("Tempo total decorrido: %f segundos\n", total_elapsed);
-    printf("Tempo parcial decorrido: %f segundos\n", partial_elapsed);
+    printf("Tempo parcial decorrido: %f segundos\n", res.elapsed);
+    if (streaming) {
+        printf("Vazão desta sessão: %.0f lançamentos/s (%lld retomados do checkpoint)\n",
+               (double)(res.tosses - stream.resumed_tosses) / res.elapsed, stream.resumed_tosses);
+    }
+    if (repetitions > 1) {
+        printf("Melhor tempo parcial em %d repetições: %f segundos\n", repetitions, best_elapsed);
+    }
 
+    print_thread_stats(stats, num_threads);
+
+    if (trace_path && trace_enabled()) {
+        printf("\nTrace:\n");
+        trace_print_summary(stdout);
+        if (trace_write(trace_path) != 0) {
+            perror("Falha ao gravar o trace");
+        } else {
+            printf("Trace gravado em %s\n", trace_path);
+        }
+    }
+    status = 0;
+
+out:
     // Liberação de recursos
-    free(thread_handles);
-    free(args_array);
-    free(results);
+    trace_shutdown();
+    free(stats);
+    free_counters(counters, num_threads);
+    free(initial_slots);
+    free_stream_slots(stream.slots, stream.num_streams);
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
 
-    return 0;
+    return status;
 }
-
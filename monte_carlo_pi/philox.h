@@ -0,0 +1,295 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+// Gerador baseado em contador Philox4x32-10 (Salmon et al., "Parallel Random
+// Numbers: As Easy as 1, 2, 3") e kernels de amostragem para o quarto de círculo.
+//
+// Cada bloco de 128 bits depende apenas de (semente, índice do bloco), então o
+// lançamento de índice i é sempre o mesmo, qualquer que seja o número de threads
+// ou a forma como o intervalo de lançamentos é dividido entre elas.
+//
+// Convenção: o bloco b (contador {b_lo, b_hi, 0, 0}) produz as palavras
+// w0..w3, que formam os lançamentos 2b -> (w0, w1) e 2b+1 -> (w2, w3).
+// Cada coordenada usa os 31 bits mais altos da palavra, de modo que o teste
+// x*x + y*y <= 1 vira u*u + v*v <= 2^62 em aritmética inteira exata.
+// Assim os kernels escalar, AVX2 e AVX-512 dão contagens idênticas bit a bit.
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PHILOX_X86 1
+#endif
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// Limite do teste inteiro: (2^31)^2
+#define PHILOX_CIRCLE_LIMIT (1ULL << 62)
+
+// Gera um bloco de 4 palavras de 32 bits para o contador e a chave dados
+static inline void philox4x32_10(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// Gera o bloco de índice `block` para a semente dada
+static inline void philox_block(uint64_t seed, uint64_t block, uint32_t out[4]) {
+    uint32_t ctr[4] = {(uint32_t)block, (uint32_t)(block >> 32), 0, 0};
+    uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    philox4x32_10(ctr, key, out);
+}
+
+// Testa se o ponto formado por duas palavras cai no quarto de círculo
+static inline int philox_in_circle(uint32_t wx, uint32_t wy) {
+    uint64_t u = wx >> 1;
+    uint64_t v = wy >> 1;
+    return (u * u + v * v) <= PHILOX_CIRCLE_LIMIT;
+}
+
+// Kernel escalar: conta os acertos dos lançamentos [first, first + count)
+static inline long long philox_count_hits_scalar(uint64_t seed, uint64_t first, uint64_t count) {
+    long long hits = 0;
+    uint32_t w[4];
+
+    for (uint64_t i = first; i < first + count; ++i) {
+        philox_block(seed, i >> 1, w);
+        int half = (int)(i & 1) * 2;
+        hits += philox_in_circle(w[half], w[half + 1]);
+    }
+    return hits;
+}
+
+// Conta os acertos de `nblocks` blocos completos a partir de `block` (escalar)
+static inline long long philox_count_blocks_scalar(uint64_t seed, uint64_t block, uint64_t nblocks) {
+    long long hits = 0;
+    uint32_t w[4];
+
+    for (uint64_t b = block; b < block + nblocks; ++b) {
+        philox_block(seed, b, w);
+        hits += philox_in_circle(w[0], w[1]);
+        hits += philox_in_circle(w[2], w[3]);
+    }
+    return hits;
+}
+
+#ifdef PHILOX_X86
+
+// Multiplicação 32x32 -> 64 em todas as 8 faixas: devolve as metades alta e baixa
+__attribute__((target("avx2")))
+static inline void philox_mulhilo_avx2(__m256i a, __m256i m, __m256i *hi, __m256i *lo) {
+    __m256i p_even = _mm256_mul_epu32(a, m);
+    __m256i p_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    *lo = _mm256_blend_epi32(p_even, _mm256_slli_epi64(p_odd, 32), 0xAA);
+    *hi = _mm256_blend_epi32(_mm256_srli_epi64(p_even, 32), p_odd, 0xAA);
+}
+
+// Conta quantos pares (x, y) de 31 bits nas faixas de 64 bits ficam fora do círculo
+__attribute__((target("avx2")))
+static inline int philox_outside_avx2(__m256i x, __m256i y, __m256i limit) {
+    __m256i xs = _mm256_srli_epi64(x, 1);
+    __m256i ys = _mm256_srli_epi64(y, 1);
+    __m256i sum = _mm256_add_epi64(_mm256_mul_epu32(xs, xs), _mm256_mul_epu32(ys, ys));
+    __m256i out = _mm256_cmpgt_epi64(sum, limit);
+    return __builtin_popcount((unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(out)));
+}
+
+// Kernel AVX2: 8 blocos (16 lançamentos) por iteração
+__attribute__((target("avx2")))
+static long long philox_count_blocks_avx2(uint64_t seed, uint64_t block, uint64_t nblocks) {
+    const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi32((int)PHILOX_M1);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i limit = _mm256_set1_epi64x((long long)PHILOX_CIRCLE_LIMIT);
+    const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    long long outside = 0;
+    uint64_t b = block;
+    uint64_t end = block + nblocks;
+
+    while (end - b >= 8) {
+        uint32_t lo = (uint32_t)b;
+        if (lo > UINT32_MAX - 7) {
+            // O grupo cruzaria a palavra alta do contador: trata no escalar
+            long long hits = philox_count_blocks_scalar(seed, b, 8);
+            outside += 16 - hits;
+            b += 8;
+            continue;
+        }
+
+        __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int)lo), lane);
+        __m256i c1 = _mm256_set1_epi32((int)(uint32_t)(b >> 32));
+        __m256i c2 = _mm256_setzero_si256();
+        __m256i c3 = _mm256_setzero_si256();
+        uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+
+        for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+            __m256i hi0, lo0, hi1, lo1;
+            philox_mulhilo_avx2(c0, m0, &hi0, &lo0);
+            philox_mulhilo_avx2(c2, m1, &hi1, &lo1);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32((int)k0));
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32((int)k1));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        // Faixas pares e ímpares de cada palavra, já como inteiros de 64 bits
+        outside += philox_outside_avx2(_mm256_and_si256(c0, low32), _mm256_and_si256(c1, low32), limit);
+        outside += philox_outside_avx2(_mm256_srli_epi64(c0, 32), _mm256_srli_epi64(c1, 32), limit);
+        outside += philox_outside_avx2(_mm256_and_si256(c2, low32), _mm256_and_si256(c3, low32), limit);
+        outside += philox_outside_avx2(_mm256_srli_epi64(c2, 32), _mm256_srli_epi64(c3, 32), limit);
+        b += 8;
+    }
+
+    long long hits = (long long)(b - block) * 2 - outside;
+    return hits + philox_count_blocks_scalar(seed, b, end - b);
+}
+
+__attribute__((target("avx512f")))
+static inline void philox_mulhilo_avx512(__m512i a, __m512i m, __m512i *hi, __m512i *lo) {
+    __m512i p_even = _mm512_mul_epu32(a, m);
+    __m512i p_odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+    *lo = _mm512_mask_blend_epi32(0xAAAA, p_even, _mm512_slli_epi64(p_odd, 32));
+    *hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(p_even, 32), p_odd);
+}
+
+__attribute__((target("avx512f")))
+static inline int philox_outside_avx512(__m512i x, __m512i y, __m512i limit) {
+    __m512i xs = _mm512_srli_epi64(x, 1);
+    __m512i ys = _mm512_srli_epi64(y, 1);
+    __m512i sum = _mm512_add_epi64(_mm512_mul_epu32(xs, xs), _mm512_mul_epu32(ys, ys));
+    return __builtin_popcount((unsigned)_mm512_cmpgt_epu64_mask(sum, limit));
+}
+
+// Kernel AVX-512: 16 blocos (32 lançamentos) por iteração
+__attribute__((target("avx512f")))
+static long long philox_count_blocks_avx512(uint64_t seed, uint64_t block, uint64_t nblocks) {
+    const __m512i m0 = _mm512_set1_epi32((int)PHILOX_M0);
+    const __m512i m1 = _mm512_set1_epi32((int)PHILOX_M1);
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i limit = _mm512_set1_epi64((long long)PHILOX_CIRCLE_LIMIT);
+    const __m512i low32 = _mm512_set1_epi64(0xFFFFFFFFLL);
+    long long outside = 0;
+    uint64_t b = block;
+    uint64_t end = block + nblocks;
+
+    while (end - b >= 16) {
+        uint32_t lo = (uint32_t)b;
+        if (lo > UINT32_MAX - 15) {
+            long long hits = philox_count_blocks_scalar(seed, b, 16);
+            outside += 32 - hits;
+            b += 16;
+            continue;
+        }
+
+        __m512i c0 = _mm512_add_epi32(_mm512_set1_epi32((int)lo), lane);
+        __m512i c1 = _mm512_set1_epi32((int)(uint32_t)(b >> 32));
+        __m512i c2 = _mm512_setzero_si512();
+        __m512i c3 = _mm512_setzero_si512();
+        uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+
+        for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+            __m512i hi0, lo0, hi1, lo1;
+            philox_mulhilo_avx512(c0, m0, &hi0, &lo0);
+            philox_mulhilo_avx512(c2, m1, &hi1, &lo1);
+            c0 = _mm512_xor_si512(_mm512_xor_si512(hi1, c1), _mm512_set1_epi32((int)k0));
+            c2 = _mm512_xor_si512(_mm512_xor_si512(hi0, c3), _mm512_set1_epi32((int)k1));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        outside += philox_outside_avx512(_mm512_and_si512(c0, low32), _mm512_and_si512(c1, low32), limit);
+        outside += philox_outside_avx512(_mm512_srli_epi64(c0, 32), _mm512_srli_epi64(c1, 32), limit);
+        outside += philox_outside_avx512(_mm512_and_si512(c2, low32), _mm512_and_si512(c3, low32), limit);
+        outside += philox_outside_avx512(_mm512_srli_epi64(c2, 32), _mm512_srli_epi64(c3, 32), limit);
+        b += 16;
+    }
+
+    long long hits = (long long)(b - block) * 2 - outside;
+    return hits + philox_count_blocks_scalar(seed, b, end - b);
+}
+
+#endif // PHILOX_X86
+
+// Kernel de contagem sobre blocos completos (escolhido em tempo de execução)
+typedef long long (*philox_blocks_fn)(uint64_t seed, uint64_t block, uint64_t nblocks);
+
+typedef struct {
+    const char *name;
+    philox_blocks_fn count_blocks;
+} PhiloxKernel;
+
+static const PhiloxKernel philox_kernels[] = {
+#ifdef PHILOX_X86
+    {"avx512", philox_count_blocks_avx512},
+    {"avx2", philox_count_blocks_avx2},
+#endif
+    {"escalar", philox_count_blocks_scalar},
+};
+
+#define PHILOX_NUM_KERNELS ((int)(sizeof(philox_kernels) / sizeof(philox_kernels[0])))
+
+// Verifica se a CPU atual suporta o kernel
+static inline int philox_kernel_supported(const PhiloxKernel *k) {
+#ifdef PHILOX_X86
+    if (strcmp(k->name, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+    if (strcmp(k->name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+#endif
+    return 1;
+}
+
+// Escolhe o kernel pelo nome, ou o melhor suportado se name == NULL.
+// Retorna NULL se o nome não existir ou não for suportado pela CPU.
+static inline const PhiloxKernel *philox_select_kernel(const char *name) {
+    for (int i = 0; i < PHILOX_NUM_KERNELS; ++i) {
+        const PhiloxKernel *k = &philox_kernels[i];
+        if (name && strcmp(k->name, name) != 0) continue;
+        if (philox_kernel_supported(k)) return k;
+        if (name) return NULL;
+    }
+    return NULL;
+}
+
+// Conta os acertos dos lançamentos [first, first + count) usando o kernel dado.
+// As pontas que não completam um bloco são tratadas no escalar.
+static inline long long philox_count_hits(const PhiloxKernel *k, uint64_t seed,
+                                          uint64_t first, uint64_t count) {
+    long long hits = 0;
+
+    if (count > 0 && (first & 1)) {
+        hits += philox_count_hits_scalar(seed, first, 1);
+        first++;
+        count--;
+    }
+
+    uint64_t nblocks = count >> 1;
+    hits += k->count_blocks(seed, first >> 1, nblocks);
+    first += nblocks * 2;
+    count -= nblocks * 2;
+
+    return hits + philox_count_hits_scalar(seed, first, count);
+}
+
+#endif // PHILOX_H
@@ -2,6 +2,11 @@
 #include <stdio.h>
 #include <time.h>
 #include <errno.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "philox.h"
+#include "sobol.h"
 
 // Calcula o tempo decorrido entre dois pontos usando clock_gettime()
 double get_elapsed_time(struct timespec *start, struct timespec *end) {
@@ -10,38 +15,84 @@ double get_elapsed_time(struct timespec *start, struct timespec *end) {
     return end_sec - start_sec;
 }
 
+// Estimativa quase-Monte Carlo: média de `replicas` réplicas de Sobol embaralhadas
+// com per_replica pontos cada; devolve o erro padrão entre réplicas em *std_error
+double sobol_estimate(uint64_t seed, int replicas, long long per_replica, double *std_error) {
+    double sum = 0.0, sum_sq = 0.0;
+
+    for (int r = 0; r < replicas; ++r) {
+        SobolScramble scramble;
+        sobol_init_scramble(&scramble, seed, (uint64_t)r);
+        long long hits = sobol_count_hits(&scramble, 0, (uint64_t)per_replica);
+        double estimate = 4.0 * (double)hits / (double)per_replica;
+        sum += estimate;
+        sum_sq += estimate * estimate;
+    }
+
+    *std_error = 0.0;
+    if (replicas > 1) {
+        double variance = (sum_sq - sum * sum / replicas) / (replicas - 1);
+        *std_error = sqrt(variance > 0.0 ? variance / replicas : 0.0);
+    }
+    return sum / replicas;
+}
+
 int main(int argc, char *argv[]) {
+    int qmc_replicas = 0;                 // 0 = apenas pseudoaleatório
+    uint64_t seed = (uint64_t)time(NULL);
+    int opt;
+
+    while ((opt = getopt(argc, argv, "q:s:")) != -1) {
+        if (opt == 'q' && (qmc_replicas = atoi(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 's') {
+            seed = strtoull(optarg, NULL, 10);
+            continue;
+        }
+        fprintf(stderr, "Uso: %s [-s semente] [-q réplicas] <numero de lançamentos>\n", argv[0]);
+        return 1;
+    }
+
     // Verifica se o número de lançamentos foi passado corretamente
-    if (argc != 2) {
-        fprintf(stderr, "Uso: %s <numero de lançamentos>\n", argv[0]);
+    if (argc - optind != 1) {
+        fprintf(stderr, "Uso: %s [-s semente] [-q réplicas] <numero de lançamentos>\n", argv[0]);
         return 1;
     }
 
     // Converte argumento para long long com verificação de validade
     char *endptr;
-    long long total_tosses = strtoll(argv[1], &endptr, 10);
+    long long total_tosses = strtoll(argv[optind], &endptr, 10);
     if (*endptr != '\0' || total_tosses <= 0) {
         fprintf(stderr, "Erro: forneça um número inteiro positivo.\n");
         return 1;
     }
 
+    // No modo quase-Monte Carlo o orçamento é dividido entre as réplicas
+    long long per_replica = qmc_replicas > 0 ? total_tosses / qmc_replicas : 0;
+    if (qmc_replicas > 0) {
+        if (per_replica <= 0 || per_replica > (1LL << SOBOL_BITS)) {
+            fprintf(stderr, "Erro: cada réplica precisa de 1 a 2^%d pontos.\n", SOBOL_BITS);
+            return 1;
+        }
+        total_tosses = per_replica * qmc_replicas;
+    }
+
     long long in_circle = 0;              // Contador de pontos dentro do círculo
-    double x, y, elapsed_time;
+    double elapsed_time;
     struct timespec start_time, end_time;
 
-    srand(time(NULL));                    // Inicializa o gerador de números aleatórios
-    printf("Gerando %lld pontos aleatórios...\n", total_tosses);
+    // Mesmo gerador (Philox) e mesmo kernel escalar que parallel_pi -k escalar:
+    // com a mesma semente a contagem é idêntica, e a comparação de vazão com a
+    // versão paralela mede só threads e SIMD, não a troca de gerador
+    const PhiloxKernel *kernel = philox_select_kernel("escalar");
+    printf("Gerando %lld pontos aleatórios (Philox, kernel %s, semente %llu)...\n",
+           total_tosses, kernel->name, (unsigned long long)seed);
 
     clock_gettime(CLOCK_MONOTONIC, &start_time); // Início da medição de tempo
 
     // Loop principal de Monte Carlo: gera pontos e conta quantos caem no círculo
-    for (long long i = 0; i < total_tosses; i++) {
-        x = (double)rand() / (RAND_MAX + 1.0);   // Coordenada x em [0.0, 1.0)
-        y = (double)rand() / (RAND_MAX + 1.0);   // Coordenada y em [0.0, 1.0)
-        if ((x * x + y * y) <= 1.0) {
-            in_circle++;                         // Conta se estiver dentro do quarto de círculo
-        }
-    }
+    in_circle = philox_count_hits(kernel, seed, 0, (uint64_t)total_tosses);
 
     clock_gettime(CLOCK_MONOTONIC, &end_time);   // Fim da medição de tempo
     elapsed_time = get_elapsed_time(&start_time, &end_time);
@@ -56,6 +107,27 @@ int main(int argc, char *argv[]) {
     printf("Estimativa de Pi ≈ 4 * (N_inside / N_total): %f\n", pi_estimate);
     printf("Tempo de CPU usado: %f segundos\n", elapsed_time);
 
+    if (qmc_replicas > 0) {
+        double std_error;
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        double qmc_estimate = sobol_estimate(seed, qmc_replicas, per_replica, &std_error);
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        // Erro padrão binomial do modo pseudoaleatório acima, para o mesmo orçamento
+        double p = (double)in_circle / (double)total_tosses;
+        double prng_std_error = 4.0 * sqrt(p * (1.0 - p) / (double)total_tosses);
+
+        printf("\nQuase-Monte Carlo (Sobol, %d réplicas de %lld pontos, semente %llu):\n",
+               qmc_replicas, per_replica, (unsigned long long)seed);
+        printf("Estimativa de Pi: %.12f\n", qmc_estimate);
+        printf("Erro padrão entre réplicas: %g\n", std_error);
+        printf("Erro empírico |estimativa - pi|: %g (pseudoaleatório: %g)\n",
+               fabs(qmc_estimate - M_PI), fabs(pi_estimate - M_PI));
+        printf("Erro padrão pseudoaleatório (binomial): %g\n", prng_std_error);
+        printf("Tempo de CPU usado: %f segundos\n", get_elapsed_time(&start_time, &end_time));
+    }
+
     return 0;
 }
 
@@ -0,0 +1,116 @@
+#ifndef SOBOL_H
+#define SOBOL_H
+
+// Sequência de Sobol em 2 dimensões com embaralhamento de Owen aleatório.
+//
+// A dimensão 0 é a sequência de van der Corput em base 2 e a dimensão 1 usa o
+// polinômio primitivo x + 1 (números de direção v_k = v_{k-1} ^ (v_{k-1} >> 1)).
+// Os pontos são gerados em ordem de código de Gray, então o ponto n+1 sai do
+// ponto n com um único XOR e qualquer thread pode pular direto para o índice
+// inicial da sua fatia com sobol_point().
+//
+// O embaralhamento é o de Owen aninhado via hash (Burley, "Practical Hash-based
+// Owen Scrambling", 2020). Réplicas com sementes independentes dão estimativas
+// independentes e não enviesadas, e a dispersão entre elas estima o erro.
+
+#include <stdint.h>
+
+#include "philox.h"
+
+// Bits de precisão dos números de direção (índices por réplica < 2^32)
+#define SOBOL_BITS 32
+
+// Fluxo Philox reservado para as sementes de embaralhamento
+#define SOBOL_SCRAMBLE_STREAM 0x50B01ULL
+
+typedef struct {
+    uint32_t seed[2];       // Semente de embaralhamento de cada dimensão
+} SobolScramble;
+
+static inline uint32_t sobol_reverse_bits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Permutação de Laine-Karras: cada bit só depende dos bits menos significativos
+static inline uint32_t sobol_laine_karras(uint32_t x, uint32_t seed) {
+    x ^= x * 0x3d20adeau;
+    x += seed;
+    x *= (seed >> 16) | 1u;
+    x ^= x * 0x05526c56u;
+    x ^= x * 0x53a22864u;
+    return x;
+}
+
+// Embaralhamento de Owen aninhado: aplica a permutação sobre os bits invertidos
+static inline uint32_t sobol_owen_scramble(uint32_t x, uint32_t seed) {
+    return sobol_reverse_bits(sobol_laine_karras(sobol_reverse_bits(x), seed));
+}
+
+// Sementes de embaralhamento da réplica `replica`, derivadas da semente única
+static inline void sobol_init_scramble(SobolScramble *s, uint64_t seed, uint64_t replica) {
+    uint32_t w[4];
+    philox_block(seed ^ SOBOL_SCRAMBLE_STREAM, replica, w);
+    s->seed[0] = w[0];
+    s->seed[1] = w[1];
+}
+
+// Número de direção k da dimensão 1
+static inline uint32_t sobol_direction1(int k) {
+    uint32_t v = 1u << 31;
+    for (int i = 0; i < k; ++i) {
+        v ^= v >> 1;
+    }
+    return v;
+}
+
+// Ponto de índice n na ordem de Gray (sem embaralhamento)
+static inline void sobol_point(uint32_t n, uint32_t *x, uint32_t *y) {
+    uint32_t g = n ^ (n >> 1);
+    uint32_t v = 1u << 31;
+    uint32_t acc = 0;
+
+    for (int k = 0; k < SOBOL_BITS; ++k) {
+        if (g & (1u << k)) {
+            acc ^= v;
+        }
+        v ^= v >> 1;
+    }
+
+    *x = sobol_reverse_bits(g);
+    *y = acc;
+}
+
+// Conta os pontos de índices [first, first + count) da réplica que caem no
+// quarto de círculo, com o mesmo teste inteiro do kernel Philox. count é de
+// 64 bits para que a sequência inteira (first = 0, count = 2^SOBOL_BITS) caiba.
+static inline long long sobol_count_hits(const SobolScramble *s, uint32_t first, uint64_t count) {
+    uint32_t dir0[SOBOL_BITS], dir1[SOBOL_BITS];
+    for (int k = 0; k < SOBOL_BITS; ++k) {
+        dir0[k] = 1u << (31 - k);
+        dir1[k] = sobol_direction1(k);
+    }
+
+    long long hits = 0;
+    uint32_t x, y;
+    sobol_point(first, &x, &y);
+
+    for (uint64_t i = 0; i < count; ++i) {
+        hits += philox_in_circle(sobol_owen_scramble(x, s->seed[0]),
+                                 sobol_owen_scramble(y, s->seed[1]));
+
+        // Próximo ponto em ordem de Gray: muda o bit ctz(n + 1)
+        uint32_t n = first + (uint32_t)i + 1;
+        if (n != 0) {
+            int c = __builtin_ctz(n);
+            x ^= dir0[c];
+            y ^= dir1[c];
+        }
+    }
+    return hits;
+}
+
+#endif // SOBOL_H
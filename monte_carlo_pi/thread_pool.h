@@ -0,0 +1,304 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Pool persistente de threads com escalonamento dinâmico por roubo de trabalho.
+//
+// Um trabalho é um intervalo de blocos [0, num_chunks). No início de cada
+// execução os blocos são divididos igualmente entre os deques dos workers;
+// cada worker consome o seu pela frente e, quando esvazia, rouba a metade final
+// do deque de outro worker. Assim workers rápidos (ou menos disputados) drenam
+// o que sobrou dos lentos, em vez de o mais lento ditar o tempo total.
+//
+// As threads são criadas uma única vez em pool_init e reaproveitadas por todas
+// as chamadas a pool_run até pool_destroy. Com um AffinityPlan, o worker i nasce
+// fixado na CPU i do plano e o seu deque fica no nó NUMA dessa CPU.
+//
+// Cada worker se registra no trace como "pool N" ao nascer e fecha os seus
+// contadores ao sair; para o nome valer, trace_init vem antes de pool_init.
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+
+#include "../common/affinity.h"
+#include "../common/trace.h"
+
+// Função executada para cada bloco; worker é o índice do worker que a executa
+typedef void (*pool_task_fn)(void *ctx, int worker, long long chunk);
+
+// Estatísticas da última execução de um worker
+typedef struct {
+    double busy;            // Segundos executando blocos
+    double idle;            // Segundos da execução sem trabalho (procurando ou esperando)
+    long long chunks;       // Blocos executados
+    long long steals;       // Roubos bem-sucedidos
+} PoolWorkerStats;
+
+// Deque de um worker: blocos [head, tail), protegido pelo próprio mutex.
+// Alinhado em linha de cache para que workers vizinhos não disputem a mesma linha.
+typedef struct {
+    _Alignas(64) pthread_mutex_t lock;
+    long long head;
+    long long tail;
+    PoolWorkerStats stats;
+} PoolDeque;
+
+typedef struct ThreadPool ThreadPool;
+
+typedef struct {
+    ThreadPool *pool;
+    int id;
+} PoolWorkerArg;
+
+struct ThreadPool {
+    int num_workers;
+    pthread_t *threads;
+    PoolWorkerArg *worker_args;
+    PoolDeque **deques;         // Um deque por worker, cada um no nó do seu worker
+
+    // Sincronização entre pool_run e os workers
+    pthread_mutex_t lock;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+    unsigned long generation;   // Incrementado a cada pool_run
+    int pending;                // Workers que ainda não terminaram a execução atual
+    int shutdown;
+
+    // Trabalho da execução atual
+    pool_task_fn fn;
+    void *ctx;
+    struct timespec run_start;
+};
+
+static inline double pool_elapsed(const struct timespec *start, const struct timespec *end) {
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Retira o próximo bloco do próprio deque; retorna -1 se estiver vazio
+static inline long long pool_pop(PoolDeque *dq) {
+    long long chunk = -1;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail) {
+        chunk = dq->head++;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return chunk;
+}
+
+// Rouba a metade final do deque de outro worker para o próprio deque.
+// Retorna o primeiro bloco roubado (para execução imediata) ou -1.
+static inline long long pool_steal(ThreadPool *pool, int self) {
+    for (int k = 1; k < pool->num_workers; ++k) {
+        PoolDeque *victim = pool->deques[(self + k) % pool->num_workers];
+        long long first = -1, last = -1;
+
+        pthread_mutex_lock(&victim->lock);
+        long long remaining = victim->tail - victim->head;
+        if (remaining > 0) {
+            long long take = (remaining + 1) / 2;
+            first = victim->tail - take;
+            last = victim->tail;
+            victim->tail = first;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (first >= 0) {
+            PoolDeque *own = pool->deques[self];
+            pthread_mutex_lock(&own->lock);
+            own->head = first + 1;
+            own->tail = last;
+            own->stats.steals++;
+            pthread_mutex_unlock(&own->lock);
+            return first;
+        }
+    }
+    return -1;
+}
+
+// Executa blocos até não haver mais trabalho em nenhum deque
+static inline void pool_drain(ThreadPool *pool, int self) {
+    PoolDeque *own = pool->deques[self];
+    struct timespec t0, t1;
+
+    for (;;) {
+        long long chunk = pool_pop(own);
+        if (chunk < 0) {
+            chunk = pool_steal(pool, self);
+        }
+        if (chunk < 0) {
+            // Blocos só são removidos dos deques, então nada novo vai aparecer
+            break;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        pool->fn(pool->ctx, self, chunk);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        own->stats.busy += pool_elapsed(&t0, &t1);
+        own->stats.chunks++;
+    }
+}
+
+static void *pool_worker_main(void *arg) {
+    PoolWorkerArg *wa = (PoolWorkerArg *)arg;
+    ThreadPool *pool = wa->pool;
+    unsigned long seen = 0;
+
+    trace_thread_begin("pool");
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start_cond, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            trace_thread_end();
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool_drain(pool, wa->id);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done_cond);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// Libera os deques alocados (os não alocados são NULL)
+static inline void pool_free_deques(ThreadPool *pool) {
+    for (int i = 0; i < pool->num_workers; ++i) {
+        affinity_free_local(pool->deques[i], sizeof(PoolDeque));
+    }
+    free(pool->deques);
+}
+
+// Cria o pool com num_workers threads, fixadas segundo plan (NULL = sem fixação).
+// Retorna 0 ou um código de erro (errno).
+static inline int pool_init(ThreadPool *pool, int num_workers, const AffinityPlan *plan) {
+    pool->num_workers = num_workers;
+    pool->generation = 0;
+    pool->pending = 0;
+    pool->shutdown = 0;
+    pool->fn = NULL;
+    pool->ctx = NULL;
+    pool->threads = malloc(num_workers * sizeof(pthread_t));
+    pool->worker_args = malloc(num_workers * sizeof(PoolWorkerArg));
+    pool->deques = calloc(num_workers, sizeof(PoolDeque *));
+
+    int ok = pool->threads && pool->worker_args && pool->deques;
+    for (int i = 0; ok && i < num_workers; ++i) {
+        pool->deques[i] = affinity_alloc_local(sizeof(PoolDeque), affinity_node_of(plan, i));
+        ok = pool->deques[i] != NULL;
+    }
+    if (!ok) {
+        if (pool->deques) {
+            pool_free_deques(pool);
+        }
+        free(pool->threads);
+        free(pool->worker_args);
+        return ENOMEM;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    for (int i = 0; i < num_workers; ++i) {
+        pthread_mutex_init(&pool->deques[i]->lock, NULL);
+        pool->deques[i]->head = pool->deques[i]->tail = 0;
+        pool->deques[i]->stats = (PoolWorkerStats){0};
+    }
+
+    for (int i = 0; i < num_workers; ++i) {
+        pool->worker_args[i].pool = pool;
+        pool->worker_args[i].id = i;
+        int ret = affinity_thread_create(&pool->threads[i], plan, i, pool_worker_main, &pool->worker_args[i]);
+        if (ret != 0) {
+            // Encerra as threads já criadas
+            pthread_mutex_lock(&pool->lock);
+            pool->shutdown = 1;
+            pthread_cond_broadcast(&pool->start_cond);
+            pthread_mutex_unlock(&pool->lock);
+            for (int j = 0; j < i; ++j) {
+                pthread_join(pool->threads[j], NULL);
+            }
+            for (int j = 0; j < num_workers; ++j) {
+                pthread_mutex_destroy(&pool->deques[j]->lock);
+            }
+            pthread_mutex_destroy(&pool->lock);
+            pthread_cond_destroy(&pool->start_cond);
+            pthread_cond_destroy(&pool->done_cond);
+            pool_free_deques(pool);
+            free(pool->threads);
+            free(pool->worker_args);
+            return ret;
+        }
+    }
+    return 0;
+}
+
+// Executa fn(ctx, worker, c) para todo c em [0, num_chunks) e espera terminar.
+// Ao final, deques[i]->stats contém as estatísticas desta execução.
+static inline void pool_run(ThreadPool *pool, long long num_chunks, pool_task_fn fn, void *ctx) {
+    long long base = num_chunks / pool->num_workers;
+    long long remainder = num_chunks % pool->num_workers;
+    long long next = 0;
+
+    // Divisão inicial igual à estática; o roubo corrige o desequilíbrio
+    for (int i = 0; i < pool->num_workers; ++i) {
+        PoolDeque *dq = pool->deques[i];
+        pthread_mutex_lock(&dq->lock);
+        dq->head = next;
+        next += base + (i < remainder ? 1 : 0);
+        dq->tail = next;
+        dq->stats = (PoolWorkerStats){0};
+        pthread_mutex_unlock(&dq->lock);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->pending = pool->num_workers;
+    clock_gettime(CLOCK_MONOTONIC, &pool->run_start);
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cond);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    // Tempo ocioso = duração da execução - tempo ocupado
+    struct timespec run_end;
+    clock_gettime(CLOCK_MONOTONIC, &run_end);
+    double wall = pool_elapsed(&pool->run_start, &run_end);
+    for (int i = 0; i < pool->num_workers; ++i) {
+        pool->deques[i]->stats.idle = wall - pool->deques[i]->stats.busy;
+    }
+}
+
+// Encerra as threads e libera os recursos do pool
+static inline void pool_destroy(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->num_workers; ++i) {
+        pthread_join(pool->threads[i], NULL);
+        pthread_mutex_destroy(&pool->deques[i]->lock);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start_cond);
+    pthread_cond_destroy(&pool->done_cond);
+    pool_free_deques(pool);
+    free(pool->threads);
+    free(pool->worker_args);
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,172 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/affinity.h"
+#include "adaptive_trie.h"
+#include "trie.h"
+#include "palavras.h"
+
+// Tamanho de um nó da Trie de layout fixo (trie.h, com os agregados de
+// frequência) e o da versão original com 26 ponteiros
+#define FIXED_NODE_BYTES sizeof(struct TrieNode)
+#define POINTER_NODE_BYTES 216
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int cmp_word(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static void print_stats(const AdaptiveTrie *trie, long long num_words) {
+    AdaptiveStats stats;
+    adaptive_trie_stats(trie, &stats);
+    printf("Nós: %u Node4 (%zu B), %u Node16 (%zu B), %u Node26 (%zu B)\n",
+           stats.nodes[ADAPTIVE_NODE4], sizeof(AdaptiveNode4),
+           stats.nodes[ADAPTIVE_NODE16], sizeof(AdaptiveNode16),
+           stats.nodes[ADAPTIVE_NODE26], sizeof(AdaptiveNode26));
+    printf("Memória adaptativa: %.1f bytes/palavra (%zu bytes em nós, %zu mapeados)\n",
+           (double)stats.bytes / num_words, stats.bytes, stats.mapped_bytes);
+    printf("Layout fixo equivalente: %lld nós; %.1f bytes/palavra com índices de 32 bits (%.1fx), "
+           "%.1f com ponteiros (%.1fx)\n", stats.uncompressed_nodes,
+           (double)stats.uncompressed_nodes * FIXED_NODE_BYTES / num_words,
+           (double)stats.uncompressed_nodes * FIXED_NODE_BYTES / stats.bytes,
+           (double)stats.uncompressed_nodes * POINTER_NODE_BYTES / num_words,
+           (double)stats.uncompressed_nodes * POINTER_NODE_BYTES / stats.bytes);
+}
+
+int main(int argc, char *argv[]) {
+    AffinityPolicy policy = AFFINITY_NONE;
+    long long synthetic = 0;    // -n: insere N palavras sintéticas em vez da lista fixa
+    int opt;
+    while ((opt = getopt(argc, argv, "a:n:")) != -1) {
+        if (opt == 'a' && affinity_parse_policy(optarg, &policy) == 0) {
+            continue;
+        }
+        if (opt == 'n' && (synthetic = atoll(optarg)) > 0) {
+            continue;
+        }
+        fprintf(stderr, "Uso: %s [-a none|compact|scatter|physical] [-n palavras sintéticas]\n", argv[0]);
+        return 1;
+    }
+
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    if (affinity_read_topology(&topo) != 0 || affinity_plan(&topo, policy, 1, &plan) != 0
+        || affinity_pin_self(&plan, 0) != 0) {
+        perror("Falha ao aplicar a afinidade");
+        return 1;
+    }
+    affinity_print(stdout, &topo, &plan);
+
+    AdaptiveTrie trie;
+    if (adaptive_trie_init(&trie) != 0) {
+        perror("Falha ao criar a Trie");
+        return 1;
+    }
+
+    long long num_words = sizeof(words) / sizeof(words[0]);
+    int num_search_words = sizeof(search_words) / sizeof(search_words[0]);
+    long long *synthetic_offsets = NULL;
+    char *synthetic_words = NULL;
+    if (synthetic > 0) {
+        synthetic_words = generateWords(synthetic, &synthetic_offsets);
+        if (!synthetic_words) {
+            perror("Falha ao gerar as palavras sintéticas");
+            adaptive_trie_destroy(&trie);
+            return 1;
+        }
+        num_words = synthetic;
+    }
+#define WORD(i) (synthetic_words ? synthetic_words + synthetic_offsets[i] : words[i])
+
+    struct timespec t0, t1;
+
+    // --- Inserção ---
+    printf("Iniciando inserção de %lld palavras na Trie adaptativa...\n", num_words);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long long i = 0; i < num_words; i++) {
+        if (adaptive_trie_insert(&trie, WORD(i)) != 0) {
+            fprintf(stderr, "Memória esgotada na palavra %lld\n", i);
+            return 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed_insert = elapsed(&t0, &t1);
+    printf("Tempo de Inserção: %.9f segundos\n", elapsed_insert);
+    printf("Vazão de inserção: %.0f palavras/s\n", num_words / elapsed_insert);
+    print_stats(&trie, num_words);
+    printf("\n");
+
+    // --- Busca de todas as palavras inseridas ---
+    long long found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long long i = 0; i < num_words; i++) {
+        found += adaptive_trie_search(&trie, WORD(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed_search = elapsed(&t0, &t1);
+    printf("Busca das palavras inseridas: %lld de %lld encontradas em %.9f segundos (%.0f buscas/s)\n",
+           found, num_words, elapsed_search, num_words / elapsed_search);
+
+    // --- Busca da lista mista, conferida contra a lista de inserção ---
+    int mismatches = 0;
+    for (int i = 0; i < num_search_words && !synthetic_words; i++) {
+        bool expected = false;
+        for (long long j = 0; j < num_words && !expected; j++) {
+            expected = strcmp(words[j], search_words[i]) == 0;
+        }
+        mismatches += adaptive_trie_search(&trie, search_words[i]) != expected;
+    }
+    bool prefix_found = false;
+    if (!synthetic_words) {
+        prefix_found = adaptive_trie_search(&trie, "ther");
+        printf("Busca por \"ther\": %s\n", prefix_found ? "ENCONTRADO" : "NAO ENCONTRADO (correto, é só prefixo)");
+    }
+
+    // --- Remoção de metade das palavras (exercita encolhimento e refusão de caminhos) ---
+    long long removed = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long long i = 0; i < num_words; i += 2) {
+        removed += adaptive_trie_delete(&trie, WORD(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("\nRemovidas %lld palavras em %.9f segundos\n", removed, elapsed(&t0, &t1));
+
+    // As palavras de índice ímpar continuam, a não ser que repitam uma removida:
+    // as removidas vão ordenadas para a busca binária, também na entrada sintética
+    long long num_removed_words = (num_words + 1) / 2;
+    const char **removed_words = malloc((size_t)num_removed_words * sizeof(const char *));
+    if (!removed_words) {
+        perror("Erro de alocação");
+        return 1;
+    }
+    for (long long i = 0; i < num_removed_words; i++) {
+        removed_words[i] = WORD(2 * i);
+    }
+    qsort(removed_words, (size_t)num_removed_words, sizeof(const char *), cmp_word);
+    for (long long i = 1; i < num_words; i += 2) {
+        const char *word = WORD(i);
+        bool duplicate_removed = bsearch(&word, removed_words, (size_t)num_removed_words,
+                                         sizeof(const char *), cmp_word) != NULL;
+        mismatches += adaptive_trie_search(&trie, word) == duplicate_removed;
+    }
+    free(removed_words);
+    print_stats(&trie, num_words - removed);
+
+    printf("\nVerificação contra a lista fixa: %s (%d divergências)\n",
+           mismatches || prefix_found ? "FALHOU" : "ok", mismatches + prefix_found);
+
+    adaptive_trie_destroy(&trie);
+    free(synthetic_words);
+    free(synthetic_offsets);
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
+    return mismatches || prefix_found ? 1 : 0;
+}
@@ -0,0 +1,587 @@
+#ifndef ADAPTIVE_TRIE_H
+#define ADAPTIVE_TRIE_H
+
+// Trie com nós de tamanho adaptativo (no estilo da Adaptive Radix Tree) para o
+// alfabeto 'a'-'z'.
+//
+// Três layouts, escolhidos pelo número de filhos:
+//   Node4   até 4 filhos, chaves ordenadas, busca linear
+//   Node16  até 16 filhos, chaves ordenadas, busca com uma comparação SSE2
+//   Node26  acesso direto children[c] (faz o papel do Node256 do ART; com 26
+//           símbolos um Node48 intermediário não economiza nada)
+// Um nó cresce para o layout seguinte quando enche e encolhe na remoção
+// (Node26 -> Node16 com <= 12 filhos, Node16 -> Node4 com <= 3), com folga
+// para não oscilar.
+//
+// Compressão de caminho pessimista e limitada: cada nó guarda até
+// ADAPTIVE_PREFIX_MAX caracteres do caminho que o precedem, então cadeias de
+// nós de um filho só viram um único nó (ou poucos, se a cadeia for longa). A
+// marca de fim de palavra vale para a string que termina depois do prefixo.
+//
+// Referências são índices de 32 bits com o tipo do nó nos 2 bits de cima; cada
+// tipo tem sua própria arena (trie_arena.h) com lista de livres, então nós
+// liberados no crescimento/encolhimento são reaproveitados.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <emmintrin.h>
+
+#include "trie_arena.h"
+
+#define ADAPTIVE_ALPHABET 26
+
+// Caracteres de caminho comprimido por nó
+#define ADAPTIVE_PREFIX_MAX 10
+
+// Tipos de nó (2 bits de cima da referência)
+#define ADAPTIVE_NODE4 0u
+#define ADAPTIVE_NODE16 1u
+#define ADAPTIVE_NODE26 2u
+#define ADAPTIVE_NUM_TYPES 3
+
+#define ADAPTIVE_TYPE_SHIFT 30
+#define ADAPTIVE_INDEX_MASK ((1u << ADAPTIVE_TYPE_SHIFT) - 1)
+
+// Limites de encolhimento na remoção
+#define ADAPTIVE_SHRINK26 12
+#define ADAPTIVE_SHRINK16 3
+
+// Cabeçalho comum a todos os layouts
+typedef struct {
+    uint8_t num_children;
+    uint8_t prefix_len;
+    uint8_t is_end;
+    char prefix[ADAPTIVE_PREFIX_MAX];
+} AdaptiveHeader;
+
+typedef struct {
+    AdaptiveHeader h;
+    uint8_t keys[4];
+    uint32_t children[4];
+} AdaptiveNode4;
+
+typedef struct {
+    AdaptiveHeader h;
+    uint8_t keys[16];
+    uint32_t children[16];
+} AdaptiveNode16;
+
+typedef struct {
+    AdaptiveHeader h;
+    uint32_t children[ADAPTIVE_ALPHABET];
+} AdaptiveNode26;
+
+typedef struct {
+    TrieArena arenas[ADAPTIVE_NUM_TYPES];
+    uint32_t free_list[ADAPTIVE_NUM_TYPES];     // Índice do primeiro nó livre de cada tipo
+    uint32_t live[ADAPTIVE_NUM_TYPES];          // Nós em uso de cada tipo
+    uint32_t root;
+} AdaptiveTrie;
+
+// Uso de memória
+typedef struct {
+    uint32_t nodes[ADAPTIVE_NUM_TYPES];
+    size_t bytes;                   // Bytes ocupados por nós em uso
+    size_t mapped_bytes;            // Bytes mapeados pelas arenas
+    long long uncompressed_nodes;   // Nós que a Trie de layout fixo teria (um por prefixo distinto)
+} AdaptiveStats;
+
+static const size_t adaptive_node_size[ADAPTIVE_NUM_TYPES] = {
+    sizeof(AdaptiveNode4), sizeof(AdaptiveNode16), sizeof(AdaptiveNode26)
+};
+
+static inline uint32_t adaptive_type(uint32_t ref) {
+    return ref >> ADAPTIVE_TYPE_SHIFT;
+}
+
+static inline void *adaptive_node(const AdaptiveTrie *t, uint32_t ref) {
+    return trie_arena_get(&t->arenas[adaptive_type(ref)], ref & ADAPTIVE_INDEX_MASK);
+}
+
+static inline AdaptiveHeader *adaptive_header(const AdaptiveTrie *t, uint32_t ref) {
+    return (AdaptiveHeader *)adaptive_node(t, ref);
+}
+
+// Aloca um nó zerado do tipo pedido; retorna a referência ou 0 se faltar memória
+static inline uint32_t adaptive_alloc(AdaptiveTrie *t, uint32_t type) {
+    uint32_t index = t->free_list[type];
+    if (index) {
+        void *node = trie_arena_get(&t->arenas[type], index);
+        memcpy(&t->free_list[type], node, sizeof(uint32_t));
+        memset(node, 0, adaptive_node_size[type]);
+    } else {
+        index = trie_arena_alloc(&t->arenas[type]);
+        if (!index || index > ADAPTIVE_INDEX_MASK) {
+            return 0;
+        }
+    }
+    t->live[type]++;
+    return (type << ADAPTIVE_TYPE_SHIFT) | index;
+}
+
+// Devolve o nó à lista de livres do seu tipo (o próximo livre fica nos 4 primeiros bytes)
+static inline void adaptive_free(AdaptiveTrie *t, uint32_t ref) {
+    uint32_t type = adaptive_type(ref);
+    uint32_t index = ref & ADAPTIVE_INDEX_MASK;
+    memcpy(trie_arena_get(&t->arenas[type], index), &t->free_list[type], sizeof(uint32_t));
+    t->free_list[type] = index;
+    t->live[type]--;
+}
+
+// Inicializa a Trie com uma raiz vazia. Retorna 0 ou -1 se faltar memória.
+static inline int adaptive_trie_init(AdaptiveTrie *t) {
+    for (int type = 0; type < ADAPTIVE_NUM_TYPES; ++type) {
+        if (trie_arena_init(&t->arenas[type], adaptive_node_size[type]) != 0) {
+            for (int j = 0; j < type; ++j) {
+                trie_arena_destroy(&t->arenas[j]);
+            }
+            return -1;
+        }
+        t->free_list[type] = 0;
+        t->live[type] = 0;
+    }
+    t->root = adaptive_alloc(t, ADAPTIVE_NODE4);
+    if (!t->root) {
+        for (int type = 0; type < ADAPTIVE_NUM_TYPES; ++type) {
+            trie_arena_destroy(&t->arenas[type]);
+        }
+        return -1;
+    }
+    return 0;
+}
+
+// Libera todos os nós de uma vez
+static inline void adaptive_trie_destroy(AdaptiveTrie *t) {
+    for (int type = 0; type < ADAPTIVE_NUM_TYPES; ++type) {
+        trie_arena_destroy(&t->arenas[type]);
+    }
+    t->root = 0;
+}
+
+// Posição da ligação do filho c, ou NULL se não houver filho c
+static inline uint32_t *adaptive_find_child(const AdaptiveTrie *t, uint32_t ref, int c) {
+    switch (adaptive_type(ref)) {
+    case ADAPTIVE_NODE4: {
+        AdaptiveNode4 *n = adaptive_node(t, ref);
+        for (int i = 0; i < n->h.num_children; ++i) {
+            if (n->keys[i] == c) {
+                return &n->children[i];
+            }
+        }
+        return NULL;
+    }
+    case ADAPTIVE_NODE16: {
+        AdaptiveNode16 *n = adaptive_node(t, ref);
+        __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i *)n->keys));
+        unsigned mask = (unsigned)_mm_movemask_epi8(cmp) & ((1u << n->h.num_children) - 1);
+        return mask ? &n->children[__builtin_ctz(mask)] : NULL;
+    }
+    default: {
+        AdaptiveNode26 *n = adaptive_node(t, ref);
+        return n->children[c] ? &n->children[c] : NULL;
+    }
+    }
+}
+
+// Copia cabeçalho e filhos de src para o nó dst (de outro tipo) e libera src
+static inline void adaptive_move(AdaptiveTrie *t, uint32_t src, uint32_t dst) {
+    AdaptiveHeader *sh = adaptive_header(t, src);
+    uint8_t keys[ADAPTIVE_ALPHABET];
+    uint32_t children[ADAPTIVE_ALPHABET];
+    int n = 0;
+
+    // Filhos de src em ordem de chave
+    switch (adaptive_type(src)) {
+    case ADAPTIVE_NODE4: {
+        AdaptiveNode4 *s = (AdaptiveNode4 *)sh;
+        for (n = 0; n < s->h.num_children; ++n) {
+            keys[n] = s->keys[n];
+            children[n] = s->children[n];
+        }
+        break;
+    }
+    case ADAPTIVE_NODE16: {
+        AdaptiveNode16 *s = (AdaptiveNode16 *)sh;
+        for (n = 0; n < s->h.num_children; ++n) {
+            keys[n] = s->keys[n];
+            children[n] = s->children[n];
+        }
+        break;
+    }
+    default: {
+        AdaptiveNode26 *s = (AdaptiveNode26 *)sh;
+        for (int c = 0; c < ADAPTIVE_ALPHABET; ++c) {
+            if (s->children[c]) {
+                keys[n] = (uint8_t)c;
+                children[n++] = s->children[c];
+            }
+        }
+        break;
+    }
+    }
+
+    AdaptiveHeader *dh = adaptive_header(t, dst);
+    *dh = *sh;
+    switch (adaptive_type(dst)) {
+    case ADAPTIVE_NODE4: {
+        AdaptiveNode4 *d = (AdaptiveNode4 *)dh;
+        memcpy(d->keys, keys, (size_t)n);
+        memcpy(d->children, children, (size_t)n * sizeof(uint32_t));
+        break;
+    }
+    case ADAPTIVE_NODE16: {
+        AdaptiveNode16 *d = (AdaptiveNode16 *)dh;
+        memcpy(d->keys, keys, (size_t)n);
+        memcpy(d->children, children, (size_t)n * sizeof(uint32_t));
+        break;
+    }
+    default: {
+        AdaptiveNode26 *d = (AdaptiveNode26 *)dh;
+        for (int i = 0; i < n; ++i) {
+            d->children[keys[i]] = children[i];
+        }
+        break;
+    }
+    }
+    adaptive_free(t, src);
+}
+
+// Insere em keys/children ordenados de capacidade suficiente
+static inline void adaptive_sorted_insert(uint8_t *keys, uint32_t *children, int n, int c, uint32_t child) {
+    int pos = 0;
+    while (pos < n && keys[pos] < c) {
+        pos++;
+    }
+    memmove(&keys[pos + 1], &keys[pos], (size_t)(n - pos));
+    memmove(&children[pos + 1], &children[pos], (size_t)(n - pos) * sizeof(uint32_t));
+    keys[pos] = (uint8_t)c;
+    children[pos] = child;
+}
+
+// Acrescenta o filho c ao nó *ref_ptr, crescendo o layout se ele estiver cheio.
+// Retorna 0 ou -1 se faltar memória.
+static inline int adaptive_add_child(AdaptiveTrie *t, uint32_t *ref_ptr, int c, uint32_t child) {
+    uint32_t ref = *ref_ptr;
+    AdaptiveHeader *h = adaptive_header(t, ref);
+    uint32_t type = adaptive_type(ref);
+
+    if ((type == ADAPTIVE_NODE4 && h->num_children == 4) || (type == ADAPTIVE_NODE16 && h->num_children == 16)) {
+        uint32_t grown = adaptive_alloc(t, type + 1);
+        if (!grown) {
+            return -1;
+        }
+        adaptive_move(t, ref, grown);
+        *ref_ptr = ref = grown;
+        h = adaptive_header(t, ref);
+        type++;
+    }
+
+    if (type == ADAPTIVE_NODE4) {
+        AdaptiveNode4 *n = (AdaptiveNode4 *)h;
+        adaptive_sorted_insert(n->keys, n->children, h->num_children, c, child);
+    } else if (type == ADAPTIVE_NODE16) {
+        AdaptiveNode16 *n = (AdaptiveNode16 *)h;
+        adaptive_sorted_insert(n->keys, n->children, h->num_children, c, child);
+    } else {
+        ((AdaptiveNode26 *)h)->children[c] = child;
+    }
+    h->num_children++;
+    return 0;
+}
+
+// Remove o filho c do nó *ref_ptr, encolhendo o layout se ele ficar esparso
+static inline void adaptive_remove_child(AdaptiveTrie *t, uint32_t *ref_ptr, int c) {
+    uint32_t ref = *ref_ptr;
+    AdaptiveHeader *h = adaptive_header(t, ref);
+    uint32_t type = adaptive_type(ref);
+
+    if (type == ADAPTIVE_NODE26) {
+        ((AdaptiveNode26 *)h)->children[c] = 0;
+    } else {
+        uint8_t *keys = type == ADAPTIVE_NODE4 ? ((AdaptiveNode4 *)h)->keys : ((AdaptiveNode16 *)h)->keys;
+        uint32_t *children = type == ADAPTIVE_NODE4 ? ((AdaptiveNode4 *)h)->children
+                                                    : ((AdaptiveNode16 *)h)->children;
+        int pos = 0;
+        while (keys[pos] != c) {
+            pos++;
+        }
+        memmove(&keys[pos], &keys[pos + 1], (size_t)(h->num_children - pos - 1));
+        memmove(&children[pos], &children[pos + 1], (size_t)(h->num_children - pos - 1) * sizeof(uint32_t));
+    }
+    h->num_children--;
+
+    uint32_t smaller = 0;
+    if (type == ADAPTIVE_NODE26 && h->num_children <= ADAPTIVE_SHRINK26) {
+        smaller = adaptive_alloc(t, ADAPTIVE_NODE16);
+    } else if (type == ADAPTIVE_NODE16 && h->num_children <= ADAPTIVE_SHRINK16) {
+        smaller = adaptive_alloc(t, ADAPTIVE_NODE4);
+    }
+    // Sem memória para o nó menor, o nó atual continua válido
+    if (smaller) {
+        adaptive_move(t, ref, smaller);
+        *ref_ptr = smaller;
+    }
+}
+
+// Cria a cadeia de nós para o sufixo s[0..n) com fim de palavra no último.
+// Retorna a referência do primeiro nó ou 0 se faltar memória.
+static inline uint32_t adaptive_make_chain(AdaptiveTrie *t, const char *s, int n) {
+    uint32_t ref = adaptive_alloc(t, ADAPTIVE_NODE4);
+    if (!ref) {
+        return 0;
+    }
+    AdaptiveNode4 *node = adaptive_node(t, ref);
+    int take = n < ADAPTIVE_PREFIX_MAX ? n : ADAPTIVE_PREFIX_MAX;
+    memcpy(node->h.prefix, s, (size_t)take);
+    node->h.prefix_len = (uint8_t)take;
+
+    if (take == n) {
+        node->h.is_end = 1;
+        return ref;
+    }
+
+    // Resto da cadeia: o caractere seguinte vira a aresta para o próximo nó
+    uint32_t next = adaptive_make_chain(t, s + take + 1, n - take - 1);
+    if (!next) {
+        adaptive_free(t, ref);
+        return 0;
+    }
+    node = adaptive_node(t, ref);
+    node->keys[0] = (uint8_t)(s[take] - 'a');
+    node->children[0] = next;
+    node->h.num_children = 1;
+    return ref;
+}
+
+// Verifica se todos os caracteres estão no alfabeto
+static inline bool adaptive_valid_key(const char *key, int len) {
+    for (int i = 0; i < len; ++i) {
+        if (key[i] < 'a' || key[i] > 'z') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Insere key[0..len). Chaves com caracteres fora de 'a'-'z' são ignoradas,
+// como na Trie de layout fixo. Retorna 0 ou -1 se faltar memória.
+static inline int adaptive_trie_insert_len(AdaptiveTrie *t, const char *key, int len) {
+    if (!adaptive_valid_key(key, len)) {
+        return 0;
+    }
+
+    uint32_t *ref_ptr = &t->root;
+    int i = 0;
+
+    for (;;) {
+        uint32_t ref = *ref_ptr;
+        AdaptiveHeader *h = adaptive_header(t, ref);
+
+        int p = 0;
+        while (p < h->prefix_len && i + p < len && h->prefix[p] == key[i + p]) {
+            p++;
+        }
+
+        // A chave diverge no meio do prefixo: divide o nó em p
+        if (p < h->prefix_len) {
+            uint32_t parent = adaptive_alloc(t, ADAPTIVE_NODE4);
+            if (!parent) {
+                return -1;
+            }
+            h = adaptive_header(t, ref);
+            AdaptiveNode4 *pn = adaptive_node(t, parent);
+            memcpy(pn->h.prefix, h->prefix, (size_t)p);
+            pn->h.prefix_len = (uint8_t)p;
+            pn->keys[0] = (uint8_t)(h->prefix[p] - 'a');
+            pn->children[0] = ref;
+            pn->h.num_children = 1;
+
+            memmove(h->prefix, h->prefix + p + 1, (size_t)(h->prefix_len - p - 1));
+            h->prefix_len = (uint8_t)(h->prefix_len - p - 1);
+
+            *ref_ptr = ref = parent;
+            h = &pn->h;
+        }
+
+        i += h->prefix_len;
+        if (i == len) {
+            h->is_end = 1;
+            return 0;
+        }
+
+        int c = key[i] - 'a';
+        uint32_t *child = adaptive_find_child(t, ref, c);
+        if (!child) {
+            uint32_t leaf = adaptive_make_chain(t, key + i + 1, len - i - 1);
+            if (!leaf) {
+                return -1;
+            }
+            if (adaptive_add_child(t, ref_ptr, c, leaf) != 0) {
+                return -1;
+            }
+            return 0;
+        }
+        ref_ptr = child;
+        i++;
+    }
+}
+
+static inline int adaptive_trie_insert(AdaptiveTrie *t, const char *key) {
+    return adaptive_trie_insert_len(t, key, (int)strlen(key));
+}
+
+// Retorna true se key[0..len) foi inserida como palavra completa
+static inline bool adaptive_trie_search_len(const AdaptiveTrie *t, const char *key, int len) {
+    uint32_t ref = t->root;
+    int i = 0;
+
+    for (;;) {
+        const AdaptiveHeader *h = adaptive_header(t, ref);
+        if (len - i < h->prefix_len || memcmp(key + i, h->prefix, h->prefix_len) != 0) {
+            return false;
+        }
+        i += h->prefix_len;
+        if (i == len) {
+            return h->is_end;
+        }
+
+        int c = key[i] - 'a';
+        if (c < 0 || c >= ADAPTIVE_ALPHABET) {
+            return false;
+        }
+        uint32_t *child = adaptive_find_child(t, ref, c);
+        if (!child) {
+            return false;
+        }
+        ref = *child;
+        i++;
+    }
+}
+
+static inline bool adaptive_trie_search(const AdaptiveTrie *t, const char *key) {
+    return adaptive_trie_search_len(t, key, (int)strlen(key));
+}
+
+// Primeiro (e único) filho de um nó com um filho só, com a sua chave
+static inline uint32_t adaptive_only_child(const AdaptiveTrie *t, uint32_t ref, int *c) {
+    void *node = adaptive_node(t, ref);
+    switch (adaptive_type(ref)) {
+    case ADAPTIVE_NODE4:
+        *c = ((AdaptiveNode4 *)node)->keys[0];
+        return ((AdaptiveNode4 *)node)->children[0];
+    case ADAPTIVE_NODE16:
+        *c = ((AdaptiveNode16 *)node)->keys[0];
+        return ((AdaptiveNode16 *)node)->children[0];
+    default:
+        for (*c = 0; *c < ADAPTIVE_ALPHABET; ++*c) {
+            if (((AdaptiveNode26 *)node)->children[*c]) {
+                return ((AdaptiveNode26 *)node)->children[*c];
+            }
+        }
+        return 0;
+    }
+}
+
+// Depois de uma remoção: apaga o nó se ficou vazio, ou o funde com o único
+// filho se o prefixo combinado couber (refaz a compressão de caminho)
+static inline void adaptive_compact(AdaptiveTrie *t, uint32_t *ref_ptr) {
+    uint32_t ref = *ref_ptr;
+    AdaptiveHeader *h = adaptive_header(t, ref);
+    if (h->is_end) {
+        return;
+    }
+
+    if (h->num_children == 0) {
+        adaptive_free(t, ref);
+        *ref_ptr = 0;
+        return;
+    }
+
+    if (h->num_children == 1) {
+        int c;
+        uint32_t child = adaptive_only_child(t, ref, &c);
+        AdaptiveHeader *ch = adaptive_header(t, child);
+        int merged = h->prefix_len + 1 + ch->prefix_len;
+        if (merged <= ADAPTIVE_PREFIX_MAX) {
+            char prefix[ADAPTIVE_PREFIX_MAX];
+            memcpy(prefix, h->prefix, h->prefix_len);
+            prefix[h->prefix_len] = (char)('a' + c);
+            memcpy(prefix + h->prefix_len + 1, ch->prefix, ch->prefix_len);
+            memcpy(ch->prefix, prefix, (size_t)merged);
+            ch->prefix_len = (uint8_t)merged;
+            adaptive_free(t, ref);
+            *ref_ptr = child;
+        }
+    }
+}
+
+static inline bool adaptive_delete_rec(AdaptiveTrie *t, uint32_t *ref_ptr, const char *key, int len, int i) {
+    uint32_t ref = *ref_ptr;
+    AdaptiveHeader *h = adaptive_header(t, ref);
+    if (len - i < h->prefix_len || memcmp(key + i, h->prefix, h->prefix_len) != 0) {
+        return false;
+    }
+    i += h->prefix_len;
+
+    if (i == len) {
+        if (!h->is_end) {
+            return false;
+        }
+        h->is_end = 0;
+    } else {
+        int c = key[i] - 'a';
+        if (c < 0 || c >= ADAPTIVE_ALPHABET) {
+            return false;
+        }
+        uint32_t *child = adaptive_find_child(t, ref, c);
+        if (!child || !adaptive_delete_rec(t, child, key, len, i + 1)) {
+            return false;
+        }
+        // O filho ficou vazio e foi liberado
+        if (*child == 0) {
+            adaptive_remove_child(t, ref_ptr, c);
+        }
+    }
+
+    if (ref_ptr != &t->root) {
+        adaptive_compact(t, ref_ptr);
+    }
+    return true;
+}
+
+// Remove key[0..len). Retorna true se a palavra estava na Trie.
+static inline bool adaptive_trie_delete_len(AdaptiveTrie *t, const char *key, int len) {
+    return adaptive_delete_rec(t, &t->root, key, len, 0);
+}
+
+static inline bool adaptive_trie_delete(AdaptiveTrie *t, const char *key) {
+    return adaptive_trie_delete_len(t, key, (int)strlen(key));
+}
+
+static inline long long adaptive_count_uncompressed(const AdaptiveTrie *t, uint32_t ref) {
+    const AdaptiveHeader *h = adaptive_header(t, ref);
+    long long total = h->prefix_len;
+    for (int c = 0; c < ADAPTIVE_ALPHABET; ++c) {
+        uint32_t *child = adaptive_find_child(t, ref, c);
+        if (child) {
+            total += 1 + adaptive_count_uncompressed(t, *child);
+        }
+    }
+    return total;
+}
+
+// Conta nós por tipo e bytes; uncompressed_nodes percorre a Trie inteira
+static inline void adaptive_trie_stats(const AdaptiveTrie *t, AdaptiveStats *stats) {
+    stats->bytes = 0;
+    stats->mapped_bytes = 0;
+    for (int type = 0; type < ADAPTIVE_NUM_TYPES; ++type) {
+        stats->nodes[type] = t->live[type];
+        stats->bytes += (size_t)t->live[type] * adaptive_node_size[type];
+        stats->mapped_bytes += trie_arena_mapped_bytes(&t->arenas[type]);
+    }
+    // Raiz mais um nó por caractere de aresta ou de prefixo
+    stats->uncompressed_nodes = 1 + adaptive_count_uncompressed(t, t->root);
+}
+
+#endif // ADAPTIVE_TRIE_H
@@ -0,0 +1,278 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "../common/affinity.h"
+#include "trie.h"
+#include "trie_loader.h"
+#include "aho_corasick.h"
+#include "palavras.h"
+
+// Repetições padrão de cada medição (vale a mediana)
+#define DEFAULT_REPEATS 3
+
+// Texto sintético padrão, em MB, quando -t não é usado
+#define DEFAULT_TEXT_MB 256
+
+// Bloco da varredura em fluxo (simula leituras de um arquivo ou socket)
+#define STREAM_BLOCK (64u << 10)
+
+// Trecho do texto comparado com a busca de todas as substrings
+#define NAIVE_BYTES (1u << 20)
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *times, int n) {
+    qsort(times, (size_t)n, sizeof(double), cmp_double);
+    return n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+}
+
+// Texto de bytes letras minúsculas com um espaço a cada 8 caracteres em média
+static char *generateText(size_t bytes) {
+    char *text = malloc(bytes);
+    if (!text) {
+        return NULL;
+    }
+    uint64_t x = 0x2545F4914F6CDD1DULL;
+    for (size_t i = 0; i < bytes; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        text[i] = x % 8 == 0 ? ' ' : (char)('a' + (x >> 8) % 26);
+    }
+    return text;
+}
+
+// Confere cada ocorrência entregue pela varredura com searchLen
+typedef struct {
+    const struct Trie *trie;
+    const char *text;
+    uint64_t reported;
+    uint64_t wrong;
+} CheckArgs;
+
+static void check_match(void *ctx, uint64_t end, uint32_t len) {
+    CheckArgs *args = ctx;
+    args->reported++;
+    args->wrong += !searchLen(args->trie, args->text + end - len, len);
+}
+
+int main(int argc, char *argv[]) {
+    AffinityPolicy policy = AFFINITY_NONE;
+    long long synthetic = 0;        // -n: padrões sintéticos em vez da lista fixa
+    const char *dict_path = NULL;   // -d: padrões (uma palavra por linha, "-" = entrada padrão)
+    const char *text_path = NULL;   // -t: texto a varrer
+    long long text_mb = DEFAULT_TEXT_MB;    // -m: tamanho do texto sintético
+    int repeats = DEFAULT_REPEATS;
+    int max_threads = 1;            // -p: máximo de threads da varredura paralela
+    int opt;
+    while ((opt = getopt(argc, argv, "a:n:d:t:m:r:p:")) != -1) {
+        if (opt == 'a' && affinity_parse_policy(optarg, &policy) == 0) {
+            continue;
+        }
+        if (opt == 'n' && (synthetic = atoll(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'd' || opt == 't') {
+            *(opt == 'd' ? &dict_path : &text_path) = optarg;
+            continue;
+        }
+        if (opt == 'm' && (text_mb = atoll(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'r' && (repeats = atoi(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'p' && (max_threads = atoi(optarg)) > 0) {
+            continue;
+        }
+        fprintf(stderr, "Uso: %s [-a none|compact|scatter|physical] [-n padrões sintéticos | -d padrões] "
+                "[-t texto | -m MB de texto sintético] [-r repetições] [-p máximo de threads]\n", argv[0]);
+        return 1;
+    }
+
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    if (affinity_read_topology(&topo) != 0 || affinity_plan(&topo, policy, max_threads, &plan) != 0
+        || affinity_pin_self(&plan, 0) != 0) {
+        perror("Falha ao aplicar a afinidade");
+        return 1;
+    }
+    affinity_print(stdout, &topo, &plan);
+
+    struct timespec t0, t1;
+
+    // --- Padrões: a Trie de sempre ---
+    struct Trie trie;
+    if (initTrie(&trie) != 0) {
+        perror("Falha ao criar a Trie");
+        return 1;
+    }
+    long long num_words = sizeof(words) / sizeof(words[0]);
+    long long *synthetic_offsets = NULL;
+    char *synthetic_words = NULL;
+    TrieInput dict_input = {0};
+    TrieTokens dict = {0};
+    if (dict_path) {
+        if (trie_input_open(dict_path, &dict_input) != 0
+            || trie_tokenize(&dict_input, max_threads, &plan, &dict) != 0) {
+            perror("Falha ao ler os padrões");
+            return 1;
+        }
+        num_words = (long long)dict.count;
+    } else if (synthetic > 0) {
+        synthetic_words = generateWords(synthetic, &synthetic_offsets);
+        if (!synthetic_words) {
+            perror("Falha ao gerar os padrões sintéticos");
+            return 1;
+        }
+        num_words = synthetic;
+    }
+    for (long long i = 0; i < num_words; i++) {
+        if (dict.tokens) {
+            trie_token_count(&dict.tokens[i]);
+            insertLen(&trie, dict.tokens[i].key, dict.tokens[i].len);
+        } else {
+            insert(&trie, synthetic_words ? synthetic_words + synthetic_offsets[i] : words[i]);
+        }
+    }
+
+    // --- Construção do autômato ---
+    struct AhoCorasick ac;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (acBuild(&trie, &ac) != 0) {
+        perror("Falha ao construir o autômato");
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("Autômato: %u padrões, %u estados, maior padrão com %u letras; tabela de transições de %.1f MB, "
+           "construída em %.6f segundos\n", ac.numPatterns, ac.numStates, ac.maxPatternLen,
+           (double)ac.numStates * ALPHABET_SIZE * sizeof(uint32_t) / 1e6, elapsed(&t0, &t1));
+
+    // --- Texto ---
+    TrieInput text_input = {0};
+    char *synthetic_text = NULL;
+    const char *text;
+    size_t text_len;
+    if (text_path) {
+        if (trie_input_open(text_path, &text_input) != 0) {
+            perror("Falha ao ler o texto");
+            return 1;
+        }
+        text = text_input.data;
+        text_len = text_input.length;
+    } else {
+        text_len = (size_t)text_mb << 20;
+        synthetic_text = generateText(text_len);
+        if (!synthetic_text) {
+            perror("Falha ao gerar o texto");
+            return 1;
+        }
+        text = synthetic_text;
+    }
+    printf("Texto: %.1f MB (%s)\n\n", text_len / 1e6, text_path ? text_path : "sintético");
+
+    int errors = 0;
+    double *times = malloc((size_t)repeats * sizeof(double));
+    if (!times) {
+        perror("Erro de alocação");
+        return 1;
+    }
+
+    // --- Varredura sequencial, de uma vez e em blocos ---
+    uint64_t matches = 0;
+    for (int r = 0; r < repeats; r++) {
+        struct AcScanner scanner;
+        acScannerInit(&scanner, &ac);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        matches = acScan(&scanner, text, text_len, NULL, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        times[r] = elapsed(&t0, &t1);
+    }
+    double seq_time = median(times, repeats);
+    printf("Sequencial: %llu ocorrências em %.6f segundos (%.3f GB/s)\n", (unsigned long long)matches,
+           seq_time, text_len / seq_time / 1e9);
+
+    struct AcScanner scanner;
+    acScannerInit(&scanner, &ac);
+    uint64_t streamed = 0;
+    for (size_t pos = 0; pos < text_len; pos += STREAM_BLOCK) {
+        size_t len = text_len - pos < STREAM_BLOCK ? text_len - pos : STREAM_BLOCK;
+        streamed += acScan(&scanner, text + pos, len, NULL, NULL);
+    }
+    printf("Em blocos de %u KB: %llu ocorrências (%s)\n\n", STREAM_BLOCK >> 10, (unsigned long long)streamed,
+           streamed == matches ? "iguais" : "DIFERENTES");
+    errors += streamed != matches;
+
+    // --- Varredura paralela: 1, 2, 4, ... e o máximo ---
+    printf("%8s %14s %10s %9s %10s\n", "threads", "tempo_s", "GB/s", "speedup", "eficiência");
+    for (int t = 1; t <= max_threads; t = t < max_threads && t * 2 > max_threads ? max_threads : t * 2) {
+        uint64_t found = 0;
+        for (int r = 0; r < repeats; r++) {
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            int ret = acScanParallel(&ac, text, text_len, t, &plan, NULL, NULL, &found);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            if (ret != 0) {
+                errno = ret;
+                perror("Falha na varredura paralela");
+                return 1;
+            }
+            times[r] = elapsed(&t0, &t1);
+        }
+        double par_time = median(times, repeats);
+        printf("%8d %14.6f %10.3f %9.2f %9.1f%%\n", t, par_time, text_len / par_time / 1e9,
+               seq_time / par_time, 100.0 * seq_time / par_time / t);
+        errors += found != matches;
+    }
+
+    // --- Como era antes: searchLen em cada substring de um trecho ---
+    size_t naive_len = text_len < NAIVE_BYTES ? text_len : NAIVE_BYTES;
+    uint64_t naive = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0; i < naive_len; i++) {
+        for (size_t len = 1; len <= ac.maxPatternLen && i + len <= naive_len; len++) {
+            naive += searchLen(&trie, text + i, len);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double naive_time = elapsed(&t0, &t1);
+
+    CheckArgs check = {&trie, text, 0, 0};
+    acScannerInit(&scanner, &ac);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t slice = acScan(&scanner, text, naive_len, check_match, &check);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("\nTrecho de %.1f MB: searchLen em cada substring acha %llu em %.6f segundos (%.3f GB/s); "
+           "o autômato com callback acha %llu em %.6f segundos (%llu não conferem)\n", naive_len / 1e6,
+           (unsigned long long)naive, naive_time, naive_len / naive_time / 1e9, (unsigned long long)slice,
+           elapsed(&t0, &t1), (unsigned long long)check.wrong);
+    errors += naive != slice || check.reported != slice || check.wrong > 0;
+
+    printf("Verificação: %s (%d divergências)\n", errors ? "FALHOU" : "ok", errors);
+
+    free(times);
+    free(synthetic_text);
+    trie_input_close(&text_input);
+    acFree(&ac);
+    freeTrie(&trie);
+    trie_tokens_free(&dict);
+    trie_input_close(&dict_input);
+    free(synthetic_words);
+    free(synthetic_offsets);
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
+    return errors ? 1 : 0;
+}
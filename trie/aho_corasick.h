@@ -0,0 +1,258 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+// Autômato de Aho-Corasick construído a partir de uma Trie (trie.h): acha
+// todas as ocorrências de todas as palavras do dicionário num texto, numa
+// única passada, em vez de chamar searchLen para cada substring.
+//
+// Os estados são os nós da Trie, renumerados em largura (a raiz é o estado 0,
+// e os estados rasos, os mais visitados, ficam juntos no começo da tabela).
+// Para cada estado guardamos:
+//   fail    o estado do maior sufixo próprio que também é prefixo de alguma palavra
+//   output  o estado-palavra mais próximo na cadeia de fail (0 = nenhum)
+// e, a partir deles, a tabela densa de transições delta[estado][letra] já
+// resolvida (nenhuma cadeia de fail é seguida durante a varredura). O laço
+// quente é uma leitura na tabela por byte. Cada entrada guarda o início da
+// linha do destino (estado * ALPHABET_SIZE), o que tira a multiplicação da
+// cadeia de dependência entre um byte e o próximo, e o bit AC_MATCH indica se
+// algum padrão termina no destino, para que o texto sem ocorrências não
+// precise tocar em nenhum outro vetor. A tabela é mapeada como um bloco da
+// arena (alinhada em 2 MB, com MADV_HUGEPAGE): com dicionários grandes ela
+// passa de centenas de MB, e os acessos aleatórios custam faltas de TLB.
+//
+// Os vínculos ficam em vetores do autômato, e não em struct TrieNode: eles só
+// valem para a Trie do momento da construção, e a Trie continua aceitando
+// inserções. Caracteres fora de 'a'-'z' separam palavras (voltam à raiz).
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "trie.h"
+#include "../common/affinity.h"
+
+// Bit de "algum padrão termina aqui" nas entradas de delta
+#define AC_MATCH 0x80000000u
+#define AC_STATE_MASK 0x7FFFFFFFu
+
+struct AhoCorasick {
+    uint32_t *delta;        // numStates * ALPHABET_SIZE transições (linha do destino | AC_MATCH)
+    size_t deltaBytes;      // Tamanho do mapeamento de delta
+    uint32_t *fail;
+    uint32_t *output;
+    uint32_t *wordLen;      // Comprimento da palavra que termina no estado (0 = nenhuma)
+    uint32_t *matchCount;   // Padrões que terminam no estado, seguindo output
+    uint32_t numStates;
+    uint32_t numPatterns;
+    uint32_t maxPatternLen;
+};
+
+// Chamada para cada ocorrência: o padrão ocupa text[end - len, end)
+typedef void (*AcMatchFn)(void *ctx, uint64_t end, uint32_t len);
+
+// Varredura em andamento: a linha do estado e quantos bytes já foram lidos, para que o
+// texto possa chegar em pedaços (ocorrências que cruzam pedaços são achadas)
+struct AcScanner {
+    const struct AhoCorasick *ac;
+    uint32_t row;
+    uint64_t offset;
+};
+
+static inline void acFree(struct AhoCorasick *ac) {
+    if (ac->delta) {
+        munmap(ac->delta, ac->deltaBytes);
+    }
+    free(ac->fail);
+    free(ac->output);
+    free(ac->wordLen);
+    free(ac->matchCount);
+    memset(ac, 0, sizeof(*ac));
+}
+
+// Constrói o autômato com as palavras da Trie. Retorna 0 ou -1 (errno =
+// ENOMEM, ou EOVERFLOW se a tabela não couber em índices de 31 bits).
+static inline int acBuild(const struct Trie *trie, struct AhoCorasick *ac) {
+    memset(ac, 0, sizeof(*ac));
+    uint32_t numNodes = trie_arena_count(&trie->arena);
+    if ((uint64_t)numNodes * ALPHABET_SIZE > AC_STATE_MASK) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    uint32_t *queue = malloc((size_t)numNodes * sizeof(uint32_t));     // Nó da Trie de cada estado
+    // Múltiplo da página, como o trie_arena_map_chunk exige (e o acFree desmapeia)
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    ac->deltaBytes = ((size_t)numNodes * ALPHABET_SIZE * sizeof(uint32_t) + page - 1) / page * page;
+    ac->delta = (uint32_t *)trie_arena_map_chunk(ac->deltaBytes);
+    ac->fail = malloc((size_t)numNodes * sizeof(uint32_t));
+    ac->output = malloc((size_t)numNodes * sizeof(uint32_t));
+    ac->wordLen = malloc((size_t)numNodes * sizeof(uint32_t));
+    ac->matchCount = malloc((size_t)numNodes * sizeof(uint32_t));
+    if (!queue || !ac->delta || !ac->fail || !ac->output || !ac->wordLen || !ac->matchCount) {
+        free(queue);
+        acFree(ac);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // Renumeração em largura. Como o pai sai da fila antes dos filhos, o fail
+    // de cada estado (mais raso que ele) já está pronto quando o estado é
+    // processado. A profundidade de cada estado vai em wordLen por enquanto.
+    queue[0] = trie->root;
+    ac->fail[0] = 0;
+    ac->wordLen[0] = 0;
+    uint32_t tail = 1;
+    for (uint32_t s = 0; s < tail; s++) {
+        const struct TrieNode *node = NODE(trie, queue[s]);
+        uint32_t depth = ac->wordLen[s];
+        uint32_t *row = &ac->delta[(size_t)s * ALPHABET_SIZE];
+        const uint32_t *failRow = &ac->delta[(size_t)ac->fail[s] * ALPHABET_SIZE];
+        for (int c = 0; c < ALPHABET_SIZE; c++) {
+            if (node->children[c]) {
+                uint32_t child = tail++;
+                queue[child] = node->children[c];
+                ac->wordLen[child] = depth + 1;
+                // Filhos da raiz voltam para a raiz; os demais seguem a transição do fail do pai
+                ac->fail[child] = s == 0 ? 0 : failRow[c] & AC_STATE_MASK;
+                row[c] = child;
+            } else {
+                row[c] = s == 0 ? 0 : failRow[c];
+            }
+        }
+    }
+    ac->numStates = tail;
+
+    // Segunda passada, de novo em largura: palavras, cadeias de saída e o bit
+    // AC_MATCH (que depende do fail do destino, já resolvido aqui)
+    for (uint32_t s = 0; s < tail; s++) {
+        const struct TrieNode *node = NODE(trie, queue[s]);
+        uint32_t depth = ac->wordLen[s];
+        bool isWord = s != 0 && node->isEndOfWord;
+        uint32_t f = ac->fail[s];
+        ac->output[s] = s == 0 ? 0 : (ac->wordLen[f] && f != 0 ? f : ac->output[f]);
+        ac->matchCount[s] = (isWord ? 1 : 0) + (s == 0 ? 0 : ac->matchCount[ac->output[s]]);
+        // wordLen do fail já foi convertido (o fail é mais raso e foi processado antes)
+        ac->wordLen[s] = isWord ? depth : 0;
+        ac->numPatterns += isWord;
+        if (isWord && depth > ac->maxPatternLen) {
+            ac->maxPatternLen = depth;
+        }
+    }
+    for (size_t i = 0; i < (size_t)tail * ALPHABET_SIZE; i++) {
+        uint32_t target = ac->delta[i];
+        ac->delta[i] = target * ALPHABET_SIZE | (ac->matchCount[target] ? AC_MATCH : 0);
+    }
+
+    free(queue);
+    return 0;
+}
+
+static inline void acScannerInit(struct AcScanner *scanner, const struct AhoCorasick *ac) {
+    scanner->ac = ac;
+    scanner->row = 0;
+    scanner->offset = 0;
+}
+
+// Lê os próximos len bytes do texto. Com fn == NULL só conta as ocorrências.
+// Retorna quantas ocorrências terminam neste pedaço.
+static inline uint64_t acScan(struct AcScanner *scanner, const char *text, size_t len, AcMatchFn fn, void *ctx) {
+    const struct AhoCorasick *ac = scanner->ac;
+    const uint32_t *delta = ac->delta;
+    uint32_t row = scanner->row;
+    uint64_t matches = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned index = (unsigned char)text[i] - 'a';
+        if (index >= ALPHABET_SIZE) {
+            row = 0;
+            continue;
+        }
+        uint32_t next = delta[row + index];
+        row = next & AC_STATE_MASK;
+        if (next & AC_MATCH) {
+            // A divisão por constante só acontece quando há ocorrência
+            uint32_t state = row / ALPHABET_SIZE;
+            if (!fn) {
+                matches += ac->matchCount[state];
+                continue;
+            }
+            for (uint32_t s = ac->wordLen[state] ? state : ac->output[state]; s; s = ac->output[s]) {
+                fn(ctx, scanner->offset + i + 1, ac->wordLen[s]);
+                matches++;
+            }
+        }
+    }
+
+    scanner->row = row;
+    scanner->offset += len;
+    return matches;
+}
+
+// Pedaço de uma varredura paralela: ocorrências que terminam em [begin, end)
+typedef struct {
+    const struct AhoCorasick *ac;
+    const char *text;
+    size_t begin;
+    size_t end;
+    AcMatchFn fn;
+    void *ctx;
+    uint64_t matches;
+} AcChunkArgs;
+
+static inline void *acScanChunk(void *arg) {
+    AcChunkArgs *args = arg;
+    // Começa maxPatternLen - 1 bytes antes: toda ocorrência que termina no
+    // pedaço começa dentro da sobreposição, e nenhuma é contada duas vezes
+    // porque as ocorrências lidas nela terminam antes de begin
+    size_t overlap = args->ac->maxPatternLen ? args->ac->maxPatternLen - 1 : 0;
+    size_t start = args->begin > overlap ? args->begin - overlap : 0;
+
+    struct AcScanner scanner;
+    acScannerInit(&scanner, args->ac);
+    scanner.offset = start;
+    acScan(&scanner, args->text + start, args->begin - start, NULL, NULL);
+    args->matches = acScan(&scanner, args->text + args->begin, args->end - args->begin, args->fn, args->ctx);
+    return NULL;
+}
+
+// Varre text em numThreads pedaços, com threads posicionadas por plan (pode
+// ser NULL). fn (pode ser NULL) é chamada pelas várias threads ao mesmo tempo,
+// com as ocorrências de cada pedaço em ordem. Retorna 0 ou um código de erro.
+static inline int acScanParallel(const struct AhoCorasick *ac, const char *text, size_t len, int numThreads,
+                                 const AffinityPlan *plan, AcMatchFn fn, void *ctx, uint64_t *matches) {
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    pthread_t *handles = malloc((size_t)numThreads * sizeof(pthread_t));
+    AcChunkArgs *args = malloc((size_t)numThreads * sizeof(AcChunkArgs));
+    if (!handles || !args) {
+        free(handles);
+        free(args);
+        return ENOMEM;
+    }
+
+    int ret = 0;
+    int created = 0;
+    for (; created < numThreads; created++) {
+        args[created] = (AcChunkArgs){ac, text, len / numThreads * created,
+                                      created == numThreads - 1 ? len : len / numThreads * (created + 1),
+                                      fn, ctx, 0};
+        ret = affinity_thread_create(&handles[created], plan, created, acScanChunk, &args[created]);
+        if (ret != 0) {
+            break;
+        }
+    }
+    uint64_t total = 0;
+    for (int t = 0; t < created; t++) {
+        pthread_join(handles[t], NULL);
+        total += args[t].matches;
+    }
+    *matches = total;
+    free(handles);
+    free(args);
+    return ret;
+}
+
+#endif // AHO_CORASICK_H
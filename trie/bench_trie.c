@@ -0,0 +1,742 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "../common/affinity.h"
+#include "trie.h"
+#include "adaptive_trie.h"
+#include "concurrent_trie.h"
+#include "trie_snapshot.h"
+#include "palavras.h"
+
+// Bancada de medição das Tries: as mesmas cargas para todas as variantes,
+// cada uma atrás de uma interface comum (BenchImpl).
+//
+// Cargas (chaves, consultas):
+//   uniforme     chaves aleatórias de 3 a 12 letras, consultas uniformes
+//   zipf         as mesmas chaves, consultas com distribuição de Zipf
+//   prefixo      chaves longas com poucos prefixos compartilhados, consultas de Zipf
+// Uma fração 1 - hit ratio das consultas é de chaves ausentes (uma chave
+// presente com a última letra trocada, conferida na Trie de referência).
+//
+// Para cada variante: vazão de inserção, latência de cada busca (histograma
+// com p50/p99/p999, descontado o custo do relógio), vazão sustentada de busca
+// com 1 e com -p threads, nós e bytes por chave. As respostas de todas as
+// buscas são conferidas com a contagem esperada.
+//
+// Bytes por chave saem em duas colunas: bytes/ch conta só o que os nós (ou
+// as células do retrato) ocupam; mapa/ch, o que a variante reservou de fato
+// (blocos inteiros das arenas, a imagem inteira do retrato). Só a segunda
+// compara o custo de memória entre variantes.
+
+// Chaves e consultas padrão
+#define DEFAULT_KEYS 1000000
+#define DEFAULT_QUERIES 2000000
+#define DEFAULT_ZIPF 0.99
+#define DEFAULT_HIT_RATIO 0.9
+
+// Chaves com prefixo compartilhado: BENCH_PREFIXES prefixos de BENCH_PREFIX_LEN letras
+#define BENCH_PREFIXES 16
+#define BENCH_PREFIX_LEN 24
+
+// Histograma log-linear: 16 sub-baldes por potência de 2 (erro relativo < 6,25%)
+#define HIST_SUB_BITS 4
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS (HIST_SUB * 48)
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t next_random(uint64_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+    return *x;
+}
+
+// --- Histograma de latência ---
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+} Histogram;
+
+static int hist_bucket(uint64_t ns) {
+    if (ns < HIST_SUB) {
+        return (int)ns;
+    }
+    int k = 63 - __builtin_clzll(ns);
+    int bucket = (k - HIST_SUB_BITS + 1) * HIST_SUB + (int)((ns >> (k - HIST_SUB_BITS)) & (HIST_SUB - 1));
+    return bucket < HIST_BUCKETS ? bucket : HIST_BUCKETS - 1;
+}
+
+// Menor valor que cai no balde
+static uint64_t hist_value(int bucket) {
+    if (bucket < HIST_SUB) {
+        return (uint64_t)bucket;
+    }
+    int k = bucket / HIST_SUB + HIST_SUB_BITS - 1;
+    return (uint64_t)(HIST_SUB + bucket % HIST_SUB) << (k - HIST_SUB_BITS);
+}
+
+static uint64_t hist_percentile(const Histogram *h, double p) {
+    uint64_t rank = (uint64_t)ceil(p * (double)h->total);
+    uint64_t seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank && h->counts[b]) {
+            return hist_value(b);
+        }
+    }
+    return 0;
+}
+
+// --- Interface comum ---
+
+// impl é o estado da variante; thread, o estado de uma thread (de attach, ou
+// NULL). seal, se existir, roda depois das inserções e antes das buscas.
+typedef struct {
+    const char *name;
+    void *(*create)(void);
+    void *(*attach)(void *impl);
+    void (*detach)(void *impl, void *thread);
+    int (*insert)(void *impl, void *thread, const char *key, size_t len);
+    int (*seal)(void *impl);
+    bool (*search)(void *impl, void *thread, const char *key, size_t len);
+    void (*stats)(void *impl, uint64_t *nodes, size_t *bytes, size_t *mapped);
+    void (*destroy)(void *impl);
+} BenchImpl;
+
+// Layout fixo (trie.h)
+static void *fixed_create(void) {
+    struct Trie *trie = malloc(sizeof(*trie));
+    if (trie && initTrie(trie) != 0) {
+        free(trie);
+        return NULL;
+    }
+    return trie;
+}
+
+static int fixed_insert(void *impl, void *thread, const char *key, size_t len) {
+    (void)thread;
+    insertLen(impl, key, len);
+    return 0;
+}
+
+static bool fixed_search(void *impl, void *thread, const char *key, size_t len) {
+    (void)thread;
+    return searchLen(impl, key, len);
+}
+
+static void fixed_stats(void *impl, uint64_t *nodes, size_t *bytes, size_t *mapped) {
+    struct Trie *trie = impl;
+    *nodes = trie_arena_count(&trie->arena);
+    *bytes = trie_arena_used_bytes(&trie->arena);
+    *mapped = trie_arena_mapped_bytes(&trie->arena);
+}
+
+static void fixed_destroy(void *impl) {
+    freeTrie(impl);
+    free(impl);
+}
+
+// Nós adaptativos (adaptive_trie.h)
+static void *adaptive_create(void) {
+    AdaptiveTrie *trie = malloc(sizeof(*trie));
+    if (trie && adaptive_trie_init(trie) != 0) {
+        free(trie);
+        return NULL;
+    }
+    return trie;
+}
+
+static int adaptive_insert(void *impl, void *thread, const char *key, size_t len) {
+    (void)thread;
+    return adaptive_trie_insert_len(impl, key, (int)len) < 0 ? -1 : 0;
+}
+
+static bool adaptive_search(void *impl, void *thread, const char *key, size_t len) {
+    (void)thread;
+    return adaptive_trie_search_len(impl, key, (int)len);
+}
+
+static void adaptive_stats(void *impl, uint64_t *nodes, size_t *bytes, size_t *mapped) {
+    AdaptiveTrie *trie = impl;
+    *nodes = 0;
+    *bytes = 0;
+    *mapped = 0;
+    for (int type = 0; type < ADAPTIVE_NUM_TYPES; type++) {
+        *nodes += trie->live[type];
+        *bytes += (size_t)trie->live[type] * adaptive_node_size[type];
+        *mapped += trie_arena_mapped_bytes(&trie->arenas[type]);
+    }
+}
+
+static void adaptive_destroy(void *impl) {
+    adaptive_trie_destroy(impl);
+    free(impl);
+}
+
+// Concorrente (concurrent_trie.h): cada thread com o seu cursor
+static void *concurrent_create(void) {
+    ConcurrentTrie *trie = malloc(sizeof(*trie));
+    if (trie && concurrent_trie_init(trie) != 0) {
+        free(trie);
+        return NULL;
+    }
+    return trie;
+}
+
+static void *concurrent_attach(void *impl) {
+    ConcurrentTrieCursor *cursor = malloc(sizeof(*cursor));
+    if (cursor && concurrent_trie_cursor_init(impl, cursor) != 0) {
+        free(cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static void concurrent_detach(void *impl, void *thread) {
+    concurrent_trie_cursor_release(impl, thread);
+    free(thread);
+}
+
+// As chaves da bancada terminam em '\0', como a Trie concorrente espera
+static int concurrent_insert(void *impl, void *thread, const char *key, size_t len) {
+    (void)len;
+    return concurrent_trie_insert(impl, thread, key);
+}
+
+static bool concurrent_search(void *impl, void *thread, const char *key, size_t len) {
+    (void)len;
+    return concurrent_trie_search(impl, thread, key);
+}
+
+static void concurrent_stats(void *impl, uint64_t *nodes, size_t *bytes, size_t *mapped) {
+    *nodes = (uint64_t)concurrent_trie_count(impl);
+    *bytes = *nodes * sizeof(ConcurrentTrieNode);
+    *mapped = concurrent_trie_mapped_bytes(impl);
+}
+
+static void concurrent_destroy(void *impl) {
+    concurrent_trie_destroy(impl);
+    free(impl);
+}
+
+// Retrato double-array (trie_snapshot.h): carga numa Trie fixa, congelada em seal
+typedef struct {
+    struct Trie trie;
+    TrieSnapshot snap;
+    bool sealed;
+} SnapshotImpl;
+
+static void *snapshot_create(void) {
+    SnapshotImpl *s = calloc(1, sizeof(*s));
+    if (s && initTrie(&s->trie) != 0) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+static int snapshot_insert(void *impl, void *thread, const char *key, size_t len) {
+    (void)thread;
+    insertLen(&((SnapshotImpl *)impl)->trie, key, len);
+    return 0;
+}
+
+static int snapshot_seal(void *impl) {
+    SnapshotImpl *s = impl;
+    if (trie_snapshot_freeze(&s->trie, &s->snap) != 0) {
+        return -1;
+    }
+    freeTrie(&s->trie);
+    s->sealed = true;
+    return 0;
+}
+
+static bool snapshot_search(void *impl, void *thread, const char *key, size_t len) {
+    (void)thread;
+    (void)len;
+    return trie_snapshot_search(&((SnapshotImpl *)impl)->snap, key);
+}
+
+// A imagem inclui as células livres do double-array: as ocupadas ficam em bytes
+static void snapshot_stats(void *impl, uint64_t *nodes, size_t *bytes, size_t *mapped) {
+    SnapshotImpl *s = impl;
+    *nodes = s->snap.header->num_states;
+    *bytes = sizeof(TrieSnapshotHeader) + (size_t)s->snap.header->num_states * sizeof(TrieSnapshotCell);
+    *mapped = s->snap.length;
+}
+
+static void snapshot_destroy(void *impl) {
+    SnapshotImpl *s = impl;
+    if (s->sealed) {
+        trie_snapshot_close(&s->snap);
+    } else {
+        freeTrie(&s->trie);
+    }
+    free(s);
+}
+
+static const BenchImpl impls[] = {
+    {"fixa", fixed_create, NULL, NULL, fixed_insert, NULL, fixed_search, fixed_stats, fixed_destroy},
+    {"adaptativa", adaptive_create, NULL, NULL, adaptive_insert, NULL, adaptive_search, adaptive_stats,
+     adaptive_destroy},
+    {"concorrente", concurrent_create, concurrent_attach, concurrent_detach, concurrent_insert, NULL,
+     concurrent_search, concurrent_stats, concurrent_destroy},
+    {"retrato", snapshot_create, NULL, NULL, snapshot_insert, snapshot_seal, snapshot_search, snapshot_stats,
+     snapshot_destroy},
+};
+#define NUM_IMPLS ((int)(sizeof(impls) / sizeof(impls[0])))
+
+// --- Cargas ---
+
+// Chaves terminadas em '\0' num único buffer
+typedef struct {
+    char *buf;
+    const char **keys;
+    size_t *lens;
+    long long count;
+} KeySet;
+
+typedef struct {
+    const char *name;
+    KeySet *keys;
+    const char **queries;
+    size_t *lens;
+    long long num_queries;
+    long long expected_hits;
+    long long distinct_keys;
+} Workload;
+
+static void keyset_free(KeySet *set) {
+    free(set->buf);
+    free(set->keys);
+    free(set->lens);
+}
+
+static int keyset_alloc(KeySet *set, long long count, size_t bytes) {
+    set->buf = malloc(bytes);
+    set->keys = malloc((size_t)count * sizeof(char *));
+    set->lens = malloc((size_t)count * sizeof(size_t));
+    set->count = count;
+    if (!set->buf || !set->keys || !set->lens) {
+        keyset_free(set);
+        return -1;
+    }
+    return 0;
+}
+
+// Chaves uniformes, as mesmas de palavras.h
+static int make_uniform(KeySet *set, long long count) {
+    long long *offsets = NULL;
+    char *buf = generateWords(count, &offsets);
+    if (!buf) {
+        return -1;
+    }
+    set->buf = buf;
+    set->keys = malloc((size_t)count * sizeof(char *));
+    set->lens = malloc((size_t)count * sizeof(size_t));
+    set->count = count;
+    if (!set->keys || !set->lens) {
+        free(offsets);
+        keyset_free(set);
+        return -1;
+    }
+    for (long long i = 0; i < count; i++) {
+        set->keys[i] = buf + offsets[i];
+        set->lens[i] = strlen(set->keys[i]);
+    }
+    free(offsets);
+    return 0;
+}
+
+// Chaves longas: um de BENCH_PREFIXES prefixos seguido de 4 a 8 letras aleatórias
+static int make_shared_prefix(KeySet *set, long long count) {
+    size_t max_len = BENCH_PREFIX_LEN + 8;
+    if (keyset_alloc(set, count, (size_t)count * (max_len + 1)) != 0) {
+        return -1;
+    }
+    char prefixes[BENCH_PREFIXES][BENCH_PREFIX_LEN];
+    uint64_t x = 0xD1B54A32D192ED03ULL;
+    for (int p = 0; p < BENCH_PREFIXES; p++) {
+        for (int j = 0; j < BENCH_PREFIX_LEN; j++) {
+            prefixes[p][j] = (char)('a' + next_random(&x) % 26);
+        }
+    }
+    char *pos = set->buf;
+    for (long long i = 0; i < count; i++) {
+        size_t len = BENCH_PREFIX_LEN + 4 + next_random(&x) % 5;
+        memcpy(pos, prefixes[next_random(&x) % BENCH_PREFIXES], BENCH_PREFIX_LEN);
+        for (size_t j = BENCH_PREFIX_LEN; j < len; j++) {
+            pos[j] = (char)('a' + next_random(&x) % 26);
+        }
+        pos[len] = '\0';
+        set->keys[i] = pos;
+        set->lens[i] = len;
+        pos += len + 1;
+    }
+    return 0;
+}
+
+// Monta as consultas: hit_ratio delas são chaves presentes, escolhidas de
+// modo uniforme (zipf <= 0) ou com expoente zipf sobre a ordem das chaves
+// (que já é aleatória); as demais são ausentes. reference dá as respostas.
+static int make_queries(Workload *w, const struct Trie *reference, long long num_queries, double zipf,
+                        double hit_ratio, char **miss_buf) {
+    KeySet *keys = w->keys;
+    double *cdf = NULL;
+    if (zipf > 0) {
+        cdf = malloc((size_t)keys->count * sizeof(double));
+        if (!cdf) {
+            return -1;
+        }
+        double sum = 0;
+        for (long long r = 0; r < keys->count; r++) {
+            sum += 1.0 / pow((double)(r + 1), zipf);
+            cdf[r] = sum;
+        }
+        for (long long r = 0; r < keys->count; r++) {
+            cdf[r] /= sum;
+        }
+    }
+
+    size_t max_len = 0;
+    for (long long i = 0; i < keys->count; i++) {
+        max_len = keys->lens[i] > max_len ? keys->lens[i] : max_len;
+    }
+    w->queries = malloc((size_t)num_queries * sizeof(char *));
+    w->lens = malloc((size_t)num_queries * sizeof(size_t));
+    *miss_buf = malloc((size_t)num_queries * (max_len + 1));
+    if (!w->queries || !w->lens || !*miss_buf) {
+        free(cdf);
+        return -1;
+    }
+
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    char *pos = *miss_buf;
+    w->num_queries = num_queries;
+    w->expected_hits = 0;
+    for (long long q = 0; q < num_queries; q++) {
+        long long k;
+        double u = (double)(next_random(&x) >> 11) / (double)(1ull << 53);
+        if (cdf) {
+            long long lo = 0, hi = keys->count - 1;
+            while (lo < hi) {
+                long long mid = (lo + hi) / 2;
+                if (cdf[mid] < u) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            k = lo;
+        } else {
+            k = (long long)(next_random(&x) % (uint64_t)keys->count);
+        }
+
+        bool hit = (double)(next_random(&x) >> 11) / (double)(1ull << 53) < hit_ratio;
+        if (hit) {
+            w->queries[q] = keys->keys[k];
+            w->lens[q] = keys->lens[k];
+            w->expected_hits++;
+            continue;
+        }
+        // Ausente: troca a última letra até sair do conjunto (ou desiste e conta como presente)
+        size_t len = keys->lens[k];
+        memcpy(pos, keys->keys[k], len + 1);
+        for (int tries = 0; tries < 26 && searchLen(reference, pos, len); tries++) {
+            pos[len - 1] = (char)('a' + (pos[len - 1] - 'a' + 1) % 26);
+        }
+        w->expected_hits += searchLen(reference, pos, len);
+        w->queries[q] = pos;
+        w->lens[q] = len;
+        pos += len + 1;
+    }
+    free(cdf);
+    return 0;
+}
+
+// --- Medição ---
+
+typedef struct {
+    const BenchImpl *impl;
+    void *state;
+    const Workload *w;
+    int id;
+    int num_threads;
+    long long hits;
+    int failed;
+} SearchArgs;
+
+// Vazão sustentada: as consultas i ≡ id (mod num_threads), sem relógio por operação
+static void *search_thread(void *arg) {
+    SearchArgs *args = arg;
+    void *thread = args->impl->attach ? args->impl->attach(args->state) : NULL;
+    if (args->impl->attach && !thread) {
+        args->failed = 1;
+        return NULL;
+    }
+    long long hits = 0;
+    for (long long q = args->id; q < args->w->num_queries; q += args->num_threads) {
+        hits += args->impl->search(args->state, thread, args->w->queries[q], args->w->lens[q]);
+    }
+    args->hits = hits;
+    if (args->impl->detach) {
+        args->impl->detach(args->state, thread);
+    }
+    return NULL;
+}
+
+// Roda as buscas em num_threads threads. Retorna o tempo em segundos ou -1.
+static double run_searches(const BenchImpl *impl, void *state, const Workload *w, int num_threads,
+                           const AffinityPlan *plan, long long *hits) {
+    pthread_t handles[num_threads];
+    SearchArgs args[num_threads];
+    struct timespec t0, t1;
+    int created = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (; created < num_threads; created++) {
+        args[created] = (SearchArgs){impl, state, w, created, num_threads, 0, 0};
+        if (affinity_thread_create(&handles[created], plan, created, search_thread, &args[created]) != 0) {
+            break;
+        }
+    }
+    int failed = created != num_threads;
+    *hits = 0;
+    for (int t = 0; t < created; t++) {
+        pthread_join(handles[t], NULL);
+        *hits += args[t].hits;
+        failed |= args[t].failed;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return failed ? -1 : elapsed(&t0, &t1);
+}
+
+// Custo de um par de leituras do relógio, descontado de cada latência
+static uint64_t timer_overhead(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 10000; i++) {
+        uint64_t a = now_ns();
+        uint64_t b = now_ns();
+        best = b - a < best ? b - a : best;
+    }
+    return best;
+}
+
+// Mede uma variante numa carga. Retorna o número de divergências ou -1 em erro.
+static int bench_impl(const BenchImpl *impl, const Workload *w, int max_threads, const AffinityPlan *plan,
+                      uint64_t overhead, Histogram *hist) {
+    struct timespec t0, t1;
+    void *state = impl->create();
+    if (!state) {
+        return -1;
+    }
+    void *thread = impl->attach ? impl->attach(state) : NULL;
+    if (impl->attach && !thread) {
+        impl->destroy(state);
+        return -1;
+    }
+
+    // Inserção (e congelamento, se houver): uma thread
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long long i = 0; i < w->keys->count; i++) {
+        if (impl->insert(state, thread, w->keys->keys[i], w->keys->lens[i]) != 0) {
+            impl->destroy(state);
+            return -1;
+        }
+    }
+    if (impl->seal && impl->seal(state) != 0) {
+        impl->destroy(state);
+        return -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double insert_time = elapsed(&t0, &t1);
+    if (impl->detach) {
+        impl->detach(state, thread);
+    }
+
+    // Latência de cada busca, uma thread
+    thread = impl->attach ? impl->attach(state) : NULL;
+    if (impl->attach && !thread) {
+        impl->destroy(state);
+        return -1;
+    }
+    memset(hist, 0, sizeof(*hist));
+    long long hits = 0;
+    for (long long q = 0; q < w->num_queries; q++) {
+        uint64_t a = now_ns();
+        hits += impl->search(state, thread, w->queries[q], w->lens[q]);
+        uint64_t b = now_ns();
+        uint64_t ns = b - a > overhead ? b - a - overhead : 0;
+        hist->counts[hist_bucket(ns)]++;
+    }
+    hist->total = (uint64_t)w->num_queries;
+    if (impl->detach) {
+        impl->detach(state, thread);
+    }
+    int errors = hits != w->expected_hits;
+
+    // Vazão sustentada com 1 e com max_threads threads
+    long long hits1 = 0, hitsN = 0;
+    double time1 = run_searches(impl, state, w, 1, plan, &hits1);
+    double timeN = max_threads > 1 ? run_searches(impl, state, w, max_threads, plan, &hitsN) : time1;
+    if (time1 < 0 || timeN < 0) {
+        impl->destroy(state);
+        return -1;
+    }
+    errors += hits1 != w->expected_hits || (max_threads > 1 && hitsN != w->expected_hits);
+
+    uint64_t nodes;
+    size_t bytes, mapped;
+    impl->stats(state, &nodes, &bytes, &mapped);
+    printf("%-12s %10.0f %8llu %8llu %8llu %10.2f %10.2f %11llu %9.1f %9.1f %s\n", impl->name,
+           w->keys->count / insert_time, (unsigned long long)hist_percentile(hist, 0.50),
+           (unsigned long long)hist_percentile(hist, 0.99), (unsigned long long)hist_percentile(hist, 0.999),
+           w->num_queries / time1 / 1e6, w->num_queries / timeN / 1e6, (unsigned long long)nodes,
+           (double)bytes / w->distinct_keys, (double)mapped / w->distinct_keys, errors ? "FALHOU" : "ok");
+    impl->destroy(state);
+    return errors;
+}
+
+int main(int argc, char *argv[]) {
+    AffinityPolicy policy = AFFINITY_NONE;
+    long long num_keys = DEFAULT_KEYS;
+    long long num_queries = DEFAULT_QUERIES;
+    double zipf = DEFAULT_ZIPF;
+    double hit_ratio = DEFAULT_HIT_RATIO;
+    int max_threads = 1;
+    const char *only_impl = NULL;   // -i: só uma variante
+    const char *only_load = NULL;   // -w: só uma carga
+    int opt;
+    while ((opt = getopt(argc, argv, "a:n:q:z:h:p:i:w:")) != -1) {
+        if (opt == 'a' && affinity_parse_policy(optarg, &policy) == 0) {
+            continue;
+        }
+        if (opt == 'n' && (num_keys = atoll(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'q' && (num_queries = atoll(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'z' && (zipf = atof(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'h' && (hit_ratio = atof(optarg)) >= 0 && hit_ratio <= 1) {
+            continue;
+        }
+        if (opt == 'p' && (max_threads = atoi(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'i' || opt == 'w') {
+            *(opt == 'i' ? &only_impl : &only_load) = optarg;
+            continue;
+        }
+        fprintf(stderr, "Uso: %s [-a none|compact|scatter|physical] [-n chaves] [-q consultas] "
+                "[-z expoente de Zipf] [-h fração de acertos] [-p threads] "
+                "[-i fixa|adaptativa|concorrente|retrato] [-w uniforme|zipf|prefixo]\n", argv[0]);
+        return 1;
+    }
+
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    if (affinity_read_topology(&topo) != 0 || affinity_plan(&topo, policy, max_threads, &plan) != 0
+        || affinity_pin_self(&plan, 0) != 0) {
+        perror("Falha ao aplicar a afinidade");
+        return 1;
+    }
+    affinity_print(stdout, &topo, &plan);
+
+    uint64_t overhead = timer_overhead();
+    printf("Chaves: %lld; consultas: %lld; Zipf %.2f; %.0f%% de acertos; custo do relógio %llu ns "
+           "(descontado das latências)\n\n", num_keys, num_queries, zipf, 100 * hit_ratio,
+           (unsigned long long)overhead);
+
+    KeySet uniform = {0}, shared = {0};
+    if (make_uniform(&uniform, num_keys) != 0 || make_shared_prefix(&shared, num_keys) != 0) {
+        perror("Falha ao gerar as chaves");
+        return 1;
+    }
+    Workload loads[] = {
+        {"uniforme", &uniform, NULL, NULL, 0, 0, 0},
+        {"zipf", &uniform, NULL, NULL, 0, 0, 0},
+        {"prefixo", &shared, NULL, NULL, 0, 0, 0},
+    };
+    int num_loads = (int)(sizeof(loads) / sizeof(loads[0]));
+
+    Histogram *hist = malloc(sizeof(Histogram));
+    if (!hist) {
+        perror("Erro de alocação");
+        return 1;
+    }
+    int errors = 0;
+    for (int l = 0; l < num_loads; l++) {
+        Workload *w = &loads[l];
+        if (only_load && strcmp(only_load, w->name) != 0) {
+            continue;
+        }
+
+        // Referência: conta as chaves distintas e responde às consultas ausentes
+        struct Trie reference;
+        if (initTrie(&reference) != 0) {
+            perror("Falha ao criar a Trie");
+            return 1;
+        }
+        for (long long i = 0; i < w->keys->count; i++) {
+            w->distinct_keys += !searchLen(&reference, w->keys->keys[i], w->keys->lens[i]);
+            insertLen(&reference, w->keys->keys[i], w->keys->lens[i]);
+        }
+        char *miss_buf = NULL;
+        if (make_queries(w, &reference, num_queries, strcmp(w->name, "uniforme") == 0 ? 0 : zipf, hit_ratio,
+                         &miss_buf) != 0) {
+            perror("Falha ao gerar as consultas");
+            return 1;
+        }
+        freeTrie(&reference);
+
+        printf("Carga %s: %lld chaves distintas, %lld consultas, %lld acertos esperados\n", w->name,
+               w->distinct_keys, w->num_queries, w->expected_hits);
+        printf("%-12s %10s %8s %8s %8s %10s %10s %11s %9s %9s\n", "variante", "ins/s", "p50_ns", "p99_ns",
+               "p999_ns", "Mbuscas/s", "Mbuscas/sN", "nós", "bytes/ch", "mapa/ch");
+        for (int i = 0; i < NUM_IMPLS; i++) {
+            if (only_impl && strcmp(only_impl, impls[i].name) != 0) {
+                continue;
+            }
+            int ret = bench_impl(&impls[i], w, max_threads, &plan, overhead, hist);
+            if (ret < 0) {
+                fprintf(stderr, "Falha ao medir a variante %s: %s\n", impls[i].name, strerror(errno));
+                return 1;
+            }
+            errors += ret;
+        }
+        printf("\n");
+        free(w->queries);
+        free(w->lens);
+        free(miss_buf);
+    }
+    printf("(Mbuscas/sN: com %d threads)\n", max_threads);
+    printf("Verificação: %s (%d divergências)\n", errors ? "FALHOU" : "ok", errors);
+
+    free(hist);
+    keyset_free(&uniform);
+    keyset_free(&shared);
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,723 @@
+#ifndef CONCURRENT_TRIE_H
+#define CONCURRENT_TRIE_H
+
+// Trie de layout fixo para inserção concorrente sem trava global.
+//
+// Os filhos são índices atômicos de 32 bits: um escritor que encontra o filho
+// vazio aloca um nó e tenta instalá-lo com compare-and-swap. Se outro escritor
+// ganhou a corrida, o nó perdido fica guardado no cursor da thread e é reusado
+// na próxima alocação (ele nunca foi publicado, então continua zerado).
+//
+// A busca só faz leituras com acquire, um passo por caractere: é wait-free e
+// pode rodar junto com os escritores. Ela vê cada palavra inserida antes ou
+// depois, nunca um nó pela metade, porque o nó é publicado (CAS com release)
+// depois de ter sido zerado pela arena, e a marca de fim de palavra é gravada
+// com release depois do caminho inteiro existir.
+//
+// A arena é a mesma de trie_arena.h (blocos de mmap com índices de 32 bits),
+// mas cada thread retira faixas de CONCURRENT_TRIE_BLOCK_NODES índices com um
+// fetch_add e aloca dentro da sua faixa sem sincronização. Os blocos da arena
+// são mapeados sob uma trava, uma vez cada, por quem chegar primeiro.
+//
+// Remoção e poda: remoções e podas são serializadas entre si por prune_lock,
+// mas seguem concorrentes com inserções e buscas (que nunca pegam essa trava).
+// Antes de desligar um nó do pai, quem poda o "congela": liga o bit
+// CONCURRENT_TRIE_FROZEN em todos os filhos e no estado, com fetch_or. Um CAS
+// de inserção num nó congelado falha, e a inserção recomeça da raiz; quando ela
+// passar de novo pelo pai, o nó já terá sido desligado. A busca ignora o bit e
+// segue os filhos normalmente (o nó ainda está na Trie até ser desligado).
+// Os nós desligados vão para a recuperação por épocas (epoch.h) e só voltam a
+// ser entregues pelo alocador depois que nenhuma operação que começou antes do
+// desligamento estiver em andamento. Por isso toda operação, inclusive a
+// busca, roda entre epoch_enter e epoch_exit com a vaga do seu cursor.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "trie_arena.h"
+#include "epoch.h"
+#include "../common/affinity.h"
+
+// Tamanho do alfabeto para letras minúsculas 'a'-'z'
+#define CONCURRENT_TRIE_ALPHABET 26
+
+// Índices retirados de uma vez por thread (divide TRIE_ARENA_CHUNK_NODES)
+#define CONCURRENT_TRIE_BLOCK_NODES 1024u
+
+// Nós recuperados que um cursor pega de uma vez
+#define CONCURRENT_TRIE_STASH 64
+
+// Threads registradas ao mesmo tempo (vagas de época)
+#define CONCURRENT_TRIE_MAX_THREADS 256
+
+// Bit de congelamento nos filhos e no estado; os índices usam só os 31 bits de baixo
+#define CONCURRENT_TRIE_FROZEN 0x80000000u
+#define CONCURRENT_TRIE_END 1u
+#define CONCURRENT_TRIE_MAX_BLOCKS (CONCURRENT_TRIE_FROZEN / CONCURRENT_TRIE_BLOCK_NODES)
+
+typedef struct {
+    _Atomic uint32_t children[CONCURRENT_TRIE_ALPHABET];
+    atomic_uint state;              // CONCURRENT_TRIE_END | CONCURRENT_TRIE_FROZEN
+} ConcurrentTrieNode;
+
+typedef struct {
+    _Atomic(char *) *chunks;        // Base de cada bloco da arena (NULL = ainda não mapeado)
+    atomic_uint next_block;         // Próxima faixa de índices a ser retirada
+    atomic_llong nodes;             // Nós na Trie (publicados pelos cursores devolvidos, menos os podados)
+    pthread_mutex_t grow_lock;      // Serializa o mapeamento de blocos novos e a lista de recuperados
+    pthread_mutex_t prune_lock;     // Serializa remoções e podas entre si
+    size_t chunk_bytes;
+    uint32_t root;
+    uint32_t *recycled;             // Nós recuperados prontos para reuso (sob grow_lock)
+    size_t num_recycled;
+    size_t recycled_capacity;
+    EpochDomain epoch;
+    EpochRetirer retirer;           // Limbo dos nós podados (sob prune_lock)
+} ConcurrentTrie;
+
+// Estado de uma thread: a faixa corrente, um nó que perdeu um CAS, nós
+// recuperados ainda não usados e a vaga de época
+typedef struct {
+    uint32_t next;
+    uint32_t end;
+    uint32_t spare;
+    int num_stash;
+    uint32_t stash[CONCURRENT_TRIE_STASH];
+    unsigned long long published;
+    int epoch_id;
+} ConcurrentTrieCursor;
+
+static inline ConcurrentTrieNode *concurrent_trie_node(const ConcurrentTrie *trie, uint32_t ref) {
+    char *base = atomic_load_explicit(&trie->chunks[ref >> TRIE_ARENA_CHUNK_SHIFT], memory_order_relaxed);
+    return (ConcurrentTrieNode *)(base + (size_t)(ref & TRIE_ARENA_CHUNK_MASK) * sizeof(ConcurrentTrieNode));
+}
+
+// Garante que o bloco da arena que contém ref está mapeado. Retorna 0 ou -1.
+static inline int concurrent_trie_map(ConcurrentTrie *trie, uint32_t ref) {
+    uint32_t chunk = ref >> TRIE_ARENA_CHUNK_SHIFT;
+    if (atomic_load_explicit(&trie->chunks[chunk], memory_order_acquire)) {
+        return 0;
+    }
+
+    int ret = 0;
+    pthread_mutex_lock(&trie->grow_lock);
+    if (!atomic_load_explicit(&trie->chunks[chunk], memory_order_relaxed)) {
+        char *base = trie_arena_map_chunk(trie->chunk_bytes);
+        if (base) {
+            atomic_store_explicit(&trie->chunks[chunk], base, memory_order_release);
+        } else {
+            ret = -1;
+        }
+    }
+    pthread_mutex_unlock(&trie->grow_lock);
+    return ret;
+}
+
+// Devolve um nó à lista de recuperados, crescendo a lista se preciso (com
+// grow_lock já tomado). Sem memória para a lista, o nó fica perdido até
+// concurrent_trie_destroy.
+static inline void concurrent_trie_push_recycled(ConcurrentTrie *trie, uint32_t ref) {
+    if (trie->num_recycled == trie->recycled_capacity) {
+        size_t capacity = trie->recycled_capacity ? trie->recycled_capacity * 2 : 1024;
+        uint32_t *grown = realloc(trie->recycled, capacity * sizeof(uint32_t));
+        if (grown) {
+            trie->recycled = grown;
+            trie->recycled_capacity = capacity;
+        }
+    }
+    if (trie->num_recycled < trie->recycled_capacity) {
+        trie->recycled[trie->num_recycled++] = ref;
+    }
+}
+
+// Pega até CONCURRENT_TRIE_STASH nós recuperados para o cursor. Retorna quantos pegou.
+static inline int concurrent_trie_take_recycled(ConcurrentTrie *trie, ConcurrentTrieCursor *cursor) {
+    pthread_mutex_lock(&trie->grow_lock);
+    while (cursor->num_stash < CONCURRENT_TRIE_STASH && trie->num_recycled > 0) {
+        cursor->stash[cursor->num_stash++] = trie->recycled[--trie->num_recycled];
+    }
+    pthread_mutex_unlock(&trie->grow_lock);
+    return cursor->num_stash;
+}
+
+// Aloca um nó zerado para a thread dona do cursor. Retorna o índice ou 0 se faltar memória.
+static inline uint32_t concurrent_trie_alloc(ConcurrentTrie *trie, ConcurrentTrieCursor *cursor) {
+    if (cursor->spare) {
+        uint32_t ref = cursor->spare;
+        cursor->spare = 0;
+        return ref;
+    }
+    if (cursor->num_stash > 0) {
+        return cursor->stash[--cursor->num_stash];
+    }
+
+    if (cursor->next == cursor->end) {
+        // Antes de uma faixa nova, reaproveita nós podados
+        if (concurrent_trie_take_recycled(trie, cursor) > 0) {
+            return cursor->stash[--cursor->num_stash];
+        }
+        uint32_t block = atomic_fetch_add_explicit(&trie->next_block, 1, memory_order_relaxed);
+        if (block >= CONCURRENT_TRIE_MAX_BLOCKS) {
+            return 0; // Espaço de índices esgotado
+        }
+        uint32_t first = block * CONCURRENT_TRIE_BLOCK_NODES;
+        if (concurrent_trie_map(trie, first) != 0) {
+            return 0;
+        }
+        // O índice 0 é reservado (NULL) e fica de fora da primeira faixa
+        cursor->next = first == 0 ? 1 : first;
+        cursor->end = first + CONCURRENT_TRIE_BLOCK_NODES;
+    }
+    return cursor->next++;
+}
+
+// Prepara o cursor da thread chamadora. Retorna 0, ou -1 (errno = EAGAIN) se
+// já houver CONCURRENT_TRIE_MAX_THREADS cursores em uso.
+static inline int concurrent_trie_cursor_init(ConcurrentTrie *trie, ConcurrentTrieCursor *cursor) {
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->epoch_id = epoch_register(&trie->epoch);
+    if (cursor->epoch_id < 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    return 0;
+}
+
+// Soma os nós publicados pelo cursor no total da Trie, devolve os nós
+// recuperados não usados e libera a vaga de época. O resto da faixa é descartado.
+static inline void concurrent_trie_cursor_release(ConcurrentTrie *trie, ConcurrentTrieCursor *cursor) {
+    atomic_fetch_add_explicit(&trie->nodes, (long long)cursor->published, memory_order_relaxed);
+    if (cursor->num_stash > 0) {
+        pthread_mutex_lock(&trie->grow_lock);
+        // A lista pode ter sido reenchida enquanto o cursor segurava estes nós
+        while (cursor->num_stash > 0) {
+            concurrent_trie_push_recycled(trie, cursor->stash[--cursor->num_stash]);
+        }
+        pthread_mutex_unlock(&trie->grow_lock);
+    }
+    epoch_unregister(&trie->epoch, cursor->epoch_id);
+    cursor->epoch_id = -1;
+}
+
+// Inicializa a Trie com a raiz. Retorna 0 ou -1 se faltar memória.
+static inline int concurrent_trie_init(ConcurrentTrie *trie) {
+    memset(trie, 0, sizeof(*trie));
+    trie->chunks = calloc(TRIE_ARENA_MAX_CHUNKS, sizeof(*trie->chunks));
+    if (!trie->chunks || epoch_init(&trie->epoch, CONCURRENT_TRIE_MAX_THREADS) != 0) {
+        free(trie->chunks);
+        return -1;
+    }
+    atomic_init(&trie->next_block, 0);
+    atomic_init(&trie->nodes, 1);
+    pthread_mutex_init(&trie->grow_lock, NULL);
+    pthread_mutex_init(&trie->prune_lock, NULL);
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    trie->chunk_bytes = (sizeof(ConcurrentTrieNode) * TRIE_ARENA_CHUNK_NODES + page - 1) / page * page;
+
+    // A raiz sai de uma faixa própria, devolvida logo em seguida
+    ConcurrentTrieCursor cursor;
+    memset(&cursor, 0, sizeof(cursor));
+    trie->root = concurrent_trie_alloc(trie, &cursor);
+    if (!trie->root) {
+        free(trie->chunks);
+        epoch_destroy(&trie->epoch);
+        pthread_mutex_destroy(&trie->grow_lock);
+        pthread_mutex_destroy(&trie->prune_lock);
+        return -1;
+    }
+    return 0;
+}
+
+// Cede a CPU fora da seção de época (quem está podando pode precisar dela)
+static inline void concurrent_trie_backoff(ConcurrentTrie *trie, ConcurrentTrieCursor *cursor) {
+    epoch_exit(&trie->epoch, cursor->epoch_id);
+    sched_yield();
+    epoch_enter(&trie->epoch, cursor->epoch_id);
+}
+
+// Insere key; pode ser chamada por várias threads ao mesmo tempo, cada uma com
+// o seu cursor. Retorna 0, ou -1 se faltar memória. Chaves com caracteres fora
+// de 'a'-'z' são ignoradas, como em insert (trie.h).
+static inline int concurrent_trie_insert(ConcurrentTrie *trie, ConcurrentTrieCursor *cursor, const char *key) {
+    int ret = 0;
+    epoch_enter(&trie->epoch, cursor->epoch_id);
+
+restart:;
+    uint32_t currentNode = trie->root;
+    for (const char *p = key; *p; p++) {
+        int index = *p - 'a';
+        if (index < 0 || index >= CONCURRENT_TRIE_ALPHABET) {
+            goto out;
+        }
+
+        _Atomic uint32_t *slot = &concurrent_trie_node(trie, currentNode)->children[index];
+        uint32_t child = atomic_load_explicit(slot, memory_order_acquire);
+        if (!child) {
+            uint32_t fresh = concurrent_trie_alloc(trie, cursor);
+            if (!fresh) {
+                ret = -1;
+                goto out;
+            }
+            // Em caso de derrota, child recebe o nó instalado pelo vencedor (ou o bit de congelamento)
+            if (atomic_compare_exchange_strong_explicit(slot, &child, fresh,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                child = fresh;
+                cursor->published++;
+            } else {
+                cursor->spare = fresh;
+            }
+        }
+        if (child & CONCURRENT_TRIE_FROZEN) {
+            concurrent_trie_backoff(trie, cursor);
+            goto restart;
+        }
+        currentNode = child;
+    }
+
+    atomic_uint *state = &concurrent_trie_node(trie, currentNode)->state;
+    unsigned old = atomic_load_explicit(state, memory_order_relaxed);
+    do {
+        if (old & CONCURRENT_TRIE_FROZEN) {
+            concurrent_trie_backoff(trie, cursor);
+            goto restart;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(state, &old, old | CONCURRENT_TRIE_END,
+                                                    memory_order_release, memory_order_relaxed));
+
+out:
+    epoch_exit(&trie->epoch, cursor->epoch_id);
+    return ret;
+}
+
+// Busca wait-free: no máximo strlen(key) leituras atômicas, sem laços de nova
+// tentativa e sem travas. Um nó congelado ainda faz parte da Trie até ser
+// desligado, então o bit de congelamento é só descartado.
+static inline bool concurrent_trie_search(const ConcurrentTrie *trie, ConcurrentTrieCursor *cursor, const char *key) {
+    bool found = false;
+    epoch_enter((EpochDomain *)&trie->epoch, cursor->epoch_id);
+
+    uint32_t currentNode = trie->root;
+    const char *p = key;
+    for (; *p; p++) {
+        int index = *p - 'a';
+        if (index < 0 || index >= CONCURRENT_TRIE_ALPHABET) {
+            break;
+        }
+        currentNode = atomic_load_explicit(&concurrent_trie_node(trie, currentNode)->children[index],
+                                           memory_order_acquire) & ~CONCURRENT_TRIE_FROZEN;
+        if (!currentNode) {
+            break;
+        }
+    }
+    if (!*p) {
+        found = atomic_load_explicit(&concurrent_trie_node(trie, currentNode)->state, memory_order_acquire)
+                & CONCURRENT_TRIE_END;
+    }
+
+    epoch_exit((EpochDomain *)&trie->epoch, cursor->epoch_id);
+    return found;
+}
+
+// --- Remoção e poda (sob prune_lock) ---
+
+// Devolve um nó podado ao alocador depois do período de graça (ctx = Trie)
+static inline void concurrent_trie_reclaim(void *ctx, uint64_t item) {
+    ConcurrentTrie *trie = ctx;
+    ConcurrentTrieNode *node = concurrent_trie_node(trie, (uint32_t)item);
+    for (int c = 0; c < CONCURRENT_TRIE_ALPHABET; c++) {
+        atomic_store_explicit(&node->children[c], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&node->state, 0, memory_order_relaxed);
+
+    pthread_mutex_lock(&trie->grow_lock);
+    concurrent_trie_push_recycled(trie, (uint32_t)item);
+    pthread_mutex_unlock(&trie->grow_lock);
+}
+
+static inline void concurrent_trie_retire(ConcurrentTrie *trie, uint32_t ref) {
+    atomic_fetch_sub_explicit(&trie->nodes, 1, memory_order_relaxed);
+    // Se o limbo não couber na memória, o nó fica perdido (nunca é reusado cedo demais)
+    epoch_retire(&trie->epoch, &trie->retirer, ref, concurrent_trie_reclaim, trie);
+}
+
+// Liga (freeze = true) ou desliga o bit de congelamento em todos os campos do
+// nó. Retorna true se, no momento do congelamento, o nó não tinha filhos nem
+// marca de fim.
+static inline bool concurrent_trie_freeze(ConcurrentTrieNode *node, bool freeze) {
+    bool empty = true;
+    for (int c = 0; c < CONCURRENT_TRIE_ALPHABET; c++) {
+        uint32_t old = freeze ? atomic_fetch_or(&node->children[c], CONCURRENT_TRIE_FROZEN)
+                              : atomic_fetch_and(&node->children[c], ~CONCURRENT_TRIE_FROZEN);
+        empty &= (old & ~CONCURRENT_TRIE_FROZEN) == 0;
+    }
+    unsigned old = freeze ? atomic_fetch_or(&node->state, CONCURRENT_TRIE_FROZEN)
+                          : atomic_fetch_and(&node->state, ~CONCURRENT_TRIE_FROZEN);
+    return empty && !(old & CONCURRENT_TRIE_END);
+}
+
+// Remove de baixo para cima os nós do caminho path[1..depth] que ficaram sem
+// filhos e sem palavra. path[0] é a raiz, que nunca é removida.
+static inline void concurrent_trie_prune_path(ConcurrentTrie *trie, const uint32_t *path, const char *key,
+                                              size_t depth) {
+    for (size_t d = depth; d > 0; d--) {
+        ConcurrentTrieNode *node = concurrent_trie_node(trie, path[d]);
+
+        // Checagem barata antes de congelar: nós com palavra ou filhos ficam
+        if (atomic_load_explicit(&node->state, memory_order_acquire) & CONCURRENT_TRIE_END) {
+            return;
+        }
+        for (int c = 0; c < CONCURRENT_TRIE_ALPHABET; c++) {
+            if (atomic_load_explicit(&node->children[c], memory_order_acquire)) {
+                return;
+            }
+        }
+        // Um filho ou uma palavra pode ter chegado entre a checagem e o congelamento
+        if (!concurrent_trie_freeze(node, true)) {
+            concurrent_trie_freeze(node, false);
+            return;
+        }
+
+        uint32_t expected = path[d];
+        atomic_compare_exchange_strong(&concurrent_trie_node(trie, path[d - 1])->children[key[d - 1] - 'a'],
+                                       &expected, 0);
+        concurrent_trie_retire(trie, path[d]);
+    }
+}
+
+// Percorre key e grava o caminho em path[0..len]. Retorna o comprimento, ou -1
+// se key tiver caractere inválido ou o caminho não existir.
+static inline long concurrent_trie_walk(const ConcurrentTrie *trie, const char *key, uint32_t *path) {
+    size_t len = 0;
+    path[0] = trie->root;
+    for (const char *p = key; *p; p++, len++) {
+        int index = *p - 'a';
+        if (index < 0 || index >= CONCURRENT_TRIE_ALPHABET) {
+            return -1;
+        }
+        // Só quem segura prune_lock congela nós, então aqui não há bit de congelamento
+        path[len + 1] = atomic_load_explicit(&concurrent_trie_node(trie, path[len])->children[index],
+                                             memory_order_acquire);
+        if (!path[len + 1]) {
+            return -1;
+        }
+    }
+    return (long)len;
+}
+
+// Avança as épocas e devolve ao alocador o que já passou do período de graça
+static inline void concurrent_trie_collect(ConcurrentTrie *trie) {
+    epoch_try_advance(&trie->epoch);
+    epoch_collect(&trie->epoch, &trie->retirer, concurrent_trie_reclaim, trie);
+}
+
+// Remove key. Nós que ficam sem palavras são podados e recuperados depois do
+// período de graça. Retorna 1 se a palavra foi removida, 0 se não estava na
+// Trie, ou -1 se faltar memória.
+static inline int concurrent_trie_delete(ConcurrentTrie *trie, const char *key) {
+    size_t key_len = strlen(key);
+    uint32_t stack_path[64];
+    uint32_t *path = key_len < 64 ? stack_path : malloc((key_len + 1) * sizeof(uint32_t));
+    if (!path) {
+        return -1;
+    }
+
+    int removed = 0;
+    pthread_mutex_lock(&trie->prune_lock);
+    long len = concurrent_trie_walk(trie, key, path);
+    if (len >= 0) {
+        unsigned old = atomic_fetch_and_explicit(&concurrent_trie_node(trie, path[len])->state,
+                                                 ~CONCURRENT_TRIE_END, memory_order_acq_rel);
+        removed = (old & CONCURRENT_TRIE_END) != 0;
+        if (removed) {
+            concurrent_trie_prune_path(trie, path, key, (size_t)len);
+        }
+    }
+    concurrent_trie_collect(trie);
+    pthread_mutex_unlock(&trie->prune_lock);
+
+    if (path != stack_path) {
+        free(path);
+    }
+    return removed;
+}
+
+// Remove a subárvore de parent pelo filho index: congela todos os nós (de cima
+// para baixo, então nenhum filho novo escapa), desliga a subárvore e a recupera
+// inteira. Retorna quantas palavras havia nela, ou -1 se faltar memória.
+static inline long long concurrent_trie_cut(ConcurrentTrie *trie, uint32_t parent, int index) {
+    _Atomic uint32_t *link = &concurrent_trie_node(trie, parent)->children[index];
+    uint32_t top = atomic_load_explicit(link, memory_order_acquire);
+    if (!top) {
+        return 0;
+    }
+
+    // Lista de nós da subárvore, percorrida em largura enquanto cresce
+    size_t count = 0, capacity = 256;
+    uint32_t *nodes = malloc(capacity * sizeof(uint32_t));
+    if (!nodes) {
+        return -1;
+    }
+    nodes[count++] = top;
+    long long words = 0;
+    for (size_t i = 0; i < count; i++) {
+        ConcurrentTrieNode *node = concurrent_trie_node(trie, nodes[i]);
+        words += (atomic_fetch_or(&node->state, CONCURRENT_TRIE_FROZEN) & CONCURRENT_TRIE_END) != 0;
+        for (int c = 0; c < CONCURRENT_TRIE_ALPHABET; c++) {
+            uint32_t child = atomic_fetch_or(&node->children[c], CONCURRENT_TRIE_FROZEN) & ~CONCURRENT_TRIE_FROZEN;
+            if (!child) {
+                continue;
+            }
+            if (count == capacity) {
+                uint32_t *grown = realloc(nodes, capacity * 2 * sizeof(uint32_t));
+                if (!grown) {
+                    // Descongela o que já foi congelado e desiste
+                    for (size_t j = 0; j <= i; j++) {
+                        concurrent_trie_freeze(concurrent_trie_node(trie, nodes[j]), false);
+                    }
+                    free(nodes);
+                    return -1;
+                }
+                nodes = grown;
+                capacity *= 2;
+            }
+            nodes[count++] = child;
+        }
+    }
+
+    atomic_store_explicit(link, 0, memory_order_release);
+    for (size_t i = 0; i < count; i++) {
+        concurrent_trie_retire(trie, nodes[i]);
+    }
+    free(nodes);
+    return words;
+}
+
+// Remove todas as palavras que começam com prefix (prefixo vazio esvazia a
+// Trie). Retorna quantas foram removidas, ou -1 se faltar memória.
+static inline long long concurrent_trie_prune_prefix(ConcurrentTrie *trie, const char *prefix) {
+    size_t prefix_len = strlen(prefix);
+    uint32_t stack_path[64];
+    uint32_t *path = prefix_len < 64 ? stack_path : malloc((prefix_len + 1) * sizeof(uint32_t));
+    if (!path) {
+        return -1;
+    }
+
+    long long words = 0;
+    pthread_mutex_lock(&trie->prune_lock);
+    long len = concurrent_trie_walk(trie, prefix, path);
+    if (len == 0) {
+        for (int c = 0; c < CONCURRENT_TRIE_ALPHABET && words >= 0; c++) {
+            long long cut = concurrent_trie_cut(trie, trie->root, c);
+            words = cut < 0 ? -1 : words + cut;
+        }
+    } else if (len > 0) {
+        words = concurrent_trie_cut(trie, path[len - 1], prefix[len - 1] - 'a');
+        if (words >= 0) {
+            concurrent_trie_prune_path(trie, path, prefix, (size_t)len - 1);
+        }
+    }
+    concurrent_trie_collect(trie);
+    pthread_mutex_unlock(&trie->prune_lock);
+
+    if (path != stack_path) {
+        free(path);
+    }
+    return words;
+}
+
+// Espera o período de graça de tudo o que foi podado e devolve os nós ao alocador
+static inline void concurrent_trie_synchronize(ConcurrentTrie *trie) {
+    pthread_mutex_lock(&trie->prune_lock);
+    epoch_synchronize(&trie->epoch, &trie->retirer, concurrent_trie_reclaim, trie);
+    pthread_mutex_unlock(&trie->prune_lock);
+}
+
+// Nós na Trie: publicados pelos cursores já devolvidos (mais a raiz), menos os podados
+static inline long long concurrent_trie_count(const ConcurrentTrie *trie) {
+    return atomic_load_explicit(&trie->nodes, memory_order_relaxed);
+}
+
+// Bytes mapeados pela arena
+static inline size_t concurrent_trie_mapped_bytes(const ConcurrentTrie *trie) {
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < TRIE_ARENA_MAX_CHUNKS; ++i) {
+        if (atomic_load_explicit(&trie->chunks[i], memory_order_relaxed)) {
+            bytes += trie->chunk_bytes;
+        }
+    }
+    return bytes;
+}
+
+// Devolve todos os blocos de uma vez. Nenhuma outra thread pode estar usando a Trie.
+static inline void concurrent_trie_destroy(ConcurrentTrie *trie) {
+    for (uint32_t i = 0; i < TRIE_ARENA_MAX_CHUNKS; ++i) {
+        char *base = atomic_load_explicit(&trie->chunks[i], memory_order_relaxed);
+        if (base) {
+            munmap(base, trie->chunk_bytes);
+        }
+    }
+    free(trie->chunks);
+    trie->chunks = NULL;
+    free(trie->recycled);
+    trie->recycled = NULL;
+    epoch_retirer_free(&trie->retirer);
+    epoch_destroy(&trie->epoch);
+    pthread_mutex_destroy(&trie->grow_lock);
+    pthread_mutex_destroy(&trie->prune_lock);
+}
+
+// --- Carga em massa particionada pelo(s) primeiro(s) caractere(s) ---
+//
+// Cada chave cai num balde pelo primeiro caractere (27 baldes: 'a'-'z' e um
+// para chaves vazias ou inválidas) ou, com muitas threads, pelos dois
+// primeiros (27 * 27 baldes). Os baldes são distribuídos entre as threads pelo
+// maior primeiro, sempre para a thread menos carregada. As chaves são
+// agrupadas por balde uma única vez (ordenação por contagem, estável), e cada
+// thread percorre só as faixas dos seus baldes. Assim as threads constroem
+// subárvores disjuntas: os CAS praticamente nunca disputam o mesmo filho e as
+// linhas de cache dos nós não migram entre núcleos.
+
+#define CONCURRENT_TRIE_BUCKETS (27 * 27)
+
+// A partir de quantas threads o particionamento usa dois caracteres
+#define CONCURRENT_TRIE_TWO_CHAR_THREADS 8
+
+typedef struct {
+    ConcurrentTrie *trie;
+    const char *const *bucketed;    // Chaves agrupadas por balde, na ordem da entrada
+    const long long *bucket_start;  // Faixa do balde b: [bucket_start[b], bucket_start[b + 1])
+    const uint16_t *owner;          // Thread dona de cada balde
+    int id;
+    int failed;
+} ConcurrentTrieLoadArgs;
+
+static inline int concurrent_trie_bucket(const char *key, int two_chars) {
+    int first = key[0] >= 'a' && key[0] <= 'z' ? key[0] - 'a' + 1 : 0;
+    if (!two_chars || first == 0) {
+        return first * 27;
+    }
+    int second = key[1] >= 'a' && key[1] <= 'z' ? key[1] - 'a' + 1 : 0;
+    return first * 27 + second;
+}
+
+static inline void *concurrent_trie_load_thread(void *arg) {
+    ConcurrentTrieLoadArgs *args = arg;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->failed = EAGAIN;
+        return NULL;
+    }
+    for (int b = 0; b < CONCURRENT_TRIE_BUCKETS && !args->failed; b++) {
+        if (args->owner[b] != args->id) {
+            continue;
+        }
+        for (long long i = args->bucket_start[b]; i < args->bucket_start[b + 1]; i++) {
+            if (concurrent_trie_insert(args->trie, &cursor, args->bucketed[i]) != 0) {
+                args->failed = ENOMEM;
+                break;
+            }
+        }
+    }
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+// Insere keys[0..num_keys) com num_threads threads posicionadas por plan (pode
+// ser NULL). Retorna 0 ou um código de erro (errno).
+static inline int concurrent_trie_bulk_load(ConcurrentTrie *trie, const char *const *keys, long long num_keys,
+                                            int num_threads, const AffinityPlan *plan) {
+    int two_chars = num_threads >= CONCURRENT_TRIE_TWO_CHAR_THREADS;
+    long long *load = calloc(CONCURRENT_TRIE_BUCKETS + (size_t)num_threads, sizeof(long long));
+    long long *start = calloc(CONCURRENT_TRIE_BUCKETS + 1, sizeof(long long));
+    const char **bucketed = malloc((num_keys > 0 ? (size_t)num_keys : 1) * sizeof(const char *));
+    uint16_t *owner = calloc(CONCURRENT_TRIE_BUCKETS, sizeof(uint16_t));
+    int *order = malloc(CONCURRENT_TRIE_BUCKETS * sizeof(int));
+    pthread_t *handles = malloc((size_t)num_threads * sizeof(pthread_t));
+    ConcurrentTrieLoadArgs *args = malloc((size_t)num_threads * sizeof(ConcurrentTrieLoadArgs));
+    if (!load || !start || !bucketed || !owner || !order || !handles || !args) {
+        free(load);
+        free(start);
+        free(bucketed);
+        free(owner);
+        free(order);
+        free(handles);
+        free(args);
+        return ENOMEM;
+    }
+
+    // Peso (caracteres inseridos) e tamanho de cada balde
+    long long *thread_load = load + CONCURRENT_TRIE_BUCKETS;
+    for (long long i = 0; i < num_keys; i++) {
+        int b = concurrent_trie_bucket(keys[i], two_chars);
+        load[b] += (long long)strlen(keys[i]) + 1;
+        start[b + 1]++;
+    }
+
+    // Ordenação por contagem: as chaves de cada balde ficam contíguas, na ordem da entrada
+    for (int b = 0; b < CONCURRENT_TRIE_BUCKETS; b++) {
+        start[b + 1] += start[b];
+    }
+    for (long long i = 0; i < num_keys; i++) {
+        int b = concurrent_trie_bucket(keys[i], two_chars);
+        bucketed[start[b]++] = keys[i];
+    }
+    // O laço acima deixou start[b] no fim do balde b, que é o início do b + 1
+    memmove(start + 1, start, CONCURRENT_TRIE_BUCKETS * sizeof(long long));
+    start[0] = 0;
+
+    // Maior balde primeiro para a thread menos carregada
+    for (int b = 0; b < CONCURRENT_TRIE_BUCKETS; b++) {
+        order[b] = b;
+    }
+    for (int b = 1; b < CONCURRENT_TRIE_BUCKETS; b++) {
+        int current = order[b];
+        int j = b;
+        for (; j > 0 && load[order[j - 1]] < load[current]; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = current;
+    }
+    for (int k = 0; k < CONCURRENT_TRIE_BUCKETS && load[order[k]] > 0; k++) {
+        int lightest = 0;
+        for (int t = 1; t < num_threads; t++) {
+            if (thread_load[t] < thread_load[lightest]) {
+                lightest = t;
+            }
+        }
+        owner[order[k]] = (uint16_t)lightest;
+        thread_load[lightest] += load[order[k]];
+    }
+
+    int ret = 0;
+    int created = 0;
+    for (; created < num_threads; created++) {
+        args[created] = (ConcurrentTrieLoadArgs){trie, bucketed, start, owner, created, 0};
+        ret = affinity_thread_create(&handles[created], plan, created, concurrent_trie_load_thread, &args[created]);
+        if (ret != 0) {
+            break;
+        }
+    }
+    for (int t = 0; t < created; t++) {
+        pthread_join(handles[t], NULL);
+        if (ret == 0 && args[t].failed) {
+            ret = args[t].failed;
+        }
+    }
+
+    free(load);
+    free(start);
+    free(bucketed);
+    free(owner);
+    free(order);
+    free(handles);
+    free(args);
+    return ret;
+}
+
+#endif // CONCURRENT_TRIE_H
@@ -0,0 +1,188 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+// Recuperação de memória baseada em épocas (EBR).
+//
+// Cada thread que lê a estrutura compartilhada se registra e ganha uma vaga.
+// Em volta de cada operação ela chama epoch_enter/epoch_exit, que só gravam a
+// época global atual (ou 0) na sua vaga: nenhuma trava, nenhum laço.
+//
+// Quem remove um objeto da estrutura não o libera na hora: epoch_retire o põe
+// no "limbo" da época em que foi removido. A época global só avança quando
+// todas as threads dentro de uma operação já viram a época atual. Um objeto
+// removido na época e pode ainda estar em uso por quem entrou em e - 1 ou em
+// e, mas não por quem entra depois que a época chega a e + 2. Nesse ponto
+// epoch_collect o entrega à função de liberação.
+//
+// Os objetos são identificados por um uint64_t (um ponteiro ou um índice de
+// arena). Cada EpochRetirer tem três listas de limbo, uma por época módulo 3,
+// e pertence a uma única thread (ou é protegido por uma trava de quem o usa).
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sched.h>
+
+// Vaga de uma thread, numa linha de cache própria
+typedef struct {
+    _Alignas(64) atomic_ullong state;   // 0 = fora de operação; senão (época << 1) | 1
+    atomic_int in_use;
+} EpochSlot;
+
+typedef struct {
+    atomic_ullong global;               // Época atual (começa em 1)
+    EpochSlot *slots;
+    int capacity;
+    atomic_int high_water;              // Vagas já usadas alguma vez (limite da varredura)
+} EpochDomain;
+
+// Objetos removidos numa mesma época
+typedef struct {
+    uint64_t *items;
+    size_t count;
+    size_t capacity;
+    uint64_t epoch;
+} EpochLimbo;
+
+typedef struct {
+    EpochLimbo limbo[3];
+} EpochRetirer;
+
+// Função que libera um objeto depois do período de graça
+typedef void (*EpochFreeFn)(void *ctx, uint64_t item);
+
+// Prepara o domínio para até max_threads threads registradas ao mesmo tempo.
+// Retorna 0 ou -1 se faltar memória.
+static inline int epoch_init(EpochDomain *d, int max_threads) {
+    d->slots = aligned_alloc(64, (size_t)max_threads * sizeof(EpochSlot));
+    if (!d->slots) {
+        return -1;
+    }
+    for (int i = 0; i < max_threads; i++) {
+        atomic_init(&d->slots[i].state, 0);
+        atomic_init(&d->slots[i].in_use, 0);
+    }
+    atomic_init(&d->global, 1);
+    atomic_init(&d->high_water, 0);
+    d->capacity = max_threads;
+    return 0;
+}
+
+static inline void epoch_destroy(EpochDomain *d) {
+    free(d->slots);
+    d->slots = NULL;
+}
+
+// Reserva uma vaga para a thread chamadora. Retorna o índice, ou -1 se todas estiverem ocupadas.
+static inline int epoch_register(EpochDomain *d) {
+    for (int i = 0; i < d->capacity; i++) {
+        int expected = 0;
+        if (atomic_load_explicit(&d->slots[i].in_use, memory_order_relaxed) == 0
+            && atomic_compare_exchange_strong(&d->slots[i].in_use, &expected, 1)) {
+            int high = atomic_load(&d->high_water);
+            while (high < i + 1 && !atomic_compare_exchange_weak(&d->high_water, &high, i + 1)) {
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+static inline void epoch_unregister(EpochDomain *d, int id) {
+    atomic_store_explicit(&d->slots[id].state, 0, memory_order_release);
+    atomic_store_explicit(&d->slots[id].in_use, 0, memory_order_release);
+}
+
+// Início de uma operação: anuncia a época vista. A troca seq_cst (xchg no
+// x86, uma barreira completa) impede que as leituras da estrutura subam para
+// antes do anúncio; ao contrário de um fence, o ThreadSanitizer a entende.
+static inline void epoch_enter(EpochDomain *d, int id) {
+    uint64_t e = atomic_load_explicit(&d->global, memory_order_relaxed);
+    atomic_exchange_explicit(&d->slots[id].state, (e << 1) | 1, memory_order_seq_cst);
+}
+
+static inline void epoch_exit(EpochDomain *d, int id) {
+    atomic_store_explicit(&d->slots[id].state, 0, memory_order_release);
+}
+
+// Avança a época global se todas as threads em operação já estão nela.
+// Retorna true se avançou (ou se outra thread avançou ao mesmo tempo).
+static inline bool epoch_try_advance(EpochDomain *d) {
+    uint64_t e = atomic_load_explicit(&d->global, memory_order_seq_cst);
+    int high = atomic_load_explicit(&d->high_water, memory_order_acquire);
+    for (int i = 0; i < high; i++) {
+        uint64_t state = atomic_load_explicit(&d->slots[i].state, memory_order_seq_cst);
+        if ((state & 1) && (state >> 1) != e) {
+            return false;
+        }
+    }
+    atomic_compare_exchange_strong(&d->global, &e, e + 1);
+    return true;
+}
+
+// Libera os limbos cujo período de graça já passou. Retorna quantos objetos foram liberados.
+static inline size_t epoch_collect(EpochDomain *d, EpochRetirer *r, EpochFreeFn free_fn, void *ctx) {
+    uint64_t e = atomic_load_explicit(&d->global, memory_order_acquire);
+    size_t freed = 0;
+    for (int b = 0; b < 3; b++) {
+        EpochLimbo *limbo = &r->limbo[b];
+        if (limbo->count > 0 && limbo->epoch + 2 <= e) {
+            for (size_t i = 0; i < limbo->count; i++) {
+                free_fn(ctx, limbo->items[i]);
+            }
+            freed += limbo->count;
+            limbo->count = 0;
+        }
+    }
+    return freed;
+}
+
+// Põe item no limbo da época atual. Retorna 0 ou -1 se faltar memória (nesse
+// caso o item não foi guardado e continua sendo responsabilidade de quem chamou).
+static inline int epoch_retire(EpochDomain *d, EpochRetirer *r, uint64_t item, EpochFreeFn free_fn, void *ctx) {
+    uint64_t e = atomic_load_explicit(&d->global, memory_order_acquire);
+    EpochLimbo *limbo = &r->limbo[e % 3];
+    if (limbo->count > 0 && limbo->epoch != e) {
+        // A lista é de e - 3 ou antes: o período de graça dela já passou
+        epoch_collect(d, r, free_fn, ctx);
+    }
+    if (limbo->count == limbo->capacity) {
+        size_t capacity = limbo->capacity ? limbo->capacity * 2 : 256;
+        uint64_t *items = realloc(limbo->items, capacity * sizeof(uint64_t));
+        if (!items) {
+            return -1;
+        }
+        limbo->items = items;
+        limbo->capacity = capacity;
+    }
+    limbo->epoch = e;
+    limbo->items[limbo->count++] = item;
+    return 0;
+}
+
+// Objetos ainda no limbo
+static inline size_t epoch_pending(const EpochRetirer *r) {
+    return r->limbo[0].count + r->limbo[1].count + r->limbo[2].count;
+}
+
+// Espera até liberar tudo o que está no limbo (cedendo a CPU enquanto houver leitores antigos)
+static inline void epoch_synchronize(EpochDomain *d, EpochRetirer *r, EpochFreeFn free_fn, void *ctx) {
+    while (epoch_pending(r) > 0) {
+        if (!epoch_try_advance(d)) {
+            sched_yield();
+        }
+        epoch_collect(d, r, free_fn, ctx);
+    }
+}
+
+// Descarta os limbos sem chamar a função de liberação (a memória inteira vai embora junto)
+static inline void epoch_retirer_free(EpochRetirer *r) {
+    for (int b = 0; b < 3; b++) {
+        free(r->limbo[b].items);
+        r->limbo[b].items = NULL;
+        r->limbo[b].count = r->limbo[b].capacity = 0;
+    }
+}
+
+#endif // EPOCH_H
@@ -0,0 +1,188 @@
+#ifndef PALAVRAS_H
+#define PALAVRAS_H
+
+// Conjuntos de palavras usados pelos programas da Trie: a lista fixa de
+// inserção, a lista de busca (algumas presentes, outras não) e um gerador de
+// palavras sintéticas para medições com dicionários grandes.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Lista de palavras para inserir
+static const char words[][32] = {"the", "a", "there", "answer", "any", "by", "bye", "their",
+                                 "theirself", "them", "themselves", "then", "thence", "hence",
+                                 "thereafter", "thereby", "therefore", "thereto", "thermos",
+                                 "these", "they", "thick", "thin", "thing", "think", "third",
+                                 "this", "those", "though", "thought", "thousand", "three",
+                                 "thro", "through", "throughout", "throw", "thru", "thus",
+                                 "thy", "thyself", "tie", "tight", "till", "time", "tin",
+                                 "tip", "tire", "to", "today", "together", "told", "ton",
+                                 "tone", "tongue", "tonight", "too", "took", "tool", "top",
+                                 "topsy", "turvy", "toss", "tot", "touch", "tough", "tour",
+                                 "tow", "toward", "towards", "tower", "town", "toy", "trace",
+                                 "track", "trade", "train", "tramp", "transfer", "trap", "trash",
+                                 "travel", "traverse", "tray", "tread", "treasure", "treat",
+                                 "treaty", "tree", "tremble", "trick", "trim", "trip", "troop",
+                                 "trot", "trouble", "trough", "trousers", "trout", "trow", "truce",
+                                 "true", "truly", "trump", "trunk", "trust", "truth", "try",
+                                 "tub", "tube", "tumble", "tune", "turn", "tutor", "twain",
+                                 "tweed", "twelfth", "twelve", "twentieth", "twenty", "twice",
+                                 "twig", "twilight", "twin", "twine", "twinkle", "twirl", "twist",
+                                 "twit", "two", "tying", "type", "typo", "ugly", "ulcer",
+                                 "ultimate", "ultimo", "ultra", "umbrella", "un", "unanimous",
+                                 "uncanny", "uncertain", "uncle", "uncommon", "unconscious",
+                                 "under", "undergo", "underground", "underneath", "undersigned",
+                                 "understand", "undertake", "undertaking", "underwear", "undetermined",
+                                 "undoubtedly", "unequal", "uneven", "unexpected", "unfair",
+                                 "unfit", "unfold", "unfortunate", "unfortunately", "unfrequented",
+                                 "unfriendly", "unfurnished", "ungainly", "unheard", "unholy",
+                                 "uniform", "unite", "united", "units", "unity", "universal",
+                                 "university", "unkind", "unknown", "unlawful", "unless", "unlike",
+                                 "unlikely", "unloading", "unlucky", "unmarried", "unmerciful",
+                                 "unmistakable", "unnecessary", "unoccupied", "unpaid", "unparalleled",
+                                 "unpleasant", "unprecedented", "unprejudiced", "unprepared",
+                                 "unprincipled", "unprotected", "unprovided", "unpublished",
+                                 "unpunished", "unqualified", "unquestionable", "unravel",
+                                 "unreasonable", "unredeemed", "unregulated", "unreliable",
+                                 "unremitting", "unreserved", "unrestrained", "unrestricted",
+                                 "unrighteous", "unrivaled", "unroll", "unruffled", "unsatisfactory",
+                                 "unseasonable", "unseen", "unselfish", "unsettled", "unshaken",
+                                 "unsightly", "unskillful", "unsociable", "unsolicited",
+                                 "unsophisticated", "unspeakable", "unstable", "unsteady",
+                                 "unsuccessful", "unsuitable", "unsurpassed", "unsuspecting",
+                                 "untamed", "untimely", "untiring", "untold", "untouched",
+                                 "untoward", "untried", "untrue", "unusual", "unvarnished",
+                                 "unveil", "unwarrantable", "unwary", "unwearied", "unwelcome",
+                                 "unwell", "unwieldy", "unwilling", "unwind", "unwise",
+                                 "unwittingly", "unwomanly", "unwonted", "unworthy", "unwrap",
+                                 "unyoke", "up", "upbraid", "upheld", "uphill", "uphold",
+                                 "upland", "upon", "upper", "uppermost", "upright", "uprising",
+                                 "uproar", "uproot", "upset", "upstairs", "upstream", "upward",
+                                 "urban", "urchin", "urge", "urgent", "usage", "use",
+                                 "useful", "usefulness", "useless", "usher", "usual", "usurp",
+                                 "usury", "utensil", "utility", "utilize", "utmost", "utter",
+                                 "utterance", "utterly", "v", "vacancy", "vacant", "vacate",
+                                 "vacation", "vague", "vaguely", "vain", "valentine", "valet",
+                                 "valiant", "valid", "validity", "valley", "valor", "valuable",
+                                 "valuation", "value", "valve", "vampire", "van", "vandal",
+                                 "vane", "vang", "vanilla", "vanish", "vanity", "vanquish",
+                                 "vantage", "vapid", "vapor", "variable", "variation", "varied",
+                                 "variety", "various", "varnish", "vary", "vase", "vassal",
+                                 "vast", "vastly", "vat", "vault", "vaunt", "vicious", "victim",
+                                 "victor", "victorious", "victory", "victual", "vie", "view",
+                                 "vigil", "vigilant", "vigor", "vigorous", "vile", "village",
+                                 "villain", "vine", "vinegar", "vineyard", "vintage", "viol",
+                                 "violate", "violation", "violence", "violent", "violet", "violin",
+                                 "vipers", "virago", "virgin", "virile", "virtual", "virtue",
+                                 "virtuoso", "virulent", "visage", "viscous", "visible", "vision",
+                                 "visit", "visitor", "visor", "vista", "visual", "vital",
+                                 "vitality", "vitals", "vivid", "vividly", "vixen", "vocal",
+                                 "vocation", "vociferous", "vogue", "voice", "void", "volatile",
+                                 "volcanic", "volcano", "volley", "volt", "volume", "voluminous",
+                                 "voluntary", "volunteer", "voluptuous", "vomit", "voodoo",
+                                 "voracious", "vortex", "vote", "voter", "vouch", "vowel",
+                                 "voyage", "vulg", "vulgar", "vulnerable", "vulture", "w",
+                                 "wad", "wade", "wafer", "wag", "wage", "wager", "wagon",
+                                 "wail", "waist", "wait", "waiter", "waiting", "wake", "wale",
+                                 "walk", "wall", "wallet", "wallop", "wallow", "walnut",
+                                 "walrus", "waltz", "wan", "wand", "wander", "wane", "want",
+                                 "wanton", "war", "ward", "warden", "wardrobe", "ware", "warfare",
+                                 "warm", "warmth", "warn", "warning", "warp", "warrant", "warren",
+                                 "wary", "wash", "wasp", "waste", "waster", "watch", "watchful",
+                                 "water", "waterfall", "watermelon", "wave", "waver", "wax",
+                                 "way", "wayfarer", "wayward", "we", "weak", "weaken", "weakness",
+                                 "weal", "wealth", "wealthy", "wean", "weapon", "wear",
+                                 "weariness", "weary", "weather", "weave", "weaver", "web",
+                                 "wed", "wedding", "wedge", "wedlock", "wee", "weed", "week",
+                                 "weekly", "weep", "weigh", "weight", "weighty", "weird",
+                                 "welcome", "weld", "welfare", "well", "wellnigh", "welt",
+                                 "wench", "wend", "went", "wept", "were", "west", "western",
+                                 "wet", "whale", "whaler", "wharf", "what", "whatever",
+                                 "whatsoever", "wheat", "wheedle", "wheel", "wheeze", "whelp",
+                                 "when", "whence", "whenever", "whensoever", "where", "whereat",
+                                 "whereby", "wherefore", "wherein", "whereof", "whereon",
+                                 "wheresoever", "whereupon", "wherever", "wherewith", "whet",
+                                 "whether", "whetstone", "whew", "whey", "which", "whichever",
+                                 "whiff", "while", "whim", "whimper", "whimsical", "whine",
+                                 "whining", "whip", "whir", "whirl", "whirlpool", "whirlwind",
+                                 "whisk", "whisker", "whiskey", "whisper", "whistle", "white",
+                                 "whiten", "whither", "whitish", "whittle", "whiz", "who",
+                                 "whoa", "whoever", "whole", "wholehearted", "wholly", "whom",
+                                 "whomever", "whoop", "whooping", "whose", "whosoever", "why",
+                                 "wicked", "wickedness", "wide", "widely", "widen", "widow",
+                                 "widower", "width", "wield", "wife", "wig", "wiggle",
+                                 "wild", "wilder", "wilderness", "wildly", "wile", "will",
+                                 "willing", "willow", "wily", "win", "wince", "wind",
+                                 "windmill", "window", "wine", "wing", "wink", "winner",
+                                 "winning", "winter", "wipe", "wire", "wisdom", "wise",
+                                 "wish", "wisp", "wistful", "wit", "witch", "witchcraft",
+                                 "with", "withdraw", "withdrawal", "withe", "withhold",
+                                 "within", "without", "withstand", "witness", "witticism",
+                                 "wittingly", "witty", "wives", "woe", "woeful", "wolf",
+                                 "woman", "womanly", "womb", "won", "wonder", "wonderful",
+                                 "wondrous", "wont", "woo", "wood", "wooden", "woodland",
+                                 "woodman", "woody", "wool", "woolen", "word", "wordy",
+                                 "wore", "work", "worker", "working", "workman", "world",
+                                 "worldly", "worm", "worn", "worry", "worse", "worship",
+                                 "worst", "worth", "worthless", "worthy", "would", "wound",
+                                 "wove", "woven", "wr", "wrack", "wraith", "wrangle", "wrap",
+                                 "wrapped", "wrapper", "wrapping", "wrath", "wreak", "wreath",
+                                 "wreathe", "wreck", "wreckage", "wrench", "wrest", "wrestle",
+                                 "wretch", "wretched", "wriggle", "wring", "wrinkle", "wrist",
+                                 "writ", "write", "writer", "writhe", "writing", "written",
+                                 "wrong", "wrongful", "wrongly", "wrote", "wrought", "wrung",
+                                 "wry", "y", "yam", "yankee", "yard", "yarn", "yawl",
+                                 "yawn", "ye", "yea", "year", "yearly", "yearn", "yeast",
+                                 "yell", "yellow", "yelp", "yeoman", "yes", "yest",
+                                 "yesterday", "yet", "yield", "yoke", "yolk", "yon",
+                                 "yonder", "you", "young", "younger", "youngest", "your",
+                                 "yours", "yourself", "yourselves", "youth", "youthful",
+                                 "yule", "zany", "zeal", "zealot", "zealous", "zebra",
+                                 "zenith", "zephyr", "zinc", "zodiac", "zone", "zonked",
+                                 "zoom" // Adicionando mais palavras para ter uma medição mais significativa
+                                 };
+
+// Lista de palavras para buscar (algumas presentes, outras não)
+static const char search_words[][32] = {"the", "these", "their", "thaw", "any", "by", "bye", "them",
+                                        "algorithm", "structure", "data", "performance", "timing",
+                                        "zebra", "youth", "quick", "brown", "fox", "jumps",
+                                        "over", "the", "lazy", "dogs", "trie", "node",
+                                        "children", "alphabet", "size", "insert", "search",
+                                        "freememory", "example", "function", "pointer", "malloc",
+                                        "calloc", "sizeof", "memcpy", "time", "monotonic",
+                                        "nanoseconds", "seconds", "elapsed", "duration", "code",
+                                        "programming", "language", "computer", "science", "engineer",
+                                        "professor", "student", "learning", "knowledge", "expert"};
+
+// Gera n palavras pseudoaleatórias de 3 a 12 letras (xorshift64 com semente
+// fixa), separadas por '\0' num único buffer; (*offsets)[i] é o início da i-ésima.
+// Retorna o buffer, ou NULL se faltar memória.
+static inline char *generateWords(long long n, long long **offsets) {
+    char *buf = malloc((size_t)n * 13);
+    *offsets = malloc((size_t)n * sizeof(long long));
+    if (!buf || !*offsets) {
+        free(buf);
+        free(*offsets);
+        return NULL;
+    }
+
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    long long pos = 0;
+    for (long long i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        int len = 3 + (int)(x % 10);
+        (*offsets)[i] = pos;
+        for (int j = 0; j < len; j++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            buf[pos++] = (char)('a' + x % 26);
+        }
+        buf[pos++] = '\0';
+    }
+    return buf;
+}
+
+#endif // PALAVRAS_H
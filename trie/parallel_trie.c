@@ -0,0 +1,355 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "../common/affinity.h"
+#include "trie.h"
+#include "concurrent_trie.h"
+#include "palavras.h"
+
+// Repetições padrão de cada medição (vale a mediana)
+#define DEFAULT_REPEATS 3
+
+// Palavras sintéticas padrão: a lista fixa é pequena demais para medir escala
+#define DEFAULT_SYNTHETIC 2000000
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *times, int n) {
+    qsort(times, (size_t)n, sizeof(double), cmp_double);
+    return n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+}
+
+// Argumentos das threads de inserção compartilhada e de busca: cada thread
+// fica com as chaves i ≡ id (mod num_threads), sem particionar a Trie
+typedef struct {
+    ConcurrentTrie *trie;
+    const char *const *keys;
+    long long num_keys;
+    int id;
+    int num_threads;
+    long long found;                // Apenas na busca
+    int failed;                     // Código de erro (0 = ok)
+} StrideArgs;
+
+static void *shared_insert_thread(void *arg) {
+    StrideArgs *args = arg;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->failed = EAGAIN;
+        return NULL;
+    }
+    for (long long i = args->id; i < args->num_keys; i += args->num_threads) {
+        if (concurrent_trie_insert(args->trie, &cursor, args->keys[i]) != 0) {
+            args->failed = ENOMEM;
+            break;
+        }
+    }
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+static void *search_thread(void *arg) {
+    StrideArgs *args = arg;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->failed = EAGAIN;
+        return NULL;
+    }
+    long long found = 0;
+    for (long long i = args->id; i < args->num_keys; i += args->num_threads) {
+        found += concurrent_trie_search(args->trie, &cursor, args->keys[i]);
+    }
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    args->found = found;
+    return NULL;
+}
+
+// Roda fn em num_threads threads com chaves intercaladas. Retorna 0 ou um código de erro.
+static int run_strided(ConcurrentTrie *trie, const char *const *keys, long long num_keys, int num_threads,
+                       const AffinityPlan *plan, void *(*fn)(void *), long long *found) {
+    pthread_t *handles = malloc((size_t)num_threads * sizeof(pthread_t));
+    StrideArgs *args = malloc((size_t)num_threads * sizeof(StrideArgs));
+    if (!handles || !args) {
+        free(handles);
+        free(args);
+        return ENOMEM;
+    }
+
+    int ret = 0;
+    int created = 0;
+    for (; created < num_threads; created++) {
+        args[created] = (StrideArgs){trie, keys, num_keys, created, num_threads, 0, 0};
+        ret = affinity_thread_create(&handles[created], plan, created, fn, &args[created]);
+        if (ret != 0) {
+            break;
+        }
+    }
+    long long total = 0;
+    for (int t = 0; t < created; t++) {
+        pthread_join(handles[t], NULL);
+        total += args[t].found;
+        if (ret == 0 && args[t].failed) {
+            ret = args[t].failed;
+        }
+    }
+    if (found) {
+        *found = total;
+    }
+    free(handles);
+    free(args);
+    return ret;
+}
+
+// Leitor que roda junto com a carga em massa: percorre as chaves em voltas e
+// confere que uma chave já encontrada nunca volta a sumir
+typedef struct {
+    ConcurrentTrie *trie;
+    const char *const *keys;
+    long long num_keys;
+    atomic_int *done;
+    unsigned char *seen;
+    long long searches;
+    long long regressions;
+} ReaderArgs;
+
+static void *reader_thread(void *arg) {
+    ReaderArgs *args = arg;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->regressions = -1;
+        return NULL;
+    }
+    while (!atomic_load_explicit(args->done, memory_order_acquire)) {
+        for (long long i = 0; i < args->num_keys; i++) {
+            bool found = concurrent_trie_search(args->trie, &cursor, args->keys[i]);
+            args->regressions += args->seen[i] && !found;
+            args->seen[i] |= found;
+        }
+        args->searches += args->num_keys;
+    }
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    AffinityPolicy policy = AFFINITY_NONE;
+    long long synthetic = DEFAULT_SYNTHETIC;
+    int repeats = DEFAULT_REPEATS;
+    int opt;
+    while ((opt = getopt(argc, argv, "a:n:r:")) != -1) {
+        if (opt == 'a' && affinity_parse_policy(optarg, &policy) == 0) {
+            continue;
+        }
+        if (opt == 'n' && (synthetic = atoll(optarg)) >= 0) {
+            continue;
+        }
+        if (opt == 'r' && (repeats = atoi(optarg)) > 0) {
+            continue;
+        }
+        optind = argc + 1;
+        break;
+    }
+    if (argc - optind != 1 || atoi(argv[optind]) <= 0) {
+        fprintf(stderr, "Uso: %s [-a none|compact|scatter|physical] [-n palavras sintéticas (0 = lista fixa)] "
+                "[-r repetições] <máximo de threads>\n", argv[0]);
+        return 1;
+    }
+    int max_threads = atoi(argv[optind]);
+
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    if (affinity_read_topology(&topo) != 0 || affinity_plan(&topo, policy, max_threads, &plan) != 0
+        || affinity_pin_self(&plan, 0) != 0) {
+        perror("Falha ao aplicar a afinidade");
+        return 1;
+    }
+    affinity_print(stdout, &topo, &plan);
+
+    // Mesma entrada para todas as versões
+    long long num_words = sizeof(words) / sizeof(words[0]);
+    long long *synthetic_offsets = NULL;
+    char *synthetic_words = NULL;
+    if (synthetic > 0) {
+        synthetic_words = generateWords(synthetic, &synthetic_offsets);
+        if (!synthetic_words) {
+            perror("Falha ao gerar as palavras sintéticas");
+            return 1;
+        }
+        num_words = synthetic;
+    }
+    const char **keys = malloc((size_t)num_words * sizeof(char *));
+    unsigned char *seen = malloc((size_t)num_words);
+    if (!keys || !seen) {
+        perror("Erro de alocação");
+        return 1;
+    }
+    for (long long i = 0; i < num_words; i++) {
+        keys[i] = synthetic_words ? synthetic_words + synthetic_offsets[i] : words[i];
+    }
+
+    double *times = malloc((size_t)repeats * sizeof(double));
+    if (!times) {
+        perror("Erro de alocação");
+        return 1;
+    }
+    struct timespec t0, t1;
+
+    // --- Referência sequencial (trie.h) ---
+    printf("Inserindo %lld palavras (%d repetições por medição)...\n", num_words, repeats);
+    uint32_t seq_nodes = 0;
+    for (int r = 0; r < repeats; r++) {
+        struct Trie trie;
+        if (initTrie(&trie) != 0) {
+            perror("Falha ao criar a Trie");
+            return 1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (long long i = 0; i < num_words; i++) {
+            insert(&trie, keys[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        times[r] = elapsed(&t0, &t1);
+        seq_nodes = trie_arena_count(&trie.arena);
+        freeTrie(&trie);
+    }
+    double seq_time = median(times, repeats);
+    printf("Sequencial: %.6f s, %.0f palavras/s, %u nós\n\n", seq_time, num_words / seq_time, seq_nodes);
+
+    // --- Varredura de threads: 1, 2, 4, ... e o máximo ---
+    printf("%8s %14s %14s %9s %10s %14s %14s %14s\n", "threads", "particionada_s", "palavras/s",
+           "speedup", "eficiência", "compartilhada_s", "speedup_comp", "buscas/s");
+    int errors = 0;
+    for (int t = 1; t <= max_threads; t = t < max_threads && t * 2 > max_threads ? max_threads : t * 2) {
+        double part_times[repeats], shared_times[repeats], search_times[repeats];
+        for (int r = 0; r < repeats; r++) {
+            // Carga em massa particionada pelo primeiro caractere
+            ConcurrentTrie trie;
+            if (concurrent_trie_init(&trie) != 0) {
+                perror("Falha ao criar a Trie");
+                return 1;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            int ret = concurrent_trie_bulk_load(&trie, keys, num_words, t, &plan);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            part_times[r] = elapsed(&t0, &t1);
+
+            // Busca paralela de todas as palavras na Trie recém-construída
+            long long found = 0;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            if (ret == 0) {
+                ret = run_strided(&trie, keys, num_words, t, &plan, search_thread, &found);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            search_times[r] = elapsed(&t0, &t1);
+            if (ret != 0) {
+                errno = ret;
+                perror("Falha na carga paralela");
+                return 1;
+            }
+            errors += found != num_words || concurrent_trie_count(&trie) != seq_nodes;
+            concurrent_trie_destroy(&trie);
+
+            // Inserção compartilhada: chaves intercaladas, todas as threads disputando a Trie inteira
+            if (concurrent_trie_init(&trie) != 0) {
+                perror("Falha ao criar a Trie");
+                return 1;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            ret = run_strided(&trie, keys, num_words, t, &plan, shared_insert_thread, NULL);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            shared_times[r] = elapsed(&t0, &t1);
+            if (ret != 0) {
+                errno = ret;
+                perror("Falha na inserção compartilhada");
+                return 1;
+            }
+            errors += concurrent_trie_count(&trie) != seq_nodes;
+            concurrent_trie_destroy(&trie);
+        }
+        double part = median(part_times, repeats);
+        double shared = median(shared_times, repeats);
+        double search = median(search_times, repeats);
+        printf("%8d %14.6f %14.0f %9.2f %9.1f%% %14.6f %14.2f %14.0f\n", t, part, num_words / part,
+               seq_time / part, 100.0 * seq_time / part / t, shared, seq_time / shared, num_words / search);
+    }
+
+    // --- Leitor wait-free rodando junto com a carga em massa ---
+    ConcurrentTrie trie;
+    if (concurrent_trie_init(&trie) != 0) {
+        perror("Falha ao criar a Trie");
+        return 1;
+    }
+    memset(seen, 0, (size_t)num_words);
+    atomic_int done = 0;
+    ReaderArgs reader_args = {&trie, keys, num_words, &done, seen, 0, 0};
+    pthread_t reader;
+    if (pthread_create(&reader, NULL, reader_thread, &reader_args) != 0) {
+        perror("Falha ao criar o leitor");
+        return 1;
+    }
+    int ret = concurrent_trie_bulk_load(&trie, keys, num_words, max_threads, &plan);
+    atomic_store_explicit(&done, 1, memory_order_release);
+    pthread_join(reader, NULL);
+    if (ret != 0) {
+        errno = ret;
+        perror("Falha na carga paralela");
+        return 1;
+    }
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(&trie, &cursor) != 0) {
+        perror("Falha ao registrar a thread principal");
+        return 1;
+    }
+    long long missing = 0;
+    for (long long i = 0; i < num_words; i++) {
+        missing += !concurrent_trie_search(&trie, &cursor, keys[i]);
+    }
+    printf("\nLeitura concorrente com %d escritores: %lld buscas, %lld chaves que sumiram depois de vistas, "
+           "%lld ausentes ao final\n", max_threads, reader_args.searches, reader_args.regressions, missing);
+    errors += reader_args.regressions != 0 || missing > 0;
+
+    // A lista de busca deve dar a mesma resposta que a Trie sequencial
+    struct Trie reference;
+    if (initTrie(&reference) != 0) {
+        perror("Falha ao criar a Trie");
+        return 1;
+    }
+    for (long long i = 0; i < num_words; i++) {
+        insert(&reference, keys[i]);
+    }
+    int num_search_words = sizeof(search_words) / sizeof(search_words[0]);
+    for (int i = 0; i < num_search_words; i++) {
+        errors += concurrent_trie_search(&trie, &cursor, search_words[i]) != search(&reference, search_words[i]);
+    }
+    errors += concurrent_trie_search(&trie, &cursor, "ther") != search(&reference, "ther");
+    concurrent_trie_cursor_release(&trie, &cursor);
+    freeTrie(&reference);
+    concurrent_trie_destroy(&trie);
+
+    printf("Verificação contra a versão sequencial: %s (%d divergências)\n", errors ? "FALHOU" : "ok", errors);
+
+    free(times);
+    free(keys);
+    free(seen);
+    free(synthetic_words);
+    free(synthetic_offsets);
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
+    return errors ? 1 : 0;
+}
@@ -1,275 +1,182 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
 #include <time.h> // Incluir para medição de tempo
-
-// Tamanho do alfabeto para letras minúsculas 'a'-'z'
-#define ALPHABET_SIZE 26
-
-// Estrutura para um nó da Trie
-struct TrieNode {
-    struct TrieNode *children[ALPHABET_SIZE];
-    // true se o nó representa o final de uma palavra
-    bool isEndOfWord;
-};
-
-// Função para criar um novo nó da Trie
-struct TrieNode *createNode() {
-    struct TrieNode *newNode = (struct TrieNode *)malloc(sizeof(struct TrieNode));
-
-    if (newNode) {
-        int i;
-        newNode->isEndOfWord = false; // Inicializa como não sendo fim de palavra
-
-        // Inicializa todos os ponteiros filhos como NULL
-        for (i = 0; i < ALPHABET_SIZE; i++) {
-            newNode->children[i] = NULL;
-        }
+#include <unistd.h>
+
+#include "../common/affinity.h"
+#include "../common/trace.h"
+#include "trie.h"
+#include "trie_loader.h"
+#include "trie_autocomplete.h"
+#include "palavras.h"
+
+// Mapeia e divide em palavras o arquivo path, medindo só a leitura (MB/s),
+// separada da construção da Trie. Retorna 0 ou -1 (errno definido).
+static int load_words(const char *path, int num_threads, const AffinityPlan *plan,
+                      TrieInput *input, TrieTokens *tokens) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (trie_input_open(path, input) != 0) {
+        return -1;
+    }
+    if (trie_tokenize(input, num_threads, plan, tokens) != 0) {
+        int saved = errno;
+        trie_input_close(input);
+        errno = saved;
+        return -1;
     }
-    return newNode;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Leitura de %s (%s): %.1f MB, %zu palavras em %.6f segundos (%.1f MB/s, %d threads)\n",
+           path, input->mapped ? "mmap" : "buffer", input->length / 1e6, tokens->count, elapsed,
+           input->length / 1e6 / elapsed, num_threads);
+    return 0;
 }
 
-// Função para inserir uma string na Trie
-void insert(struct TrieNode *root, const char *key) {
-    struct TrieNode *currentNode = root;
-    int length = strlen(key);
-    int i;
+// Respostas por prefixo no autocompletar e prefixos consultados quando -c não é usado
+#define DEFAULT_TOP_K 5
+#define MAX_PREFIXES 64
+static const char *default_prefixes[] = {"t", "th", "thr", "un", "under"};
 
-    for (i = 0; i < length; i++) {
-        // Calcula o índice do caractere (ex: 'a' -> 0, 'b' -> 1)
-        int index = key[i] - 'a';
 
-        // Verifica se o caractere está dentro do alfabeto esperado
-        if (index < 0 || index >= ALPHABET_SIZE) {
-            // printf("Erro na inserção: Caractere '%c' fora do alfabeto suportado ('a'-'z').\n", key[i]);
-            return; // Ignora caracteres inválidos silenciosamente para não afetar a medição de tempo principal
-        }
+// Operações por intervalo do trace (-T): um intervalo por operação mediria
+// sobretudo a leitura dos contadores
+#define TRACE_BATCH 4096
 
-        // Se o filho correspondente ao caractere não existe, cria um novo nó
-        if (!currentNode->children[index]) {
-            currentNode->children[index] = createNode();
+// --- Exemplo de Uso com Medição de Tempo ---
+int main(int argc, char *argv[]) {
+    // Política de afinidade opcional: fixa a thread principal antes de criar
+    // qualquer nó, para que os nós (primeiro toque) fiquem no nó NUMA dela
+    AffinityPolicy policy = AFFINITY_NONE;
+    long long synthetic = 0;    // -n: insere N palavras sintéticas em vez da lista fixa
+    const char *dict_path = NULL;   // -d: dicionário (uma palavra por linha, "-" = entrada padrão)
+    const char *query_path = NULL;  // -q: palavras a buscar, no mesmo formato
+    int load_threads = 1;           // -p: threads que dividem os arquivos em palavras
+    const char *prefixes[MAX_PREFIXES];     // -c: prefixos para o autocompletar (repetível)
+    int num_prefixes = 0;
+    int top_k = DEFAULT_TOP_K;      // -k: respostas por prefixo
+    const char *trace_path = NULL;  // -T: trace das inserções e buscas (formato do Chrome)
+    long long uniform_count = 0;    // -u: Trie à parte com N palavras sintéticas de frequências iguais
+    int opt;
+    while ((opt = getopt(argc, argv, "a:n:d:q:p:c:k:T:u:")) != -1) {
+        if (opt == 'a' && affinity_parse_policy(optarg, &policy) == 0) {
+            continue;
         }
-
-        // Move para o nó filho
-        currentNode = currentNode->children[index];
+        if (opt == 'n' && (synthetic = atoll(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'd' || opt == 'q') {
+            *(opt == 'd' ? &dict_path : &query_path) = optarg;
+            continue;
+        }
+        if (opt == 'p' && (load_threads = atoi(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'c' && num_prefixes < MAX_PREFIXES) {
+            prefixes[num_prefixes++] = optarg;
+            continue;
+        }
+        if (opt == 'k' && (top_k = atoi(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'T') {
+            trace_path = optarg;
+            continue;
+        }
+        if (opt == 'u' && (uniform_count = atoll(optarg)) > 0) {
+            continue;
+        }
+        fprintf(stderr, "Uso: %s [-a none|compact|scatter|physical] [-n palavras sintéticas | -d dicionário] "
+                "[-q consultas] [-p threads de leitura] [-c prefixo]... [-k respostas] [-T trace] "
+                "[-u palavras de frequências iguais]\n", argv[0]);
+        return 1;
     }
-
-    // Marca o nó final como o fim de uma palavra
-    currentNode->isEndOfWord = true;
-}
-
-// Função para buscar uma string na Trie
-// Retorna true se a string for encontrada como uma palavra completa, false caso contrário
-bool search(struct TrieNode *root, const char *key) {
-    struct TrieNode *currentNode = root;
-    int length = strlen(key);
-    int i;
-
-    for (i = 0; i < length; i++) {
-        int index = key[i] - 'a';
-
-         // Verifica se o caractere está dentro do alfabeto esperado
-        if (index < 0 || index >= ALPHABET_SIZE) {
-            return false; // Caractere inválido, palavra não está na Trie
+    if (trace_path) {
+        if (!trace_enabled()) {
+            fprintf(stderr, "Aviso: compilado sem -DTRACE_ENABLED; -T não grava nada.\n");
         }
+        trace_init(0, 1);
+        trace_thread_begin("principal");
+    }
+    TraceSpan span;
+
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    if (affinity_read_topology(&topo) != 0 || affinity_plan(&topo, policy, load_threads, &plan) != 0
+        || affinity_pin_self(&plan, 0) != 0) {
+        perror("Falha ao aplicar a afinidade");
+        return 1;
+    }
+    affinity_print(stdout, &topo, &plan);
 
-        // Se o filho correspondente ao caractere não existe, a palavra não está na Trie
-        if (!currentNode->children[index]) {
-            return false;
+    struct Trie trie;
+    if (initTrie(&trie) != 0) {
+        perror("Falha ao criar a Trie");
+        return 1;
+    }
+    long long num_words = sizeof(words) / sizeof(words[0]);
+    long long num_search_words = sizeof(search_words) / sizeof(search_words[0]);
+
+    // Palavras sintéticas para medir com dicionários grandes
+    long long *synthetic_offsets = NULL;
+    char *synthetic_words = NULL;
+    if (synthetic > 0) {
+        synthetic_words = generateWords(synthetic, &synthetic_offsets);
+        if (!synthetic_words) {
+            perror("Falha ao gerar as palavras sintéticas");
+            freeTrie(&trie);
+            return 1;
         }
-
-        // Move para o nó filho
-        currentNode = currentNode->children[index];
+        num_words = synthetic;
     }
 
-    // Se chegamos ao final da string e o nó atual está marcado como fim de palavra,
-    // a string foi encontrada.
-    return (currentNode != NULL && currentNode->isEndOfWord);
-}
-
-// Função auxiliar para liberar a memória alocada pela Trie (recursivo)
-void freeTrie(struct TrieNode *node) {
-    if (!node) {
-        return;
+    // Arquivos de palavras: as chaves vão direto do buffer mapeado para insertLen/searchLen
+    TrieInput dict_input = {0}, query_input = {0};
+    TrieTokens dict = {0}, queries = {0};
+    if (dict_path) {
+        if (load_words(dict_path, load_threads, &plan, &dict_input, &dict) != 0) {
+            perror("Falha ao ler o dicionário");
+            freeTrie(&trie);
+            return 1;
+        }
+        num_words = (long long)dict.count;
     }
-
-    int i;
-    for (i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i]) {
-            freeTrie(node->children[i]); // Libera recursivamente os filhos
+    if (query_path) {
+        if (load_words(query_path, load_threads, &plan, &query_input, &queries) != 0) {
+            perror("Falha ao ler as consultas");
+            freeTrie(&trie);
+            return 1;
         }
+        num_search_words = (long long)queries.count;
     }
 
-    free(node); // Libera o nó atual
-}
-
-
-// --- Exemplo de Uso com Medição de Tempo ---
-int main() {
-    // Lista de palavras para inserir
-    char words[][32] = {"the", "a", "there", "answer", "any", "by", "bye", "their",
-                        "theirself", "them", "themselves", "then", "thence", "hence",
-                        "thereafter", "thereby", "therefore", "thereto", "thermos",
-                        "these", "they", "thick", "thin", "thing", "think", "third",
-                        "this", "those", "though", "thought", "thousand", "three",
-                        "thro", "through", "throughout", "throw", "thru", "thus",
-                        "thy", "thyself", "tie", "tight", "till", "time", "tin",
-                        "tip", "tire", "to", "today", "together", "told", "ton",
-                        "tone", "tongue", "tonight", "too", "took", "tool", "top",
-                        "topsy", "turvy", "toss", "tot", "touch", "tough", "tour",
-                        "tow", "toward", "towards", "tower", "town", "toy", "trace",
-                        "track", "trade", "train", "tramp", "transfer", "trap", "trash",
-                        "travel", "traverse", "tray", "tread", "treasure", "treat",
-                        "treaty", "tree", "tremble", "trick", "trim", "trip", "troop",
-                        "trot", "trouble", "trough", "trousers", "trout", "trow", "truce",
-                        "true", "truly", "trump", "trunk", "trust", "truth", "try",
-                        "tub", "tube", "tumble", "tune", "turn", "tutor", "twain",
-                        "tweed", "twelfth", "twelve", "twentieth", "twenty", "twice",
-                        "twig", "twilight", "twin", "twine", "twinkle", "twirl", "twist",
-                        "twit", "two", "tying", "type", "typo", "ugly", "ulcer",
-                        "ultimate", "ultimo", "ultra", "umbrella", "un", "unanimous",
-                        "uncanny", "uncertain", "uncle", "uncommon", "unconscious",
-                        "under", "undergo", "underground", "underneath", "undersigned",
-                        "understand", "undertake", "undertaking", "underwear", "undetermined",
-                        "undoubtedly", "unequal", "uneven", "unexpected", "unfair",
-                        "unfit", "unfold", "unfortunate", "unfortunately", "unfrequented",
-                        "unfriendly", "unfurnished", "ungainly", "unheard", "unholy",
-                        "uniform", "unite", "united", "units", "unity", "universal",
-                        "university", "unkind", "unknown", "unlawful", "unless", "unlike",
-                        "unlikely", "unloading", "unlucky", "unmarried", "unmerciful",
-                        "unmistakable", "unnecessary", "unoccupied", "unpaid", "unparalleled",
-                        "unpleasant", "unprecedented", "unprejudiced", "unprepared",
-                        "unprincipled", "unprotected", "unprovided", "unpublished",
-                        "unpunished", "unqualified", "unquestionable", "unravel",
-                        "unreasonable", "unredeemed", "unregulated", "unreliable",
-                        "unremitting", "unreserved", "unrestrained", "unrestricted",
-                        "unrighteous", "unrivaled", "unroll", "unruffled", "unsatisfactory",
-                        "unseasonable", "unseen", "unselfish", "unsettled", "unshaken",
-                        "unsightly", "unskillful", "unsociable", "unsolicited",
-                        "unsophisticated", "unspeakable", "unstable", "unsteady",
-                        "unsuccessful", "unsuitable", "unsurpassed", "unsuspecting",
-                        "untamed", "untimely", "untiring", "untold", "untouched",
-                        "untoward", "untried", "untrue", "unusual", "unvarnished",
-                        "unveil", "unwarrantable", "unwary", "unwearied", "unwelcome",
-                        "unwell", "unwieldy", "unwilling", "unwind", "unwise",
-                        "unwittingly", "unwomanly", "unwonted", "unworthy", "unwrap",
-                        "unyoke", "up", "upbraid", "upheld", "uphill", "uphold",
-                        "upland", "upon", "upper", "uppermost", "upright", "uprising",
-                        "uproar", "uproot", "upset", "upstairs", "upstream", "upward",
-                        "urban", "urchin", "urge", "urgent", "usage", "use",
-                        "useful", "usefulness", "useless", "usher", "usual", "usurp",
-                        "usury", "utensil", "utility", "utilize", "utmost", "utter",
-                        "utterance", "utterly", "v", "vacancy", "vacant", "vacate",
-                        "vacation", "vague", "vaguely", "vain", "valentine", "valet",
-                        "valiant", "valid", "validity", "valley", "valor", "valuable",
-                        "valuation", "value", "valve", "vampire", "van", "vandal",
-                        "vane", "vang", "vanilla", "vanish", "vanity", "vanquish",
-                        "vantage", "vapid", "vapor", "variable", "variation", "varied",
-                        "variety", "various", "varnish", "vary", "vase", "vassal",
-                        "vast", "vastly", "vat", "vault", "vaunt", "vicious", "victim",
-                        "victor", "victorious", "victory", "victual", "vie", "view",
-                        "vigil", "vigilant", "vigor", "vigorous", "vile", "village",
-                        "villain", "vine", "vinegar", "vineyard", "vintage", "viol",
-                        "violate", "violation", "violence", "violent", "violet", "violin",
-                        "vipers", "virago", "virgin", "virile", "virtual", "virtue",
-                        "virtuoso", "virulent", "visage", "viscous", "visible", "vision",
-                        "visit", "visitor", "visor", "vista", "visual", "vital",
-                        "vitality", "vitals", "vivid", "vividly", "vixen", "vocal",
-                        "vocation", "vociferous", "vogue", "voice", "void", "volatile",
-                        "volcanic", "volcano", "volley", "volt", "volume", "voluminous",
-                        "voluntary", "volunteer", "voluptuous", "vomit", "voodoo",
-                        "voracious", "vortex", "vote", "voter", "vouch", "vowel",
-                        "voyage", "vulg", "vulgar", "vulnerable", "vulture", "w",
-                        "wad", "wade", "wafer", "wag", "wage", "wager", "wagon",
-                        "wail", "waist", "wait", "waiter", "waiting", "wake", "wale",
-                        "walk", "wall", "wallet", "wallop", "wallow", "walnut",
-                        "walrus", "waltz", "wan", "wand", "wander", "wane", "want",
-                        "wanton", "war", "ward", "warden", "wardrobe", "ware", "warfare",
-                        "warm", "warmth", "warn", "warning", "warp", "warrant", "warren",
-                        "wary", "wash", "wasp", "waste", "waster", "watch", "watchful",
-                        "water", "waterfall", "watermelon", "wave", "waver", "wax",
-                        "way", "wayfarer", "wayward", "we", "weak", "weaken", "weakness",
-                        "weal", "wealth", "wealthy", "wean", "weapon", "wear",
-                        "weariness", "weary", "weather", "weave", "weaver", "web",
-                        "wed", "wedding", "wedge", "wedlock", "wee", "weed", "week",
-                        "weekly", "weep", "weigh", "weight", "weighty", "weird",
-                        "welcome", "weld", "welfare", "well", "wellnigh", "welt",
-                        "wench", "wend", "went", "wept", "were", "west", "western",
-                        "wet", "whale", "whaler", "wharf", "what", "whatever",
-                        "whatsoever", "wheat", "wheedle", "wheel", "wheeze", "whelp",
-                        "when", "whence", "whenever", "whensoever", "where", "whereat",
-                        "whereby", "wherefore", "wherein", "whereof", "whereon",
-                        "wheresoever", "whereupon", "wherever", "wherewith", "whet",
-                        "whether", "whetstone", "whew", "whey", "which", "whichever",
-                        "whiff", "while", "whim", "whimper", "whimsical", "whine",
-                        "whining", "whip", "whir", "whirl", "whirlpool", "whirlwind",
-                        "whisk", "whisker", "whiskey", "whisper", "whistle", "white",
-                        "whiten", "whither", "whitish", "whittle", "whiz", "who",
-                        "whoa", "whoever", "whole", "wholehearted", "wholly", "whom",
-                        "whomever", "whoop", "whooping", "whose", "whosoever", "why",
-                        "wicked", "wickedness", "wide", "widely", "widen", "widow",
-                        "widower", "width", "wield", "wife", "wig", "wiggle",
-                        "wild", "wilder", "wilderness", "wildly", "wile", "will",
-                        "willing", "willow", "wily", "win", "wince", "wind",
-                        "windmill", "window", "wine", "wing", "wink", "winner",
-                        "winning", "winter", "wipe", "wire", "wisdom", "wise",
-                        "wish", "wisp", "wistful", "wit", "witch", "witchcraft",
-                        "with", "withdraw", "withdrawal", "withe", "withhold",
-                        "within", "without", "withstand", "witness", "witticism",
-                        "wittingly", "witty", "wives", "woe", "woeful", "wolf",
-                        "woman", "womanly", "womb", "won", "wonder", "wonderful",
-                        "wondrous", "wont", "woo", "wood", "wooden", "woodland",
-                        "woodman", "woody", "wool", "woolen", "word", "wordy",
-                        "wore", "work", "worker", "working", "workman", "world",
-                        "worldly", "worm", "worn", "worry", "worse", "worship",
-                        "worst", "worth", "worthless", "worthy", "would", "wound",
-                        "wove", "woven", "wr", "wrack", "wraith", "wrangle", "wrap",
-                        "wrapped", "wrapper", "wrapping", "wrath", "wreak", "wreath",
-                        "wreathe", "wreck", "wreckage", "wrench", "wrest", "wrestle",
-                        "wretch", "wretched", "wriggle", "wring", "wrinkle", "wrist",
-                        "writ", "write", "writer", "writhe", "writing", "written",
-                        "wrong", "wrongful", "wrongly", "wrote", "wrought", "wrung",
-                        "wry", "y", "yam", "yankee", "yard", "yarn", "yawl",
-                        "yawn", "ye", "yea", "year", "yearly", "yearn", "yeast",
-                        "yell", "yellow", "yelp", "yeoman", "yes", "yest",
-                        "yesterday", "yet", "yield", "yoke", "yolk", "yon",
-                        "yonder", "you", "young", "younger", "youngest", "your",
-                        "yours", "yourself", "yourselves", "youth", "youthful",
-                        "yule", "zany", "zeal", "zealot", "zealous", "zebra",
-                        "zenith", "zephyr", "zinc", "zodiac", "zone", "zonked",
-                        "zoom" // Adicionando mais palavras para ter uma medição mais significativa
-                        };
-
-
-    // Lista de palavras para buscar (algumas presentes, outras não)
-    char search_words[][32] = {"the", "these", "their", "thaw", "any", "by", "bye", "them",
-                               "algorithm", "structure", "data", "performance", "timing",
-                               "zebra", "youth", "quick", "brown", "fox", "jumps",
-                               "over", "the", "lazy", "dogs", "trie", "node",
-                               "children", "alphabet", "size", "insert", "search",
-                               "freememory", "example", "function", "pointer", "malloc",
-                               "calloc", "sizeof", "memcpy", "time", "monotonic",
-                               "nanoseconds", "seconds", "elapsed", "duration", "code",
-                               "programming", "language", "computer", "science", "engineer",
-                               "professor", "student", "learning", "knowledge", "expert"};
-
-
-    struct TrieNode *root = createNode();
-    int num_words = sizeof(words) / sizeof(words[0]);
-    int num_search_words = sizeof(search_words) / sizeof(search_words[0]);
-
     struct timespec start_insert, end_insert;
     struct timespec start_search, end_search;
     double elapsed_insert, elapsed_search;
 
     // --- Medição do tempo de inserção ---
-    printf("Iniciando inserção de %d palavras na Trie...\n", num_words);
+    printf("Iniciando inserção de %lld palavras na Trie...\n", num_words);
     clock_gettime(CLOCK_MONOTONIC, &start_insert);
 
-    for (int i = 0; i < num_words; i++) {
-        insert(root, words[i]);
+    for (long long i = 0; i < num_words; i++) {
+        if (i % TRACE_BATCH == 0) {
+            trace_begin(&span);
+        }
+        if (dict.tokens) {
+            // Linhas "palavra contagem" somam a contagem à frequência da palavra
+            uint32_t count = trie_token_count(&dict.tokens[i]);
+            insertLenCount(&trie, dict.tokens[i].key, dict.tokens[i].len, count);
+        } else {
+            insert(&trie, synthetic_words ? synthetic_words + synthetic_offsets[i] : words[i]);
+        }
         // printf("Inserido: \"%s\"\n", words[i]); // Descomente para ver as palavras sendo inseridas
+        if (i % TRACE_BATCH == TRACE_BATCH - 1 || i == num_words - 1) {
+            trace_end(&span, "insert");
+        }
     }
 
     clock_gettime(CLOCK_MONOTONIC, &end_insert);
@@ -280,20 +187,36 @@ int main() {
                      (end_insert.tv_nsec - start_insert.tv_nsec) / 1e9;
 
     printf("Tempo de Inserção: %.9f segundos\n", elapsed_insert);
+    printf("Vazão de inserção: %.0f palavras/s\n", num_words / elapsed_insert);
+    printf("Nós: %u de %zu bytes; %.1f bytes/palavra ocupados, %.1f bytes/palavra mapeados\n",
+           trie_arena_count(&trie.arena), sizeof(struct TrieNode),
+           (double)trie_arena_used_bytes(&trie.arena) / num_words,
+           (double)trie_arena_mapped_bytes(&trie.arena) / num_words);
     printf("\n");
 
     // --- Medição do tempo de busca ---
-    printf("Iniciando busca por %d palavras na Trie...\n", num_search_words);
+    printf("Iniciando busca por %lld palavras na Trie...\n", num_search_words);
     clock_gettime(CLOCK_MONOTONIC, &start_search);
 
-    for (int i = 0; i < num_search_words; i++) {
-        search(root, search_words[i]);
+    long long found = 0;
+    for (long long i = 0; i < num_search_words; i++) {
+        if (i % TRACE_BATCH == 0) {
+            trace_begin(&span);
+        }
+        if (queries.tokens) {
+            found += searchLen(&trie, queries.tokens[i].key, queries.tokens[i].len);
+        } else {
+            found += search(&trie, search_words[i]);
+        }
         // Descomente as linhas abaixo se quiser ver os resultados individuais da busca
-        // if (search(root, search_words[i])) {
+        // if (search(&trie, search_words[i])) {
         //     printf("Busca por \"%s\": ENCONTRADO\n", search_words[i]);
         // } else {
         //     printf("Busca por \"%s\": NAO ENCONTRADO\n", search_words[i]);
         // }
+        if (i % TRACE_BATCH == TRACE_BATCH - 1 || i == num_search_words - 1) {
+            trace_end(&span, "search");
+        }
     }
 
     clock_gettime(CLOCK_MONOTONIC, &end_search);
@@ -304,13 +227,55 @@ int main() {
                      (end_search.tv_nsec - start_search.tv_nsec) / 1e9;
 
     printf("Tempo de Busca: %.9f segundos\n", elapsed_search);
+    printf("Encontradas: %lld de %lld palavras\n", found, num_search_words);
     printf("\n");
 
+    // --- Busca em lote, com as consultas intercaladas e prefetch do próximo nó ---
+    const char **batch_keys = malloc((num_search_words + 1) * sizeof(char *));
+    size_t *batch_lens = malloc((num_search_words + 1) * sizeof(size_t));
+    uint64_t *batch_found = malloc(((num_search_words + 63) / 64 + 1) * sizeof(uint64_t));
+    if (!batch_keys || !batch_lens || !batch_found) {
+        perror("Erro de alocação");
+        return 1;
+    }
+    for (long long i = 0; i < num_search_words; i++) {
+        batch_keys[i] = queries.tokens ? queries.tokens[i].key : search_words[i];
+        batch_lens[i] = queries.tokens ? queries.tokens[i].len : strlen(search_words[i]);
+    }
+    printf("Iniciando busca em lote (janela de %d consultas)...\n", TRIE_BATCH_WINDOW);
+    clock_gettime(CLOCK_MONOTONIC, &start_search);
+    for (long long i = 0; i < num_search_words; i += TRACE_BATCH) {
+        size_t n = num_search_words - i < TRACE_BATCH ? (size_t)(num_search_words - i) : TRACE_BATCH;
+        // batch_found recebe bits a partir de um múltiplo de 64 (TRACE_BATCH é múltiplo de 64)
+        trace_begin(&span);
+        searchBatch(&trie, batch_keys + i, batch_lens + i, n, batch_found + i / 64);
+        trace_end(&span, "searchBatch");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_search);
+    double elapsed_batch = (end_search.tv_sec - start_search.tv_sec) +
+                           (end_search.tv_nsec - start_search.tv_nsec) / 1e9;
+
+    // Cada bit deve bater com a busca individual
+    long long batch_hits = 0, batch_mismatches = 0;
+    for (long long i = 0; i < num_search_words; i++) {
+        bool hit = (batch_found[i / 64] >> (i % 64)) & 1;
+        batch_hits += hit;
+        batch_mismatches += hit != searchLen(&trie, batch_keys[i], batch_lens[i]);
+    }
+    printf("Tempo de Busca em lote: %.9f segundos (%.2fx a busca individual)\n",
+           elapsed_batch, elapsed_search / elapsed_batch);
+    printf("Encontradas: %lld de %lld palavras; %lld divergências com a busca individual\n",
+           batch_hits, num_search_words, batch_mismatches);
+    printf("\n");
+    free(batch_keys);
+    free(batch_lens);
+    free(batch_found);
+
 
     // --- Exemplo de prefixo (que não é palavra) ---
     // Não incluímos na medição de tempo principal para manter o foco nas operações em massa
     printf("Buscando prefixo \"ther\" (exemplo isolado):\n");
-    if (search(root, "ther")) {
+    if (search(&trie, "ther")) {
          printf("Busca por \"ther\": ENCONTRADO (mas \"ther\" é um prefixo, não palavra completa neste exemplo)\n");
     } else {
          printf("Busca por \"ther\": NAO ENCONTRADO (correto, pois \"ther\" não foi inserida como palavra completa)\n");
@@ -318,11 +283,115 @@ int main() {
     printf("\n");
 
 
+    // --- Autocompletar: top-k por frequência, podando pelos agregados ---
+    if (num_prefixes == 0) {
+        num_prefixes = sizeof(default_prefixes) / sizeof(default_prefixes[0]);
+        memcpy(prefixes, default_prefixes, sizeof(default_prefixes));
+    }
+    struct TrieCompletion *completions = malloc((size_t)top_k * sizeof(struct TrieCompletion));
+    if (!completions) {
+        perror("Erro de alocação");
+        return 1;
+    }
+    printf("Autocompletar (top-%d por frequência):\n", top_k);
+    for (int p = 0; p < num_prefixes; p++) {
+        struct timespec start_complete, end_complete;
+        clock_gettime(CLOCK_MONOTONIC, &start_complete);
+        int n = topKCompletions(&trie, prefixes[p], strlen(prefixes[p]), top_k, completions);
+        clock_gettime(CLOCK_MONOTONIC, &end_complete);
+        if (n < 0) {
+            perror("Falha no autocompletar");
+            return 1;
+        }
+        printf("Prefixo \"%s\": %u palavras, %d respostas em %.3f µs:", prefixes[p],
+               countPrefix(&trie, prefixes[p], strlen(prefixes[p])), n,
+               ((end_complete.tv_sec - start_complete.tv_sec) * 1e9 +
+                (end_complete.tv_nsec - start_complete.tv_nsec)) / 1e3);
+        for (int i = 0; i < n; i++) {
+            printf(" %s (%u)", completions[i].word, completions[i].frequency);
+        }
+        printf("\n");
+        freeCompletions(completions, n);
+    }
+
+    // Frequências iguais (-u): só a ordem de desempate guia a busca, e a latência
+    // não deve depender do tamanho da subárvore do prefixo
+    int out_of_order = 0;
+    long long *uniform_offsets = NULL;
+    char *uniform_words = NULL;
+    struct Trie uniform = {0};
+    if (uniform_count > 0) {
+        uniform_words = generateWords(uniform_count, &uniform_offsets);
+        if (!uniform_words || initTrie(&uniform) != 0) {
+            perror("Falha ao criar a Trie de frequências iguais");
+            return 1;
+        }
+        for (long long i = 0; i < uniform_count; i++) {
+            const char *word = uniform_words + uniform_offsets[i];
+            if (!search(&uniform, word)) {
+                insert(&uniform, word);
+            }
+        }
+        printf("Autocompletar com frequências iguais (%u palavras distintas):\n", countPrefix(&uniform, "", 0));
+    }
+    const char *uniform_prefixes[] = {"", "a", "ab", "abc"};
+    for (size_t p = 0; uniform_count > 0 && p < sizeof(uniform_prefixes) / sizeof(uniform_prefixes[0]); p++) {
+        size_t len = strlen(uniform_prefixes[p]);
+        struct timespec start_complete, end_complete;
+        clock_gettime(CLOCK_MONOTONIC, &start_complete);
+        int n = topKCompletions(&uniform, uniform_prefixes[p], len, top_k, completions);
+        clock_gettime(CLOCK_MONOTONIC, &end_complete);
+        if (n < 0) {
+            perror("Falha no autocompletar");
+            return 1;
+        }
+        // Empates saem em ordem alfabética
+        bool sorted = true;
+        for (int i = 1; i < n; i++) {
+            sorted = sorted && strcmp(completions[i - 1].word, completions[i].word) < 0;
+        }
+        printf("Prefixo \"%s\": %u palavras, %d respostas em %.3f µs (%s)\n", uniform_prefixes[p],
+               countPrefix(&uniform, uniform_prefixes[p], len), n,
+               ((end_complete.tv_sec - start_complete.tv_sec) * 1e9 +
+                (end_complete.tv_nsec - start_complete.tv_nsec)) / 1e3,
+               sorted ? "ordem alfabética" : "FORA DE ORDEM");
+        out_of_order += !sorted;
+        freeCompletions(completions, n);
+    }
+    freeTrie(&uniform);
+    free(uniform_words);
+    free(uniform_offsets);
+    free(completions);
+    printf("\n");
+
     // --- Liberar memória ---
+    struct timespec start_free, end_free;
     printf("Liberando memória da Trie...\n");
-    freeTrie(root);
-    printf("Memória liberada.\n");
-
+    clock_gettime(CLOCK_MONOTONIC, &start_free);
+    freeTrie(&trie);
+    clock_gettime(CLOCK_MONOTONIC, &end_free);
+    printf("Memória liberada em %.9f segundos.\n",
+           (end_free.tv_sec - start_free.tv_sec) + (end_free.tv_nsec - start_free.tv_nsec) / 1e9);
+    free(synthetic_words);
+    free(synthetic_offsets);
+    trie_tokens_free(&dict);
+    trie_tokens_free(&queries);
+    trie_input_close(&dict_input);
+    trie_input_close(&query_input);
+
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
+
+    if (trace_path && trace_enabled()) {
+        printf("\nTrace:\n");
+        trace_print_summary(stdout);
+        if (trace_write(trace_path) != 0) {
+            perror("Falha ao gravar o trace");
+        } else {
+            printf("Trace gravado em %s\n", trace_path);
+        }
+    }
+    trace_shutdown();
 
-    return 0;
+    return out_of_order ? 1 : 0;
 }
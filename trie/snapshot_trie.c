@@ -0,0 +1,164 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/affinity.h"
+#include "trie.h"
+#include "trie_snapshot.h"
+#include "palavras.h"
+
+static double elapsed(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    AffinityPolicy policy = AFFINITY_NONE;
+    long long synthetic = 0;    // -n: insere N palavras sintéticas em vez da lista fixa
+    bool load_only = false;     // -l: só abre um retrato existente, como um serviço ao iniciar
+    int opt;
+    while ((opt = getopt(argc, argv, "a:n:l")) != -1) {
+        if (opt == 'a' && affinity_parse_policy(optarg, &policy) == 0) {
+            continue;
+        }
+        if (opt == 'n' && (synthetic = atoll(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 'l') {
+            load_only = true;
+            continue;
+        }
+        optind = argc + 1;
+        break;
+    }
+    if (argc - optind != 1) {
+        fprintf(stderr, "Uso: %s [-a none|compact|scatter|physical] [-n palavras sintéticas] [-l] <arquivo do retrato>\n",
+                argv[0]);
+        return 1;
+    }
+    const char *path = argv[optind];
+
+    // Daqui em diante todo erro sai por `out`, que libera o que já foi alocado
+    int status = 1;
+    AffinityTopology topo = {0};
+    AffinityPlan plan = {0};
+    long long *synthetic_offsets = NULL;
+    char *synthetic_words = NULL;
+    struct Trie trie = {0};
+
+    if (affinity_read_topology(&topo) != 0 || affinity_plan(&topo, policy, 1, &plan) != 0
+        || affinity_pin_self(&plan, 0) != 0) {
+        perror("Falha ao aplicar a afinidade");
+        goto out;
+    }
+    affinity_print(stdout, &topo, &plan);
+
+    long long num_words = sizeof(words) / sizeof(words[0]);
+    int num_search_words = sizeof(search_words) / sizeof(search_words[0]);
+    if (synthetic > 0) {
+        synthetic_words = generateWords(synthetic, &synthetic_offsets);
+        if (!synthetic_words) {
+            perror("Falha ao gerar as palavras sintéticas");
+            goto out;
+        }
+        num_words = synthetic;
+    }
+#define WORD(i) (synthetic_words ? synthetic_words + synthetic_offsets[i] : words[i])
+
+    struct timespec t0, t1;
+    int mismatches = 0;
+
+    if (!load_only) {
+        // --- Construção como hoje: um insert por palavra ---
+        printf("Construindo a Trie com %lld palavras...\n", num_words);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        if (initTrie(&trie) != 0) {
+            perror("Falha ao criar a Trie");
+            goto out;
+        }
+        for (long long i = 0; i < num_words; i++) {
+            insert(&trie, WORD(i));
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("Tempo de construção: %.9f segundos\n", elapsed(&t0, &t1));
+
+        // --- Congelamento e gravação ---
+        TrieSnapshot frozen;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        if (trie_snapshot_freeze(&trie, &frozen) != 0) {
+            perror("Falha ao congelar a Trie");
+            goto out;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("Tempo de congelamento: %.9f segundos\n", elapsed(&t0, &t1));
+        printf("Double-array: %u células para %u estados (%.1f%% ocupadas); %.1f bytes/palavra "
+               "contra %.1f na arena\n", frozen.header->num_cells, frozen.header->num_states,
+               100.0 * frozen.header->num_states / frozen.header->num_cells,
+               (double)frozen.length / num_words, (double)trie_arena_used_bytes(&trie.arena) / num_words);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        int ret = trie_snapshot_save(&frozen, path);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        trie_snapshot_close(&frozen);
+        if (ret != 0) {
+            perror("Falha ao gravar o retrato");
+            goto out;
+        }
+        printf("Retrato gravado em %s em %.9f segundos\n\n", path, elapsed(&t0, &t1));
+    }
+
+    // --- Abertura: mmap e conferência do cabeçalho, sem parse nem alocação ---
+    TrieSnapshot snap;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (trie_snapshot_open(&snap, path) != 0) {
+        perror("Falha ao abrir o retrato");
+        goto out;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("Retrato aberto em %.6f ms (%zu bytes, %llu palavras)\n", elapsed(&t0, &t1) * 1e3,
+           snap.length, (unsigned long long)snap.header->num_words);
+
+    // Primeira busca logo depois de abrir, incluindo as faltas de página
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    bool first_found = trie_snapshot_search(&snap, search_words[0]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("Primeira busca (\"%s\": %s) em %.6f ms\n", search_words[0],
+           first_found ? "ENCONTRADO" : "NAO ENCONTRADO", elapsed(&t0, &t1) * 1e3);
+
+    // --- Busca de todas as palavras no retrato ---
+    long long found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long long i = 0; i < num_words; i++) {
+        found += trie_snapshot_search(&snap, WORD(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed_search = elapsed(&t0, &t1);
+    printf("Busca das palavras: %lld de %lld encontradas em %.9f segundos (%.0f buscas/s)\n",
+           found, num_words, elapsed_search, num_words / elapsed_search);
+    mismatches += found != num_words;
+
+    // Com a Trie construída aqui, o retrato deve responder igual a ela
+    if (!load_only) {
+        for (int i = 0; i < num_search_words; i++) {
+            mismatches += trie_snapshot_search(&snap, search_words[i]) != search(&trie, search_words[i]);
+        }
+        mismatches += trie_snapshot_search(&snap, "ther") != search(&trie, "ther");
+        mismatches += snap.header->num_states != trie_arena_count(&trie.arena);
+        printf("Verificação contra a Trie: %s (%d divergências)\n", mismatches ? "FALHOU" : "ok", mismatches);
+    }
+
+    trie_snapshot_close(&snap);
+    status = mismatches ? 1 : 0;
+
+out:
+    freeTrie(&trie);
+    free(synthetic_words);
+    free(synthetic_offsets);
+    affinity_plan_free(&plan);
+    affinity_free_topology(&topo);
+    return status;
+}
@@ -0,0 +1,553 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "concurrent_trie.h"
+#include "palavras.h"
+
+// Teste de estresse da Trie concorrente com remoção e poda.
+//
+// As classes de chave se misturam dentro das mesmas subárvores: a primeira
+// letra só separa as chaves nunca inseridas, e a segunda decide o resto. Assim
+// "fa...", "fh..." e "fs..." passam pelo mesmo nó 'f', e os leitores de uma
+// classe atravessam nós que outra está congelando, desligando e reusando.
+//   'a'...       nunca é inserida (os leitores nunca podem encontrá-la)
+//   ?a..?f...    estáveis: inseridas no início e nunca removidas
+//   ?g..?p...    dos escritores (o dono de cada chave é sorteado pelo índice,
+//                então as remoções de um escritor podam nós do caminho dos outros)
+//   ?q..?z...    do podador, que completa, remove e poda por prefixo de 2 ou 3 letras
+//
+// Em cada poda, o podador completa o prefixo e remove metade das suas chaves;
+// a thread de corrida reinsere essas chaves, metade antes do corte e o resto
+// enquanto ele acontece. Cada uma tem de ser contada pelo corte ou sobreviver
+// a ele, nunca as duas coisas nem nenhuma (a inserção que pega um nó congelado
+// recomeça da raiz). O número de palavras cortadas mais o de sobreviventes tem
+// de bater com as presentes antes mais as inseridas, e uma execução com
+// bastantes podas em que a corrida nunca se intercalou ao corte falha.
+//
+// Cada chave dos escritores tem uma versão, ímpar enquanto uma operação
+// sobre ela está em andamento; as do podador usam uma versão só, ímpar
+// durante toda a rodada de reinserção, corrida e poda. O leitor lê a versão,
+// a verdade, busca e lê a versão de novo: se ela não mudou e é par, a busca
+// tem de bater com a verdade. Um nó reusado antes do fim do período de graça
+// leva a busca para outro caminho e aparece aqui como divergência. No fim,
+// com tudo parado, toda chave é conferida e os nós alcançáveis a partir da
+// raiz devem bater com o contador da Trie. Compile também com
+// -fsanitize=address (uso depois da recuperação) e -fsanitize=thread.
+
+#define DEFAULT_READERS 2
+#define DEFAULT_WRITERS 2
+#define DEFAULT_SECONDS 2
+#define DEFAULT_KEYS 100000
+
+// Podas a partir das quais a execução tem de ter visto a corrida intercalada ao corte
+#define MIN_PRUNES_FOR_OVERLAP 100
+
+#define NEVER_FIRST 'a'
+#define STABLE_LAST 'f'
+#define WRITER_LAST 'p'
+
+// Classes de chave (a dos escritores é o próprio número do escritor)
+#define OWNER_NEVER (-1)
+#define OWNER_STABLE (-2)
+#define OWNER_PRUNER (-3)
+
+// Rodada de corrida entre o podador e a thread de corrida. Cada rodada nova
+// (número ímpar em round) pede que o lote seja inserido; half recebe o número
+// da rodada com a primeira metade inserida, done ao terminar, e finished diz
+// que o podador não abre outras.
+typedef struct {
+    atomic_uint round;
+    atomic_uint half;
+    atomic_uint done;
+    atomic_int finished;
+    const long long *batch;
+    long long batch_len;
+} RaceState;
+
+typedef struct {
+    ConcurrentTrie *trie;
+    const char *const *keys;
+    long long num_keys;
+    atomic_uchar *present;          // Verdade de cada chave, escrita só por quem a altera
+    atomic_uint *version;           // Versão de cada chave dos escritores
+    atomic_uint *prune_version;     // Versão de todas as chaves do podador
+    RaceState *race;
+    atomic_int *stop;
+    int id;
+    int num_writers;
+    uint64_t seed;
+    long long ops;
+    long long checked;              // Buscas conferidas pelos leitores (versão estável)
+    long long overlaps;             // Podas em que a corrida teve chaves cortadas e sobreviventes
+    long long errors;
+} StressArgs;
+
+static uint64_t next_random(uint64_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+    return *x;
+}
+
+static int cmp_key(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+// Classe da chave de índice k, ou o escritor dono dela
+static int owner(const char *key, long long k, int num_writers) {
+    if (key[0] == NEVER_FIRST) {
+        return OWNER_NEVER;
+    }
+    if (key[1] <= STABLE_LAST) {
+        return OWNER_STABLE;
+    }
+    if (key[1] <= WRITER_LAST) {
+        return (int)(k % num_writers);
+    }
+    return OWNER_PRUNER;
+}
+
+// Índices das chaves da classe who
+static long long *keys_of(const StressArgs *args, int who, long long *count) {
+    long long *mine = malloc((size_t)args->num_keys * sizeof(long long));
+    *count = 0;
+    if (!mine) {
+        return NULL;
+    }
+    for (long long k = 0; k < args->num_keys; k++) {
+        if (owner(args->keys[k], k, args->num_writers) == who) {
+            mine[(*count)++] = k;
+        }
+    }
+    return mine;
+}
+
+static void *reader_thread(void *arg) {
+    StressArgs *args = arg;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->errors = 1;
+        return NULL;
+    }
+    while (!atomic_load_explicit(args->stop, memory_order_relaxed)) {
+        for (int i = 0; i < 1024; i++) {
+            long long k = (long long)(next_random(&args->seed) % (uint64_t)args->num_keys);
+            const char *key = args->keys[k];
+            int who = owner(key, k, args->num_writers);
+            atomic_uint *version = who == OWNER_PRUNER ? args->prune_version
+                                 : who >= 0 ? &args->version[k] : NULL;
+
+            unsigned before = version ? atomic_load_explicit(version, memory_order_acquire) : 0;
+            // Acquire: se a verdade lida já é de uma operação posterior a before, after a enxerga
+            bool expected = atomic_load_explicit(&args->present[k], memory_order_acquire);
+            bool found = concurrent_trie_search(args->trie, &cursor, key);
+            unsigned after = version ? atomic_load_explicit(version, memory_order_acquire) : 0;
+            if (before == after && before % 2 == 0) {
+                args->errors += found != expected;
+                args->checked++;
+            }
+        }
+        args->ops += 1024;
+    }
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+static void *writer_thread(void *arg) {
+    StressArgs *args = arg;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->errors = 1;
+        return NULL;
+    }
+    long long num_mine;
+    long long *mine = keys_of(args, args->id, &num_mine);
+    if (!mine) {
+        args->errors = 1;
+        concurrent_trie_cursor_release(args->trie, &cursor);
+        return NULL;
+    }
+
+    while (num_mine > 0 && !atomic_load_explicit(args->stop, memory_order_relaxed)) {
+        long long k = mine[next_random(&args->seed) % (uint64_t)num_mine];
+        const char *key = args->keys[k];
+        bool present = atomic_load_explicit(&args->present[k], memory_order_relaxed);
+        atomic_fetch_add(&args->version[k], 1);
+        if (present) {
+            args->errors += concurrent_trie_delete(args->trie, key) != 1;
+        } else if (concurrent_trie_insert(args->trie, &cursor, key) != 0) {
+            args->errors++;
+            break;
+        }
+        atomic_store_explicit(&args->present[k], !present, memory_order_release);
+        atomic_fetch_add_explicit(&args->version[k], 1, memory_order_release);
+        args->errors += concurrent_trie_search(args->trie, &cursor, key) == present;
+        args->ops++;
+    }
+    free(mine);
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+// Insere o lote de cada rodada ímpar publicada pelo podador
+static void *racer_thread(void *arg) {
+    StressArgs *args = arg;
+    RaceState *race = args->race;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->errors = 1;
+        return NULL;
+    }
+    unsigned last = 0;
+    for (;;) {
+        unsigned round = atomic_load_explicit(&race->round, memory_order_acquire);
+        if (round == last) {
+            if (atomic_load_explicit(&race->finished, memory_order_acquire)
+                && atomic_load_explicit(&race->round, memory_order_acquire) == last) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        // A primeira metade entra antes do corte; o resto, com o corte já liberado
+        for (long long i = 0; i < race->batch_len; i++) {
+            if (i == race->batch_len / 2) {
+                atomic_store_explicit(&race->half, round, memory_order_release);
+                sched_yield();
+            }
+            if (concurrent_trie_insert(args->trie, &cursor, args->keys[race->batch[i]]) != 0) {
+                args->errors++;
+            }
+        }
+        atomic_store_explicit(&race->half, round, memory_order_release);
+        args->ops += race->batch_len;
+        last = round;
+        atomic_store_explicit(&race->done, round, memory_order_release);
+    }
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+// Cada rodada sorteia um prefixo de 2 ou 3 letras de uma das suas chaves,
+// insere as chaves ausentes dele, remove metade delas e poda o prefixo enquanto
+// a thread de corrida reinsere as removidas. O corte e as sobreviventes têm de
+// fechar a conta.
+static void *pruner_thread(void *arg) {
+    StressArgs *args = arg;
+    RaceState *race = args->race;
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(args->trie, &cursor) != 0) {
+        args->errors = 1;
+        return NULL;
+    }
+    long long num_mine;
+    long long *mine = keys_of(args, OWNER_PRUNER, &num_mine);
+    long long *batch = malloc(((size_t)num_mine + 1) * sizeof(long long));
+    if (!mine || !batch) {
+        args->errors = 1;
+        goto out;
+    }
+
+    unsigned round = 1;
+    while (num_mine > 0 && !atomic_load_explicit(args->stop, memory_order_relaxed)) {
+        atomic_fetch_add(args->prune_version, 1);
+        char prefix[4] = {0};
+        const char *sample = args->keys[mine[next_random(&args->seed) % (uint64_t)num_mine]];
+        size_t len = 2 + next_random(&args->seed) % 2;
+        strncpy(prefix, sample, len);
+        len = strlen(prefix);
+
+        // Completa o prefixo e remove metade das chaves dele: as removidas são o lote
+        // da corrida, independentemente do que as rodadas anteriores deixaram
+        long long before = 0, num_batch = 0;
+        for (long long i = 0; i < num_mine; i++) {
+            long long k = mine[i];
+            if (strncmp(args->keys[k], prefix, len) != 0) {
+                continue;
+            }
+            if (!atomic_load_explicit(&args->present[k], memory_order_relaxed)) {
+                if (concurrent_trie_insert(args->trie, &cursor, args->keys[k]) != 0) {
+                    args->errors++;
+                    goto out;
+                }
+                atomic_store_explicit(&args->present[k], 1, memory_order_release);
+            }
+            if (next_random(&args->seed) % 2) {
+                args->errors += concurrent_trie_delete(args->trie, args->keys[k]) != 1;
+                atomic_store_explicit(&args->present[k], 0, memory_order_release);
+                batch[num_batch++] = k;
+            } else {
+                before++;
+            }
+        }
+        race->batch = batch;
+        race->batch_len = num_batch;
+        atomic_store_explicit(&race->round, round, memory_order_release);
+        while (atomic_load_explicit(&race->half, memory_order_acquire) != round) {
+            sched_yield();
+        }
+        long long cut = concurrent_trie_prune_prefix(args->trie, prefix);
+        while (atomic_load_explicit(&race->done, memory_order_acquire) != round) {
+            sched_yield();
+        }
+        round += 2;
+
+        // Cada chave do prefixo foi cortada ou sobreviveu; as de fora não mudam
+        long long survivors = 0;
+        for (long long i = 0; i < num_mine; i++) {
+            long long k = mine[i];
+            bool found = concurrent_trie_search(args->trie, &cursor, args->keys[k]);
+            if (strncmp(args->keys[k], prefix, len) == 0) {
+                survivors += found;
+                atomic_store_explicit(&args->present[k], found, memory_order_release);
+            } else {
+                args->errors += found != atomic_load_explicit(&args->present[k], memory_order_relaxed);
+            }
+        }
+        args->errors += cut < 0 || cut < before + num_batch / 2 || cut + survivors != before + num_batch;
+        args->overlaps += cut > before && survivors > 0;
+        atomic_fetch_add_explicit(args->prune_version, 1, memory_order_release);
+        args->ops++;
+        sched_yield();          // Uma janela com a versão par para os leitores conferirem
+    }
+out:
+    atomic_store_explicit(&race->finished, 1, memory_order_release);
+    free(batch);
+    free(mine);
+    concurrent_trie_cursor_release(args->trie, &cursor);
+    return NULL;
+}
+
+// Regressão: um cursor devolve nós recuperados depois que a lista de onde
+// eles saíram foi reenchida até a capacidade. Retorna o número de divergências.
+static long long recycled_refill_check(void) {
+    char long_key[1025], short_key[65];
+    memset(long_key, 'c', sizeof(long_key) - 1);
+    long_key[sizeof(long_key) - 1] = '\0';
+    memset(short_key, 'd', sizeof(short_key) - 1);
+    short_key[sizeof(short_key) - 1] = '\0';
+
+    ConcurrentTrie trie;
+    ConcurrentTrieCursor a, b;
+    if (concurrent_trie_init(&trie) != 0) {
+        return 1;
+    }
+    long long errors = 0;
+    if (concurrent_trie_cursor_init(&trie, &a) != 0) {
+        concurrent_trie_destroy(&trie);
+        return 1;
+    }
+    errors += concurrent_trie_insert(&trie, &a, long_key) != 0;
+    errors += concurrent_trie_insert(&trie, &a, short_key) != 0;
+    concurrent_trie_cursor_release(&trie, &a);
+
+    // A lista fica cheia com os nós da chave longa
+    errors += concurrent_trie_delete(&trie, long_key) != 1;
+    concurrent_trie_synchronize(&trie);
+
+    // b pega um lote da lista, que é reenchida até a capacidade enquanto b o segura
+    if (concurrent_trie_cursor_init(&trie, &b) != 0) {
+        concurrent_trie_destroy(&trie);
+        return errors + 1;
+    }
+    errors += concurrent_trie_insert(&trie, &b, "b") != 0;
+    errors += concurrent_trie_delete(&trie, short_key) != 1;
+    concurrent_trie_synchronize(&trie);
+    concurrent_trie_cursor_release(&trie, &b);
+
+    if (concurrent_trie_cursor_init(&trie, &a) != 0) {
+        concurrent_trie_destroy(&trie);
+        return errors + 1;
+    }
+    errors += !concurrent_trie_search(&trie, &a, "b");
+    errors += concurrent_trie_search(&trie, &a, long_key) || concurrent_trie_search(&trie, &a, short_key);
+    concurrent_trie_cursor_release(&trie, &a);
+    errors += concurrent_trie_count(&trie) != 2;
+    concurrent_trie_destroy(&trie);
+    return errors;
+}
+
+// Nós alcançáveis a partir de ref; conta também bits de congelamento esquecidos
+static long long count_reachable(const ConcurrentTrie *trie, uint32_t ref, long long *frozen) {
+    const ConcurrentTrieNode *node = concurrent_trie_node(trie, ref);
+    long long count = 1;
+    *frozen += (atomic_load(&node->state) & CONCURRENT_TRIE_FROZEN) != 0;
+    for (int c = 0; c < CONCURRENT_TRIE_ALPHABET; c++) {
+        uint32_t child = atomic_load(&node->children[c]);
+        *frozen += (child & CONCURRENT_TRIE_FROZEN) != 0;
+        child &= ~CONCURRENT_TRIE_FROZEN;
+        if (child) {
+            count += count_reachable(trie, child, frozen);
+        }
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    int num_readers = DEFAULT_READERS;
+    int num_writers = DEFAULT_WRITERS;
+    int seconds = DEFAULT_SECONDS;
+    long long num_generated = DEFAULT_KEYS;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:w:s:n:")) != -1) {
+        if (opt == 'r' && (num_readers = atoi(optarg)) >= 0) {
+            continue;
+        }
+        if (opt == 'w' && (num_writers = atoi(optarg)) > 0) {
+            continue;
+        }
+        if (opt == 's' && (seconds = atoi(optarg)) >= 0) {
+            continue;
+        }
+        if (opt == 'n' && (num_generated = atoll(optarg)) > 0) {
+            continue;
+        }
+        optind = argc + 1;
+        break;
+    }
+    if (optind != argc) {
+        fprintf(stderr, "Uso: %s [-r leitores] [-w escritores] [-s segundos] [-n chaves]\n", argv[0]);
+        return 1;
+    }
+
+    // Chaves sintéticas sem repetição, para a verdade de cada uma ser única
+    long long *offsets = NULL;
+    char *buf = generateWords(num_generated, &offsets);
+    const char **keys = malloc((size_t)num_generated * sizeof(char *));
+    atomic_uchar *present = calloc((size_t)num_generated, sizeof(atomic_uchar));
+    atomic_uint *version = calloc((size_t)num_generated, sizeof(atomic_uint));
+    if (!buf || !keys || !present || !version) {
+        perror("Falha ao gerar as chaves");
+        return 1;
+    }
+    for (long long i = 0; i < num_generated; i++) {
+        keys[i] = buf + offsets[i];
+    }
+    qsort(keys, (size_t)num_generated, sizeof(char *), cmp_key);
+    long long num_keys = 0;
+    for (long long i = 0; i < num_generated; i++) {
+        if (num_keys == 0 || strcmp(keys[num_keys - 1], keys[i]) != 0) {
+            keys[num_keys++] = keys[i];
+        }
+    }
+
+    long long refill_errors = recycled_refill_check();
+    printf("Devolução de nós recuperados com a lista reenchida: %s\n", refill_errors ? "FALHOU" : "ok");
+
+    ConcurrentTrie trie;
+    if (concurrent_trie_init(&trie) != 0) {
+        perror("Falha ao criar a Trie");
+        return 1;
+    }
+    ConcurrentTrieCursor cursor;
+    if (concurrent_trie_cursor_init(&trie, &cursor) != 0) {
+        perror("Falha ao registrar a thread principal");
+        return 1;
+    }
+    for (long long k = 0; k < num_keys; k++) {
+        if (owner(keys[k], k, num_writers) == OWNER_STABLE) {
+            if (concurrent_trie_insert(&trie, &cursor, keys[k]) != 0) {
+                perror("Falha ao inserir");
+                return 1;
+            }
+            present[k] = 1;
+        }
+    }
+    concurrent_trie_cursor_release(&trie, &cursor);
+
+    printf("Estresse: %lld chaves distintas, %d leitores, %d escritores, 1 podador com 1 thread de corrida, "
+           "%d s\n", num_keys, num_readers, num_writers, seconds);
+
+    // Escritores, podador, thread de corrida e leitores, nessa ordem
+    int racer = num_writers + 1;
+    int num_threads = racer + 1 + num_readers;
+    pthread_t *handles = malloc((size_t)num_threads * sizeof(pthread_t));
+    StressArgs *args = calloc((size_t)num_threads, sizeof(StressArgs));
+    if (!handles || !args) {
+        perror("Falha ao alocar as threads");
+        return 1;
+    }
+    atomic_int stop = 0;
+    atomic_uint prune_version = 0;
+    RaceState race = {0};
+    int created = 0;
+    for (; created < num_threads; created++) {
+        void *(*fn)(void *) = created < num_writers ? writer_thread
+                            : created == num_writers ? pruner_thread
+                            : created == racer ? racer_thread : reader_thread;
+        args[created] = (StressArgs){&trie, keys, num_keys, present, version, &prune_version, &race, &stop,
+                                     created, num_writers, 0x9E3779B97F4A7C15ULL * (uint64_t)(created + 1),
+                                     0, 0, 0, 0};
+        if (pthread_create(&handles[created], NULL, fn, &args[created]) != 0) {
+            perror("Falha ao criar a thread");
+            break;
+        }
+    }
+    if (created <= num_writers) {
+        atomic_store(&race.finished, 1);    // Sem podador, a thread de corrida não espera por ele
+    }
+    sleep((unsigned)seconds);
+    atomic_store(&stop, 1);
+
+    long long errors = refill_errors + (created != num_threads);
+    long long writes = 0, prunes = 0, raced = 0, searches = 0, checked = 0;
+    for (int t = 0; t < created; t++) {
+        pthread_join(handles[t], NULL);
+        errors += args[t].errors;
+        if (t < num_writers) {
+            writes += args[t].ops;
+        } else if (t == num_writers) {
+            prunes += args[t].ops;
+        } else if (t == racer) {
+            raced += args[t].ops;
+        } else {
+            searches += args[t].ops;
+            checked += args[t].checked;
+        }
+    }
+    printf("Operações: %lld inserções/remoções, %lld podas (%lld com a corrida intercalada ao corte), "
+           "%lld inserções de corrida, %lld buscas (%lld conferidas); %lld divergências durante a execução\n",
+           writes, prunes, args[num_writers].overlaps, raced, searches, checked, errors);
+    if (prunes >= MIN_PRUNES_FOR_OVERLAP && args[num_writers].overlaps == 0) {
+        printf("A corrida nunca se intercalou ao corte em %lld podas\n", prunes);
+        errors++;
+    }
+
+    // --- Conferência final, sem concorrência ---
+    concurrent_trie_synchronize(&trie);
+    if (concurrent_trie_cursor_init(&trie, &cursor) != 0) {
+        perror("Falha ao registrar a thread principal");
+        return 1;
+    }
+    long long mismatches = 0;
+    for (long long k = 0; k < num_keys; k++) {
+        mismatches += concurrent_trie_search(&trie, &cursor, keys[k]) != atomic_load(&present[k]);
+    }
+    concurrent_trie_cursor_release(&trie, &cursor);
+    long long frozen = 0;
+    long long reachable = count_reachable(&trie, trie.root, &frozen);
+    printf("Ao final: %lld chaves divergentes, %lld nós alcançáveis (contador: %lld), %lld bits de "
+           "congelamento, %zu nós recuperados à espera de reuso\n", mismatches, reachable,
+           concurrent_trie_count(&trie), frozen, trie.num_recycled);
+    errors += mismatches + frozen + (reachable != concurrent_trie_count(&trie));
+
+    printf("Resultado: %s\n", errors ? "FALHOU" : "ok");
+    concurrent_trie_destroy(&trie);
+    free(handles);
+    free(args);
+    free(keys);
+    free(present);
+    free(version);
+    free(buf);
+    free(offsets);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+#ifndef TRIE_H
+#define TRIE_H
+
+// Trie sequencial de layout fixo (26 filhos por nó) sobre a arena de
+// trie_arena.h. Usada por sequencial_trie.c e como referência sequencial
+// pelos programas paralelos.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "trie_arena.h"
+
+// Tamanho do alfabeto para letras minúsculas 'a'-'z'
+#define ALPHABET_SIZE 26
+
+// Estrutura para um nó da Trie. Os filhos são índices de 32 bits na arena
+// (0 = sem filho), metade do tamanho de um ponteiro.
+//
+// Os agregados da subárvore são mantidos a cada inserção e permitem ao
+// autocompletar (trie_autocomplete.h) descartar ramos inteiros sem visitá-los.
+struct TrieNode {
+    uint32_t children[ALPHABET_SIZE];
+    // true se o nó representa o final de uma palavra
+    bool isEndOfWord;
+    uint32_t frequency;     // Vezes que a palavra terminada aqui foi inserida
+    uint32_t maxFrequency;  // Maior frequência de uma palavra da subárvore (incluindo este nó)
+    uint32_t wordCount;     // Palavras distintas na subárvore (incluindo este nó)
+};
+
+// Trie com todos os nós numa arena; a raiz é o primeiro nó alocado
+struct Trie {
+    TrieArena arena;
+    uint32_t root;
+};
+
+// Endereço do nó de índice ref
+#define NODE(trie, ref) ((struct TrieNode *)trie_arena_get(&(trie)->arena, (ref)))
+
+// Função para criar um novo nó da Trie. A arena entrega memória já zerada:
+// filhos 0 (sem filho), isEndOfWord false e agregados 0. Retorna 0 se faltar memória.
+static inline uint32_t createNode(struct Trie *trie) {
+    return trie_arena_alloc(&trie->arena);
+}
+
+// Inicializa a Trie com a arena e a raiz. Retorna 0 ou -1 se faltar memória.
+static inline int initTrie(struct Trie *trie) {
+    if (trie_arena_init(&trie->arena, sizeof(struct TrieNode)) != 0) {
+        return -1;
+    }
+    trie->root = createNode(trie);
+    if (!trie->root) {
+        trie_arena_destroy(&trie->arena);
+        return -1;
+    }
+    return 0;
+}
+
+// Função para inserir count ocorrências de uma chave de length caracteres na
+// Trie. A chave não precisa terminar em '\0' (pode apontar direto para um
+// arquivo mapeado). A frequência satura em UINT32_MAX.
+static inline void insertLenCount(struct Trie *trie, const char *key, size_t length, uint32_t count) {
+    uint32_t currentNode = trie->root;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        // Calcula o índice do caractere (ex: 'a' -> 0, 'b' -> 1)
+        int index = key[i] - 'a';
+
+        // Verifica se o caractere está dentro do alfabeto esperado
+        if (index < 0 || index >= ALPHABET_SIZE) {
+            // printf("Erro na inserção: Caractere '%c' fora do alfabeto suportado ('a'-'z').\n", key[i]);
+            return; // Ignora caracteres inválidos silenciosamente para não afetar a medição de tempo principal
+        }
+
+        // Se o filho correspondente ao caractere não existe, cria um novo nó.
+        // Os blocos da arena nunca se movem, então o endereço do pai segue válido.
+        uint32_t child = NODE(trie, currentNode)->children[index];
+        if (!child) {
+            child = createNode(trie);
+            if (!child) {
+                return; // Arena esgotada
+            }
+            NODE(trie, currentNode)->children[index] = child;
+        }
+
+        // Move para o nó filho
+        currentNode = child;
+    }
+
+    // Marca o nó final como o fim de uma palavra
+    struct TrieNode *last = NODE(trie, currentNode);
+    bool isNewWord = !last->isEndOfWord;
+    uint32_t frequency = last->frequency > UINT32_MAX - count ? UINT32_MAX : last->frequency + count;
+    last->isEndOfWord = true;
+    last->frequency = frequency;
+
+    // Atualiza os agregados no caminho da raiz até o fim da palavra. O caminho
+    // já existe e acabou de ser percorrido, então as linhas ainda estão no cache.
+    currentNode = trie->root;
+    for (i = 0;; i++) {
+        struct TrieNode *node = NODE(trie, currentNode);
+        node->wordCount += isNewWord;
+        if (node->maxFrequency < frequency) {
+            node->maxFrequency = frequency;
+        }
+        if (i == length) {
+            break;
+        }
+        currentNode = node->children[key[i] - 'a'];
+    }
+}
+
+// Função para inserir uma chave de length caracteres na Trie (uma ocorrência)
+static inline void insertLen(struct Trie *trie, const char *key, size_t length) {
+    insertLenCount(trie, key, length, 1);
+}
+
+// Função para buscar uma chave na Trie
+// Retorna true se a chave de length caracteres for encontrada como uma palavra
+// completa, false caso contrário. A chave não precisa terminar em '\0'.
+static inline bool searchLen(const struct Trie *trie, const char *key, size_t length) {
+    uint32_t currentNode = trie->root;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        int index = key[i] - 'a';
+
+         // Verifica se o caractere está dentro do alfabeto esperado
+        if (index < 0 || index >= ALPHABET_SIZE) {
+            return false; // Caractere inválido, palavra não está na Trie
+        }
+
+        // Se o filho correspondente ao caractere não existe, a palavra não está na Trie
+        currentNode = NODE(trie, currentNode)->children[index];
+        if (!currentNode) {
+            return false;
+        }
+    }
+
+    // Se chegamos ao final da string e o nó atual está marcado como fim de palavra,
+    // a string foi encontrada.
+    return NODE(trie, currentNode)->isEndOfWord;
+}
+
+// Função para inserir uma string na Trie
+static inline void insert(struct Trie *trie, const char *key) {
+    insertLen(trie, key, strlen(key));
+}
+
+// Função para buscar uma string na Trie
+static inline bool search(const struct Trie *trie, const char *key) {
+    return searchLen(trie, key, strlen(key));
+}
+
+// Buscas em andamento ao mesmo tempo em searchBatch
+#define TRIE_BATCH_WINDOW 16
+
+// Uma busca em andamento: a chave, quantos caracteres já consumiu e o nó atual
+struct TrieBatchSlot {
+    const char *key;
+    size_t len;
+    size_t pos;
+    size_t query;
+    uint32_t node;
+};
+
+// Busca n chaves de uma vez e marca o bit i de found (n bits, em palavras de
+// 64) se keys[i] for uma palavra completa. lens pode ser NULL (chaves com '\0').
+//
+// Cada nível da Trie costuma ser uma falta de cache, e uma busca sozinha não
+// tem o que fazer enquanto espera o próximo nó. Aqui TRIE_BATCH_WINDOW buscas
+// avançam alternadamente, um caractere por vez: depois de descer um nível, a
+// busca pede o próximo nó com __builtin_prefetch e cede a vez às outras, de
+// modo que quando ela volta a linha já chegou. Quando uma busca termina, a
+// próxima chave entra no lugar dela.
+static inline void searchBatch(const struct Trie *trie, const char *const *keys, const size_t *lens,
+                               size_t n, uint64_t *found) {
+    struct TrieBatchSlot slots[TRIE_BATCH_WINDOW];
+    size_t next = 0;
+    int active = 0;
+
+    memset(found, 0, (n + 63) / 64 * sizeof(uint64_t));
+    for (; active < TRIE_BATCH_WINDOW && next < n; active++, next++) {
+        slots[active] = (struct TrieBatchSlot){keys[next], lens ? lens[next] : strlen(keys[next]), 0, next, trie->root};
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < active;) {
+            struct TrieBatchSlot *slot = &slots[s];
+            bool done = false, hit = false;
+
+            if (slot->pos == slot->len) {
+                done = true;
+                hit = NODE(trie, slot->node)->isEndOfWord;
+            } else {
+                int index = slot->key[slot->pos] - 'a';
+                uint32_t child = index >= 0 && index < ALPHABET_SIZE ? NODE(trie, slot->node)->children[index] : 0;
+                if (!child) {
+                    done = true;
+                } else {
+                    // Pede a linha que o próximo passo vai ler: o filho do próximo caractere ou a marca de fim
+                    const struct TrieNode *node = NODE(trie, child);
+                    int next_index = ++slot->pos < slot->len ? slot->key[slot->pos] - 'a' : -1;
+                    __builtin_prefetch(next_index >= 0 && next_index < ALPHABET_SIZE
+                                       ? (const void *)&node->children[next_index] : (const void *)&node->isEndOfWord);
+                    slot->node = child;
+                }
+            }
+
+            if (!done) {
+                s++;
+                continue;
+            }
+            if (hit) {
+                found[slot->query / 64] |= 1ull << (slot->query % 64);
+            }
+            if (next < n) {
+                *slot = (struct TrieBatchSlot){keys[next], lens ? lens[next] : strlen(keys[next]), 0, next, trie->root};
+                next++;
+                s++;
+            } else {
+                *slot = slots[--active];
+            }
+        }
+    }
+}
+
+// Libera toda a memória da Trie de uma vez (um munmap por bloco da arena)
+static inline void freeTrie(struct Trie *trie) {
+    trie_arena_destroy(&trie->arena);
+    trie->root = 0;
+}
+
+#endif // TRIE_H
@@ -0,0 +1,136 @@
+#ifndef TRIE_ARENA_H
+#define TRIE_ARENA_H
+
+// Arena de nós de tamanho fixo com ponteiro de avanço e índices de 32 bits.
+//
+// Os nós vêm de blocos grandes obtidos com mmap: memória já zerada pelo kernel
+// (sem laço de inicialização), alinhada em 2 MB e marcada com MADV_HUGEPAGE
+// para que o kernel possa usar páginas enormes (o resto do bloco que não
+// completa uma página enorme fica em páginas normais). Cada bloco tem
+// TRIE_ARENA_CHUNK_NODES nós (potência de dois), então um índice vira
+// (bloco, posição) com um deslocamento e uma máscara.
+//
+// O índice 0 é reservado e faz o papel de NULL; com 32 bits cabem até ~4
+// bilhões de nós, e cada ligação entre nós ocupa metade de um ponteiro.
+// Não há liberação individual: trie_arena_destroy devolve todos os blocos de
+// uma vez, em tempo proporcional ao número de blocos (não de nós).
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Nós por bloco (potência de dois)
+#define TRIE_ARENA_CHUNK_SHIFT 16
+#define TRIE_ARENA_CHUNK_NODES (1u << TRIE_ARENA_CHUNK_SHIFT)
+#define TRIE_ARENA_CHUNK_MASK (TRIE_ARENA_CHUNK_NODES - 1)
+
+// Tamanho de página enorme; os blocos começam alinhados a ele
+#define TRIE_ARENA_HUGE_PAGE (2u << 20)
+
+// Maior número de blocos endereçáveis com índices de 32 bits
+#define TRIE_ARENA_MAX_CHUNKS (1u << (32 - TRIE_ARENA_CHUNK_SHIFT))
+
+typedef struct {
+    char **chunks;          // Base de cada bloco
+    uint32_t num_chunks;
+    uint32_t next;          // Próximo índice livre (o índice 0 nunca é entregue)
+    size_t node_size;
+    size_t chunk_bytes;     // Bytes mapeados por bloco (múltiplo da página normal)
+} TrieArena;
+
+// Prepara a arena para nós de node_size bytes. Nenhuma memória é mapeada até
+// a primeira alocação. Retorna 0 ou -1 se faltar memória para a tabela de blocos.
+static inline int trie_arena_init(TrieArena *arena, size_t node_size) {
+    arena->chunks = calloc(TRIE_ARENA_MAX_CHUNKS, sizeof(char *));
+    if (!arena->chunks) {
+        return -1;
+    }
+    arena->num_chunks = 0;
+    arena->next = 1;
+    arena->node_size = node_size;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    arena->chunk_bytes = (node_size * TRIE_ARENA_CHUNK_NODES + page - 1) / page * page;
+    return 0;
+}
+
+// Mapeia um bloco alinhado em 2 MB: reserva uma folga e devolve as sobras.
+// bytes deve ser múltiplo do tamanho da página.
+static inline char *trie_arena_map_chunk(size_t bytes) {
+    size_t len = bytes + TRIE_ARENA_HUGE_PAGE;
+    char *raw = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return NULL;
+    }
+
+    uintptr_t aligned = ((uintptr_t)raw + TRIE_ARENA_HUGE_PAGE - 1) & ~(uintptr_t)(TRIE_ARENA_HUGE_PAGE - 1);
+    size_t head = aligned - (uintptr_t)raw;
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    munmap((char *)aligned + bytes, len - head - bytes);
+
+#ifdef MADV_HUGEPAGE
+    madvise((void *)aligned, bytes, MADV_HUGEPAGE);
+#endif
+    return (char *)aligned;
+}
+
+// Endereço do nó de índice ref (ref != 0)
+static inline void *trie_arena_get(const TrieArena *arena, uint32_t ref) {
+    return arena->chunks[ref >> TRIE_ARENA_CHUNK_SHIFT] + (size_t)(ref & TRIE_ARENA_CHUNK_MASK) * arena->node_size;
+}
+
+// Aloca um nó zerado e devolve o seu índice, ou 0 se faltar memória
+static inline uint32_t trie_arena_alloc(TrieArena *arena) {
+    uint32_t ref = arena->next;
+    uint32_t chunk = ref >> TRIE_ARENA_CHUNK_SHIFT;
+
+    // Espaço de índices esgotado
+    if (ref == 0) {
+        return 0;
+    }
+
+    if (chunk >= arena->num_chunks) {
+        if (chunk >= TRIE_ARENA_MAX_CHUNKS) {
+            return 0;
+        }
+        char *base = trie_arena_map_chunk(arena->chunk_bytes);
+        if (!base) {
+            return 0;
+        }
+        arena->chunks[arena->num_chunks++] = base;
+    }
+
+    // Depois do índice UINT32_MAX, next dá a volta para 0 e marca a arena como cheia
+    arena->next = ref + 1;
+    return ref;
+}
+
+// Nós entregues até agora
+static inline uint32_t trie_arena_count(const TrieArena *arena) {
+    return arena->next == 0 ? UINT32_MAX : arena->next - 1;
+}
+
+// Bytes efetivamente ocupados por nós
+static inline size_t trie_arena_used_bytes(const TrieArena *arena) {
+    return (size_t)trie_arena_count(arena) * arena->node_size;
+}
+
+// Bytes mapeados (reservados) pela arena
+static inline size_t trie_arena_mapped_bytes(const TrieArena *arena) {
+    return (size_t)arena->num_chunks * arena->chunk_bytes;
+}
+
+// Devolve todos os blocos de uma vez
+static inline void trie_arena_destroy(TrieArena *arena) {
+    for (uint32_t i = 0; i < arena->num_chunks; ++i) {
+        munmap(arena->chunks[i], arena->chunk_bytes);
+    }
+    free(arena->chunks);
+    arena->chunks = NULL;
+    arena->num_chunks = 0;
+    arena->next = 1;
+}
+
+#endif // TRIE_ARENA_H
@@ -0,0 +1,227 @@
+#ifndef TRIE_AUTOCOMPLETE_H
+#define TRIE_AUTOCOMPLETE_H
+
+// Autocompletar: as k palavras mais frequentes que começam com um prefixo.
+//
+// A busca é best-first sobre a subárvore do prefixo, com uma fila de
+// prioridade de candidatos. Um candidato é um nó, com prioridade igual à
+// maxFrequency da sua subárvore, ou uma palavra pronta, com a sua frequência.
+// Retirar um nó coloca na fila a palavra dele (se houver) e os filhos.
+// Como maxFrequency é um limite exato (existe uma palavra com essa
+// frequência na subárvore), uma palavra só sai da fila quando nenhum ramo
+// ainda fechado pode ter outra mais frequente.
+//
+// Empates de prioridade (o caso normal numa lista de palavras sem contagens,
+// em que todas têm frequência 1) saem em profundidade: o nó mais fundo
+// primeiro. Sem isso a busca vira uma varredura em largura da subárvore
+// inteira antes da primeira resposta. Assim cada resposta abre no máximo um
+// caminho até a palavra, com até ALPHABET_SIZE candidatos por nível, e o
+// trabalho fica em O(k * comprimento * ALPHABET_SIZE * log(fila)), sem
+// depender do número de palavras com o prefixo (que sai pronto em wordCount).
+//
+// Quando todas as frequências da subárvore são iguais, as respostas saem em
+// ordem alfabética. Com frequências mistas, palavras de mesma frequência saem
+// na ordem em que a busca as alcança, que não é necessariamente a alfabética:
+// com a:5, bc:5 e bd:9, o ramo 'b' é aberto por causa de bd e bc, mais funda,
+// sai antes de a.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trie.h"
+
+// Uma resposta: word é alocada com malloc (liberar com freeCompletions)
+struct TrieCompletion {
+    char *word;
+    uint32_t frequency;
+};
+
+// Candidato da busca. parent aponta para o candidato do nó pai (-1 na raiz
+// da busca), letter é o caractere que leva do pai a este nó e depth a
+// distância até a raiz da busca (a palavra de um nó tem a profundidade dele).
+struct TrieCandidate {
+    uint32_t node;
+    uint32_t priority;
+    int32_t parent;
+    char letter;
+    bool isWord;
+    uint16_t depth;
+};
+
+// Estado da busca: candidatos já criados e o heap (índices em candidates)
+struct TrieTopK {
+    struct TrieCandidate *candidates;
+    int32_t *heap;
+    size_t numCandidates;
+    size_t heapSize;
+    size_t capacity;
+};
+
+// a sai antes de b: maior prioridade, depois palavra antes de nó, depois o
+// mais fundo, depois quem foi descoberto antes (irmãos em ordem alfabética)
+static inline bool topKBefore(const struct TrieTopK *q, int32_t a, int32_t b) {
+    const struct TrieCandidate *x = &q->candidates[a], *y = &q->candidates[b];
+    if (x->priority != y->priority) {
+        return x->priority > y->priority;
+    }
+    if (x->isWord != y->isWord) {
+        return x->isWord;
+    }
+    if (x->depth != y->depth) {
+        return x->depth > y->depth;
+    }
+    return a < b;
+}
+
+// Cria um candidato e o coloca no heap. Retorna 0 ou -1 se faltar memória.
+static inline int topKPush(struct TrieTopK *q, struct TrieCandidate candidate) {
+    if (q->numCandidates == q->capacity) {
+        size_t capacity = q->capacity ? q->capacity * 2 : 64;
+        struct TrieCandidate *candidates = realloc(q->candidates, capacity * sizeof(*candidates));
+        if (!candidates) {
+            return -1;
+        }
+        q->candidates = candidates;
+        int32_t *heap = realloc(q->heap, capacity * sizeof(*heap));
+        if (!heap) {
+            return -1;
+        }
+        q->heap = heap;
+        q->capacity = capacity;
+    }
+    int32_t id = (int32_t)q->numCandidates++;
+    q->candidates[id] = candidate;
+
+    size_t i = q->heapSize++;
+    while (i > 0 && topKBefore(q, id, q->heap[(i - 1) / 2])) {
+        q->heap[i] = q->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    q->heap[i] = id;
+    return 0;
+}
+
+static inline int32_t topKPop(struct TrieTopK *q) {
+    int32_t top = q->heap[0];
+    int32_t last = q->heap[--q->heapSize];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= q->heapSize) {
+            break;
+        }
+        if (child + 1 < q->heapSize && topKBefore(q, q->heap[child + 1], q->heap[child])) {
+            child++;
+        }
+        if (!topKBefore(q, q->heap[child], last)) {
+            break;
+        }
+        q->heap[i] = q->heap[child];
+        i = child;
+    }
+    if (q->heapSize > 0) {
+        q->heap[i] = last;
+    }
+    return top;
+}
+
+// Monta prefixo + caracteres do caminho até o candidato id
+static inline char *topKSpell(const struct TrieTopK *q, int32_t id, const char *prefix, size_t prefixLen) {
+    size_t depth = 0;
+    for (int32_t c = id; q->candidates[c].parent >= 0; c = q->candidates[c].parent) {
+        depth++;
+    }
+    char *word = malloc(prefixLen + depth + 1);
+    if (!word) {
+        return NULL;
+    }
+    memcpy(word, prefix, prefixLen);
+    word[prefixLen + depth] = '\0';
+    for (int32_t c = id; q->candidates[c].parent >= 0; c = q->candidates[c].parent) {
+        word[prefixLen + --depth] = q->candidates[c].letter;
+    }
+    return word;
+}
+
+// Nó onde termina o prefixo, ou 0 se nenhuma palavra começa com ele
+static inline uint32_t prefixNode(const struct Trie *trie, const char *prefix, size_t prefixLen) {
+    uint32_t currentNode = trie->root;
+    for (size_t i = 0; i < prefixLen && currentNode; i++) {
+        int index = prefix[i] - 'a';
+        if (index < 0 || index >= ALPHABET_SIZE) {
+            return 0;
+        }
+        currentNode = NODE(trie, currentNode)->children[index];
+    }
+    return currentNode;
+}
+
+// Quantas palavras distintas começam com o prefixo (lido do agregado, O(|prefixo|))
+static inline uint32_t countPrefix(const struct Trie *trie, const char *prefix, size_t prefixLen) {
+    uint32_t node = prefixNode(trie, prefix, prefixLen);
+    return node ? NODE(trie, node)->wordCount : 0;
+}
+
+static inline void freeCompletions(struct TrieCompletion *out, int n) {
+    for (int i = 0; i < n; i++) {
+        free(out[i].word);
+        out[i].word = NULL;
+    }
+}
+
+// Preenche out com até k palavras que começam com o prefixo, da mais para a
+// menos frequente (empates na ordem descrita no início do arquivo). Retorna
+// quantas foram encontradas, ou -1 se faltar memória.
+static inline int topKCompletions(const struct Trie *trie, const char *prefix, size_t prefixLen, int k,
+                                  struct TrieCompletion *out) {
+    uint32_t start = prefixNode(trie, prefix, prefixLen);
+    if (!start || k <= 0 || NODE(trie, start)->wordCount == 0) {
+        return 0;
+    }
+
+    struct TrieTopK q = {0};
+    int found = 0;
+    int ret = topKPush(&q, (struct TrieCandidate){start, NODE(trie, start)->maxFrequency, -1, 0, false, 0});
+    while (ret == 0 && found < k && q.heapSize > 0) {
+        int32_t id = topKPop(&q);
+        struct TrieCandidate candidate = q.candidates[id];
+
+        if (candidate.isWord) {
+            char *word = topKSpell(&q, candidate.parent, prefix, prefixLen);
+            if (!word) {
+                ret = -1;
+                break;
+            }
+            out[found].word = word;
+            out[found].frequency = candidate.priority;
+            found++;
+            continue;
+        }
+
+        const struct TrieNode *node = NODE(trie, candidate.node);
+        if (node->isEndOfWord) {
+            ret = topKPush(&q, (struct TrieCandidate){candidate.node, node->frequency, id, 0, true, candidate.depth});
+        }
+        for (int c = 0; c < ALPHABET_SIZE && ret == 0; c++) {
+            // Ramos sem palavras (sobras de inserções interrompidas) nem entram na fila
+            if (node->children[c] && NODE(trie, node->children[c])->wordCount > 0) {
+                const struct TrieNode *child = NODE(trie, node->children[c]);
+                ret = topKPush(&q, (struct TrieCandidate){node->children[c], child->maxFrequency, id,
+                                                          (char)('a' + c), false,
+                                                          (uint16_t)(candidate.depth + 1)});
+            }
+        }
+    }
+
+    free(q.candidates);
+    free(q.heap);
+    if (ret != 0) {
+        freeCompletions(out, found);
+        return -1;
+    }
+    return found;
+}
+
+#endif // TRIE_AUTOCOMPLETE_H
@@ -0,0 +1,291 @@
+#ifndef TRIE_LOADER_H
+#define TRIE_LOADER_H
+
+// Leitura de listas de palavras (uma por linha) para os programas da Trie.
+//
+// trie_input_open mapeia o arquivo somente para leitura (MADV_SEQUENTIAL);
+// "-" ou um arquivo que não pode ser mapeado (pipe, por exemplo) é lido em
+// blocos para um buffer. Em nenhum dos casos as palavras são copiadas uma a
+// uma: trie_tokenize só registra (ponteiro, tamanho) de cada linha, e as
+// chaves são entregues a insertLen/searchLen direto do buffer, sem '\0'.
+//
+// A tokenização é paralela: o buffer é dividido em num_threads pedaços, cada
+// fronteira avançada até depois do próximo '\n', e cada thread conta as linhas
+// do seu pedaço e depois as grava na sua faixa de um único vetor (a soma de
+// prefixos das contagens dá onde cada faixa começa, então a ordem do arquivo é
+// preservada). Linhas vazias são ignoradas e um '\r' final é removido.
+// Uma contagem no fim da linha pode ser separada com trie_token_count.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../common/affinity.h"
+
+// Bloco de leitura quando o arquivo não pode ser mapeado
+#define TRIE_INPUT_READ_BLOCK (1u << 20)
+
+typedef struct {
+    const char *data;
+    size_t length;
+    int mapped;             // 1 = mmap, 0 = buffer lido (ou vazio)
+} TrieInput;
+
+// Uma palavra dentro do buffer de entrada (não termina em '\0')
+typedef struct {
+    const char *key;
+    size_t len;
+} TrieToken;
+
+typedef struct {
+    TrieToken *tokens;
+    size_t count;
+} TrieTokens;
+
+// Lê todo o descritor fd para um buffer alocado
+static inline int trie_input_read_fd(int fd, TrieInput *input) {
+    size_t capacity = 0, length = 0;
+    char *buf = NULL;
+    for (;;) {
+        if (capacity - length < TRIE_INPUT_READ_BLOCK) {
+            capacity = capacity ? capacity * 2 : TRIE_INPUT_READ_BLOCK;
+            char *grown = realloc(buf, capacity);
+            if (!grown) {
+                free(buf);
+                return -1;
+            }
+            buf = grown;
+        }
+        ssize_t n = read(fd, buf + length, capacity - length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            int saved = errno;
+            free(buf);
+            errno = saved;
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += (size_t)n;
+    }
+    input->data = buf;
+    input->length = length;
+    input->mapped = 0;
+    return 0;
+}
+
+// Abre path ("-" = entrada padrão). Retorna 0 ou -1 (errno definido).
+static inline int trie_input_open(const char *path, TrieInput *input) {
+    if (strcmp(path, "-") == 0) {
+        return trie_input_read_fd(STDIN_FILENO, input);
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+
+    int ret = 0;
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+            input->data = data;
+            input->length = (size_t)st.st_size;
+            input->mapped = 1;
+        } else {
+            ret = trie_input_read_fd(fd, input);
+        }
+    } else if (S_ISREG(st.st_mode)) {
+        input->data = NULL;
+        input->length = 0;
+        input->mapped = 0;
+    } else {
+        ret = trie_input_read_fd(fd, input);
+    }
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return ret;
+}
+
+static inline void trie_input_close(TrieInput *input) {
+    if (input->mapped) {
+        munmap((void *)input->data, input->length);
+    } else {
+        free((void *)input->data);
+    }
+    input->data = NULL;
+    input->length = 0;
+}
+
+// Percorre as linhas de [begin, end). Com out == NULL só conta; senão grava
+// os tokens em out. Retorna o número de palavras.
+static inline size_t trie_tokenize_range(const char *begin, const char *end, TrieToken *out) {
+    size_t count = 0;
+    const char *p = begin;
+    while (p < end) {
+        const char *nl = memchr(p, '\n', (size_t)(end - p));
+        const char *line_end = nl ? nl : end;
+        size_t len = (size_t)(line_end - p);
+        if (len > 0 && p[len - 1] == '\r') {
+            len--;
+        }
+        if (len > 0) {
+            if (out) {
+                out[count].key = p;
+                out[count].len = len;
+            }
+            count++;
+        }
+        p = line_end + 1;
+    }
+    return count;
+}
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    TrieToken *out;         // NULL na passada de contagem
+    size_t count;
+} TrieTokenizeArgs;
+
+static inline void *trie_tokenize_thread(void *arg) {
+    TrieTokenizeArgs *args = arg;
+    args->count = trie_tokenize_range(args->begin, args->end, args->out);
+    return NULL;
+}
+
+// Roda uma passada (contagem ou gravação) em todas as threads
+static inline int trie_tokenize_pass(TrieTokenizeArgs *args, pthread_t *handles, int num_threads,
+                                     const AffinityPlan *plan) {
+    int ret = 0;
+    int created = 0;
+    for (; created < num_threads; created++) {
+        ret = affinity_thread_create(&handles[created], plan, created, trie_tokenize_thread, &args[created]);
+        if (ret != 0) {
+            break;
+        }
+    }
+    for (int t = 0; t < created; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    return ret;
+}
+
+// Divide a entrada em palavras com num_threads threads posicionadas por plan
+// (pode ser NULL). tokens->tokens deve ser liberado com trie_tokens_free.
+// Retorna 0 ou -1 (errno definido).
+static inline int trie_tokenize(const TrieInput *input, int num_threads, const AffinityPlan *plan,
+                                TrieTokens *tokens) {
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    TrieTokenizeArgs *args = calloc((size_t)num_threads, sizeof(TrieTokenizeArgs));
+    pthread_t *handles = malloc((size_t)num_threads * sizeof(pthread_t));
+    if (!args || !handles) {
+        free(args);
+        free(handles);
+        return -1;
+    }
+
+    // Fronteiras dos pedaços, cada uma logo depois de um '\n'
+    const char *data = input->data;
+    const char *end = data + input->length;
+    const char *begin = data;
+    for (int t = 0; t < num_threads; t++) {
+        const char *chunk_end = t == num_threads - 1 ? end : data + input->length / num_threads * (t + 1);
+        if (chunk_end < begin) {
+            chunk_end = begin;
+        }
+        if (chunk_end < end && chunk_end > data) {
+            const char *nl = memchr(chunk_end - 1, '\n', (size_t)(end - chunk_end + 1));
+            chunk_end = nl ? nl + 1 : end;
+        }
+        args[t].begin = begin;
+        args[t].end = chunk_end;
+        begin = chunk_end;
+    }
+
+    int ret = trie_tokenize_pass(args, handles, num_threads, plan);
+    size_t total = 0;
+    for (int t = 0; t < num_threads && ret == 0; t++) {
+        size_t count = args[t].count;
+        args[t].count = total;
+        total += count;
+    }
+
+    TrieToken *out = NULL;
+    if (ret == 0) {
+        out = malloc((total ? total : 1) * sizeof(TrieToken));
+        if (!out) {
+            ret = ENOMEM;
+        }
+    }
+    if (ret == 0) {
+        for (int t = 0; t < num_threads; t++) {
+            args[t].out = out + args[t].count;
+        }
+        ret = trie_tokenize_pass(args, handles, num_threads, plan);
+    }
+
+    free(args);
+    free(handles);
+    if (ret != 0) {
+        free(out);
+        errno = ret;
+        return -1;
+    }
+    tokens->tokens = out;
+    tokens->count = total;
+    return 0;
+}
+
+// Separa uma contagem no fim da linha ("palavra 42" ou "palavra\t42", como nas
+// listas de frequência): encurta token->len para só a palavra e retorna a
+// contagem (saturada em UINT32_MAX), ou 1 se a linha não tiver contagem.
+static inline uint32_t trie_token_count(TrieToken *token) {
+    size_t end = token->len;
+    size_t digits = end;
+    while (digits > 0 && token->key[digits - 1] >= '0' && token->key[digits - 1] <= '9') {
+        digits--;
+    }
+    size_t word_end = digits;
+    while (word_end > 0 && (token->key[word_end - 1] == ' ' || token->key[word_end - 1] == '\t')) {
+        word_end--;
+    }
+    if (digits == end || word_end == digits || word_end == 0) {
+        return 1;
+    }
+
+    uint64_t count = 0;
+    for (size_t i = digits; i < end && count <= UINT32_MAX; i++) {
+        count = count * 10 + (uint64_t)(token->key[i] - '0');
+    }
+    token->len = word_end;
+    return count > UINT32_MAX ? UINT32_MAX : (uint32_t)count;
+}
+
+static inline void trie_tokens_free(TrieTokens *tokens) {
+    free(tokens->tokens);
+    tokens->tokens = NULL;
+    tokens->count = 0;
+}
+
+#endif // TRIE_LOADER_H
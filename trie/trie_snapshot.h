@@ -0,0 +1,389 @@
+#ifndef TRIE_SNAPSHOT_H
+#define TRIE_SNAPSHOT_H
+
+// Retrato imutável da Trie como double-array, consultável direto do mmap.
+//
+// trie_snapshot_freeze converte uma Trie já construída (trie.h) num vetor de
+// células {base, check}: o filho do estado s pelo caractere c é t = base[s] + c,
+// válido se check[t] == s. Não há ponteiros nem índices de arena, então a
+// imagem em memória é exatamente o arquivo gravado por trie_snapshot_save, e
+// trie_snapshot_open só precisa de mmap + validação do cabeçalho: nenhum
+// parse, nenhuma alocação. Os processos que abrem o mesmo arquivo dividem as
+// páginas do cache do kernel.
+//
+// base e check de uma célula ficam lado a lado: cada passo da busca lê
+// check[t] e, no passo seguinte, base[t] da mesma célula (um acesso à memória
+// por caractere). O bit mais alto de base marca fim de palavra.
+//
+// Formato (ordem de bytes nativa, conferida no cabeçalho):
+//   TrieSnapshotHeader              32 bytes
+//   TrieSnapshotCell[num_cells]     8 bytes cada; o estado 1 é a raiz
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trie.h"
+
+#define TRIE_SNAPSHOT_MAGIC "TRIESNP"
+#define TRIE_SNAPSHOT_VERSION 1
+#define TRIE_SNAPSHOT_BYTE_ORDER 0x01020304u
+
+#define TRIE_SNAPSHOT_ROOT 1u
+#define TRIE_SNAPSHOT_END 0x80000000u
+
+// Tentativas frustradas numa célula livre antes de a busca por bases passar a
+// começar depois dela (a célula ainda pode ser ocupada, só não é mais ponto de partida)
+#define TRIE_SNAPSHOT_MAX_TRIALS 4
+
+// Maior número de células: base precisa caber em 31 bits
+#define TRIE_SNAPSHOT_MAX_CELLS (TRIE_SNAPSHOT_END - ALPHABET_SIZE)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t num_cells;
+    uint32_t num_states;
+    uint64_t num_words;
+} TrieSnapshotHeader;
+
+typedef struct {
+    uint32_t base;          // Deslocamento dos filhos | TRIE_SNAPSHOT_END
+    uint32_t check;         // Estado pai (0 = célula livre)
+} TrieSnapshotCell;
+
+// Retrato aberto: aponta para a imagem (mapeada ou alocada por freeze)
+typedef struct {
+    const TrieSnapshotHeader *header;
+    const TrieSnapshotCell *cells;
+    size_t length;          // Bytes da imagem
+    int mapped;             // 1 = veio de mmap, 0 = alocada por freeze
+} TrieSnapshot;
+
+// Estado da construção: células em crescimento e a lista duplamente ligada
+// das células livres, para achar uma base sem varrer o vetor inteiro
+typedef struct {
+    uint32_t *base;
+    uint32_t *check;
+    uint32_t *next_free;    // 0 termina a lista (a célula 0 nunca é usada)
+    uint32_t *prev_free;
+    uint8_t *trials;        // Tentativas frustradas em cada célula livre
+    uint32_t capacity;
+    uint32_t first_free;
+    uint32_t scan_from;     // Célula livre onde começa a busca por bases (0 = first_free)
+    uint32_t used;          // Maior célula ocupada + 1
+} TrieSnapshotBuilder;
+
+// Aumenta o vetor para pelo menos min_capacity células, encadeando as novas no fim da lista livre
+static inline int trie_snapshot_grow(TrieSnapshotBuilder *b, uint32_t min_capacity) {
+    if (min_capacity <= b->capacity) {
+        return 0;
+    }
+    if (min_capacity > TRIE_SNAPSHOT_MAX_CELLS) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    uint64_t wanted = (uint64_t)b->capacity * 2;
+    uint32_t capacity = (uint32_t)(wanted < min_capacity ? min_capacity
+                                   : wanted > TRIE_SNAPSHOT_MAX_CELLS ? TRIE_SNAPSHOT_MAX_CELLS : wanted);
+    uint8_t *trials = realloc(b->trials, capacity);
+    if (!trials) {
+        return -1;
+    }
+    b->trials = trials;
+    uint32_t *arrays[4] = {b->base, b->check, b->next_free, b->prev_free};
+    for (int i = 0; i < 4; i++) {
+        uint32_t *grown = realloc(arrays[i], (size_t)capacity * sizeof(uint32_t));
+        if (!grown) {
+            b->base = arrays[0];
+            b->check = arrays[1];
+            b->next_free = arrays[2];
+            b->prev_free = arrays[3];
+            return -1;
+        }
+        arrays[i] = grown;
+    }
+    b->base = arrays[0];
+    b->check = arrays[1];
+    b->next_free = arrays[2];
+    b->prev_free = arrays[3];
+
+    // Encontra a cauda atual da lista livre (as novas células vão depois dela)
+    uint32_t tail = 0;
+    if (b->first_free) {
+        tail = b->prev_free[b->first_free];
+    }
+    uint32_t start = b->capacity == 0 ? 1 : b->capacity;
+    if (b->capacity == 0) {
+        b->base[0] = b->check[0] = 0;
+    }
+    for (uint32_t i = start; i < capacity; i++) {
+        b->base[i] = 0;
+        b->check[i] = 0;
+        b->trials[i] = 0;
+        b->prev_free[i] = tail;
+        if (tail) {
+            b->next_free[tail] = i;
+        } else {
+            b->first_free = i;
+        }
+        tail = i;
+    }
+    // Lista circular: a cabeça aponta para a cauda em prev_free, e a cauda termina em 0
+    b->next_free[tail] = 0;
+    b->prev_free[b->first_free] = tail;
+    b->capacity = capacity;
+    return 0;
+}
+
+// Ocupa a célula i (livre) com o estado filho de parent
+static inline void trie_snapshot_take(TrieSnapshotBuilder *b, uint32_t i, uint32_t parent) {
+    uint32_t next = b->next_free[i];
+    uint32_t prev = b->prev_free[i];
+    if (i == b->scan_from) {
+        b->scan_from = next;
+    }
+    if (i == b->first_free) {
+        b->first_free = next;
+        if (next) {
+            b->prev_free[next] = prev;      // prev é a cauda
+        }
+    } else {
+        b->next_free[prev] = next;
+        if (next) {
+            b->prev_free[next] = prev;
+        } else {
+            b->prev_free[b->first_free] = prev;
+        }
+    }
+    b->check[i] = parent;
+    if (i + 1 > b->used) {
+        b->used = i + 1;
+    }
+}
+
+// Procura a menor base (>= 1) em que todas as células base + labels[k] estão livres
+static inline int trie_snapshot_find_base(TrieSnapshotBuilder *b, const uint8_t *labels, int num_labels,
+                                          uint32_t *found) {
+    for (;;) {
+        uint32_t start = b->scan_from ? b->scan_from : b->first_free;
+        for (uint32_t p = start; p; p = b->next_free[p]) {
+            if (p <= labels[0]) {
+                continue;
+            }
+            uint32_t candidate = p - labels[0];
+            if ((uint64_t)candidate + labels[num_labels - 1] >= b->capacity) {
+                break; // Não cabe sem crescer: as próximas células livres também não
+            }
+            int k = 1;
+            while (k < num_labels && b->check[candidate + labels[k]] == 0
+                   && candidate + labels[k] != TRIE_SNAPSHOT_ROOT) {
+                k++;
+            }
+            if (k == num_labels) {
+                *found = candidate;
+                return 0;
+            }
+            // Células do início que nunca servem deixam de ser revisitadas a cada nó
+            if (p == start && ++b->trials[p] >= TRIE_SNAPSHOT_MAX_TRIALS && b->next_free[p]) {
+                b->scan_from = start = b->next_free[p];
+            }
+        }
+        if (trie_snapshot_grow(b, b->capacity + ALPHABET_SIZE + 1) != 0) {
+            return -1;
+        }
+    }
+}
+
+static inline void trie_snapshot_builder_free(TrieSnapshotBuilder *b) {
+    free(b->base);
+    free(b->check);
+    free(b->next_free);
+    free(b->prev_free);
+    free(b->trials);
+}
+
+// Converte a Trie num retrato alocado (liberar com trie_snapshot_close).
+// Retorna 0 ou -1 (errno definido).
+static inline int trie_snapshot_freeze(const struct Trie *trie, TrieSnapshot *snap) {
+    uint32_t num_nodes = trie_arena_count(&trie->arena);
+    TrieSnapshotBuilder b = {0};
+    // Fila da busca em largura: (nó da Trie, estado do double-array)
+    uint32_t *queue = malloc((size_t)num_nodes * 2 * sizeof(uint32_t));
+    if (!queue || trie_snapshot_grow(&b, num_nodes + num_nodes / 8 + ALPHABET_SIZE + 2) != 0) {
+        free(queue);
+        trie_snapshot_builder_free(&b);
+        return -1;
+    }
+
+    trie_snapshot_take(&b, TRIE_SNAPSHOT_ROOT, 0);
+    size_t head = 0, tail = 0;
+    queue[tail++] = trie->root;
+    queue[tail++] = TRIE_SNAPSHOT_ROOT;
+    uint64_t num_words = 0;
+
+    while (head < tail) {
+        const struct TrieNode *node = NODE(trie, queue[head]);
+        uint32_t state = queue[head + 1];
+        head += 2;
+
+        uint8_t labels[ALPHABET_SIZE];
+        int num_labels = 0;
+        for (int c = 0; c < ALPHABET_SIZE; c++) {
+            if (node->children[c]) {
+                labels[num_labels++] = (uint8_t)c;
+            }
+        }
+
+        uint32_t base = 0;
+        if (num_labels > 0) {
+            if (trie_snapshot_find_base(&b, labels, num_labels, &base) != 0) {
+                free(queue);
+                trie_snapshot_builder_free(&b);
+                return -1;
+            }
+            for (int k = 0; k < num_labels; k++) {
+                trie_snapshot_take(&b, base + labels[k], state);
+                queue[tail++] = node->children[labels[k]];
+                queue[tail++] = base + labels[k];
+            }
+        }
+        b.base[state] = base | (node->isEndOfWord ? TRIE_SNAPSHOT_END : 0);
+        num_words += node->isEndOfWord;
+    }
+    free(queue);
+
+    // Imagem final: cabeçalho seguido das células usadas, igual ao arquivo
+    size_t length = sizeof(TrieSnapshotHeader) + (size_t)b.used * sizeof(TrieSnapshotCell);
+    char *image = malloc(length);
+    if (!image) {
+        trie_snapshot_builder_free(&b);
+        return -1;
+    }
+    TrieSnapshotHeader *header = (TrieSnapshotHeader *)image;
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, TRIE_SNAPSHOT_MAGIC, sizeof(TRIE_SNAPSHOT_MAGIC));
+    header->version = TRIE_SNAPSHOT_VERSION;
+    header->byte_order = TRIE_SNAPSHOT_BYTE_ORDER;
+    header->num_cells = b.used;
+    header->num_states = num_nodes;
+    header->num_words = num_words;
+    TrieSnapshotCell *cells = (TrieSnapshotCell *)(image + sizeof(TrieSnapshotHeader));
+    for (uint32_t i = 0; i < b.used; i++) {
+        cells[i].base = b.base[i];
+        cells[i].check = b.check[i];
+    }
+    trie_snapshot_builder_free(&b);
+
+    snap->header = header;
+    snap->cells = cells;
+    snap->length = length;
+    snap->mapped = 0;
+    return 0;
+}
+
+// Grava o retrato de forma atômica (arquivo temporário + fsync + rename).
+// Retorna 0 ou -1 (errno definido).
+static inline int trie_snapshot_save(const TrieSnapshot *snap, const char *path) {
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        return -1;
+    }
+    if (fwrite(snap->header, 1, snap->length, f) != snap->length || fflush(f) != 0 || fsync(fileno(f)) != 0) {
+        fclose(f);
+        unlink(tmp_path);
+        return -1;
+    }
+    if (fclose(f) != 0 || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Mapeia o retrato somente para leitura e confere o cabeçalho; não aloca nada.
+// Retorna 0 ou -1 (errno definido; EINVAL para arquivo que não é um retrato válido).
+static inline int trie_snapshot_open(TrieSnapshot *snap, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(TrieSnapshotHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void *image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        return -1;
+    }
+
+    const TrieSnapshotHeader *header = image;
+    if (memcmp(header->magic, TRIE_SNAPSHOT_MAGIC, sizeof(TRIE_SNAPSHOT_MAGIC)) != 0
+        || header->version != TRIE_SNAPSHOT_VERSION || header->byte_order != TRIE_SNAPSHOT_BYTE_ORDER
+        || header->num_cells <= TRIE_SNAPSHOT_ROOT
+        || (size_t)st.st_size != sizeof(TrieSnapshotHeader) + (size_t)header->num_cells * sizeof(TrieSnapshotCell)) {
+        munmap(image, (size_t)st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    snap->header = header;
+    snap->cells = (const TrieSnapshotCell *)((const char *)image + sizeof(TrieSnapshotHeader));
+    snap->length = (size_t)st.st_size;
+    snap->mapped = 1;
+    return 0;
+}
+
+// Retorna true se key for uma palavra completa do retrato
+static inline bool trie_snapshot_search(const TrieSnapshot *snap, const char *key) {
+    const TrieSnapshotCell *cells = snap->cells;
+    uint32_t num_cells = snap->header->num_cells;
+    uint32_t state = TRIE_SNAPSHOT_ROOT;
+
+    for (const char *p = key; *p; p++) {
+        int index = *p - 'a';
+        if (index < 0 || index >= ALPHABET_SIZE) {
+            return false;
+        }
+        uint32_t next = (cells[state].base & ~TRIE_SNAPSHOT_END) + (uint32_t)index;
+        if (next >= num_cells || cells[next].check != state) {
+            return false;
+        }
+        state = next;
+    }
+    return (cells[state].base & TRIE_SNAPSHOT_END) != 0;
+}
+
+static inline void trie_snapshot_close(TrieSnapshot *snap) {
+    if (snap->mapped) {
+        munmap((void *)snap->header, snap->length);
+    } else {
+        free((void *)snap->header);
+    }
+    snap->header = NULL;
+    snap->cells = NULL;
+    snap->length = 0;
+}
+
+#endif // TRIE_SNAPSHOT_H